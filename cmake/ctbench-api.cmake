@@ -39,6 +39,34 @@ function(_ctbench_internal_add_compile_benchmark target_name output source
   endif()
 endfunction(_ctbench_internal_add_compile_benchmark)
 
+## =============================================================================
+#@
+#@ ### _ctbench_internal_add_benchmark_index
+#@
+#@ Writes the index of a benchmark once its target is built. The index lists
+#@ every repetition file so the grapher doesn't have to scan the benchmark
+#@ directory.
+#@
+#@ - `name`: Name of the benchmark target
+#@ - `entries`: List of index entries, as JSON objects with the size and path
+#@   of a repetition file relative to the benchmark directory
+
+function(_ctbench_internal_add_benchmark_index name entries)
+  list(JOIN entries ",\n    " entries_json)
+  set(index_path "${CMAKE_CURRENT_BINARY_DIR}/ctbench-index/${name}.json")
+  file(WRITE "${index_path}"
+       "{\n  \"repetitions\": [\n    ${entries_json}\n  ]\n}\n")
+
+  # The index is only copied next to the results once they're all generated
+  add_custom_command(
+    TARGET ${name}
+    POST_BUILD
+    COMMAND ${CMAKE_COMMAND} -E copy_if_different "${index_path}"
+            "${name}/ctbench-index.json"
+    WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+    VERBATIM)
+endfunction(_ctbench_internal_add_benchmark_index)
+
 ## =============================================================================
 #@
 #@ ## Public API
@@ -96,6 +124,7 @@ function(
   step
   samples)
   add_custom_target(${name})
+  set(index_entries)
   # Setting names
   foreach(size RANGE ${begin} ${end} ${step})
     foreach(iteration RANGE 1 ${samples})
@@ -107,8 +136,11 @@ function(
         "-DBENCHMARK_SIZE=${size}")
 
       add_dependencies(${name} ${subtarget_name})
+      list(APPEND index_entries
+           "{\"size\": ${size}, \"path\": \"${size}/${iteration}.json\"}")
     endforeach()
   endforeach()
+  _ctbench_internal_add_benchmark_index(${name} "${index_entries}")
 endfunction(ctbench_add_benchmark)
 
 #!
@@ -186,6 +218,7 @@ function(
   samples)
   # Setting names
   add_custom_target(${name})
+  set(index_entries)
 
   foreach(iteration RANGE 1 ${samples})
     foreach(size ${size_list})
@@ -197,8 +230,11 @@ function(
         "-DBENCHMARK_SIZE=${size}")
 
       add_dependencies(${name} ${subtarget_name})
+      list(APPEND index_entries
+           "{\"size\": ${size}, \"path\": \"${size}/${iteration}.json\"}")
     endforeach()
   endforeach()
+  _ctbench_internal_add_benchmark_index(${name} "${index_entries}")
 endfunction(ctbench_add_benchmark_for_size_list)
 
 #!
@@ -229,6 +265,7 @@ function(
   generator)
   # Setting names
   add_custom_target(${name})
+  set(index_entries)
   foreach(iteration RANGE 1 ${samples})
     foreach(size RANGE ${begin} ${end} ${step})
       # Subtargets aren't meant to be compiled by end-users
@@ -241,8 +278,11 @@ function(
         "${ctbench_options_output}")
 
       add_dependencies(${name} ${subtarget_name})
+      list(APPEND index_entries
+           "{\"size\": ${size}, \"path\": \"${size}/${iteration}.json\"}")
     endforeach()
   endforeach()
+  _ctbench_internal_add_benchmark_index(${name} "${index_entries}")
 endfunction(ctbench_add_custom_benchmark)
 
 #!
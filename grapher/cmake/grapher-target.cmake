@@ -18,6 +18,7 @@ target_link_libraries(grapher
     nlohmann_json::nlohmann_json
     sciplot::sciplot
     stdc++fs
+    Threads::Threads
 )
 
 target_compile_options(grapher PUBLIC -DJSON_NOEXCEPTION)
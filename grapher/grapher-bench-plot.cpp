@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <fmt/core.h>
+
+#include <grapher/utils/json.hpp>
+#include <grapher/utils/plot.hpp>
+#include <grapher/utils/render.hpp>
+
+namespace cli {
+
+namespace lc = llvm::cl;
+
+lc::opt<unsigned> repeat_opt("repeat", lc::init(3),
+                             lc::desc("<number of runs per plot backend>"));
+
+lc::opt<unsigned> plot_count_opt("plots", lc::init(64),
+                                 lc::desc("<number of plots per run>"));
+
+lc::opt<unsigned> curve_count_opt("curves", lc::init(8),
+                                  lc::desc("<number of curves per plot>"));
+
+lc::opt<unsigned> point_count_opt("points", lc::init(32),
+                                  lc::desc("<number of points per curve>"));
+
+lc::list<std::string>
+    backend_list("backends", lc::CommaSeparated,
+                 lc::desc("<plot backends to compare, the first one being "
+                          "the reference (default: "
+                          "native,gnuplot_session,sciplot)>"));
+
+lc::opt<std::string>
+    output_opt("output", lc::init("ctbench-grapher-bench-plot"),
+               lc::desc("<temporary output directory, removed on exit>"));
+
+} // namespace cli
+
+namespace {
+
+/// Returns plots shaped like compare_by plots, with curves and error bars of
+/// deterministic values.
+std::vector<grapher::plot_t> get_plots() {
+  std::vector<grapher::plot_t> res(cli::plot_count_opt.getValue());
+  for (std::size_t plot_id = 0; plot_id < res.size(); plot_id++) {
+    grapher::plot_t &plot = res[plot_id];
+    plot.x_label = "Benchmark size factor";
+    plot.y_label = "Time (µs)";
+    plot.legend_title = "Timings";
+
+    for (unsigned curve_id = 0; curve_id < cli::curve_count_opt.getValue();
+         curve_id++) {
+      std::vector<double> x;
+      std::vector<double> y;
+      std::vector<double> y_delta;
+      for (unsigned point_id = 0; point_id < cli::point_count_opt.getValue();
+           point_id++) {
+        double const phase = double(plot_id + curve_id + point_id);
+        x.push_back(double(point_id + 1));
+        y.push_back(double((curve_id + 1) * (point_id + 1)) * 100. +
+                    std::sin(phase) * 50.);
+        y_delta.push_back(10. + std::cos(phase) * 5.);
+      }
+      plot.draw_curve_with_error_bars_y(std::move(x), std::move(y),
+                                        std::move(y_delta),
+                                        fmt::format("curve-{}", curve_id));
+    }
+  }
+  return res;
+}
+
+/// Saves the plots with the given backend and returns the best time.
+double bench_backend(std::string const &backend,
+                     std::vector<grapher::plot_t> const &plots,
+                     std::filesystem::path const &dest) {
+  namespace chr = std::chrono;
+
+  grapher::json_t config = grapher::base_default_config();
+  config["plot_backend"] = backend;
+
+  chr::duration<double> best_time = chr::duration<double>::max();
+  for (unsigned i = 0; i < cli::repeat_opt.getValue(); i++) {
+    auto const start = chr::steady_clock::now();
+
+    grapher::render_parallel(plots.size(), [&](std::size_t plot_id) {
+      grapher::save_plot(plots[plot_id],
+                         (dest / backend / std::to_string(plot_id)).string(),
+                         config);
+    });
+
+    best_time = std::min<chr::duration<double>>(
+        best_time, chr::steady_clock::now() - start);
+  }
+  return best_time.count();
+}
+
+} // namespace
+
+int main(int argc, char const *argv[]) {
+  llvm::cl::extrahelp(
+      "\nMeasure the time taken by each plot backend to save the same plots "
+      "as .svg and .png files.\n");
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  std::vector<std::string> backends(cli::backend_list.begin(),
+                                    cli::backend_list.end());
+  if (backends.empty()) {
+    backends = {"native", "gnuplot_session", "sciplot"};
+  }
+
+  std::filesystem::path const dest = cli::output_opt.getValue();
+  std::vector<grapher::plot_t> const plots = get_plots();
+
+  double reference_time = 0;
+  for (std::string const &backend : backends) {
+    double const time = bench_backend(backend, plots, dest);
+    if (reference_time == 0) {
+      reference_time = time;
+    }
+    llvm::outs() << fmt::format("{:<16} {:>6} plots {:>10.3f} s {:>10.2f} "
+                                "plots/s {:>8.2f}x\n",
+                                backend, plots.size(), time,
+                                double(plots.size()) / time,
+                                time / reference_time);
+  }
+
+  std::filesystem::remove_all(dest);
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <fmt/core.h>
+
+#include <grapher/trace_reader.hpp>
+
+namespace cli {
+
+namespace lc = llvm::cl;
+
+lc::opt<unsigned> repeat_opt("repeat", lc::init(3),
+                             lc::desc("<number of reads per input method>"));
+
+lc::list<std::string> trace_path_list(lc::Positional, lc::OneOrMore,
+                                      lc::desc("<time-trace files>"));
+
+} // namespace cli
+
+namespace {
+
+/// Reads all the trace files with the given input method and prints the
+/// measured throughput.
+void bench_input(std::string_view input_name, grapher::trace_input_t input,
+                 std::vector<std::filesystem::path> const &paths,
+                 std::uintmax_t total_size) {
+  namespace chr = std::chrono;
+
+  std::size_t event_count = 0;
+  chr::duration<double> best_time = chr::duration<double>::max();
+
+  for (unsigned i = 0; i < cli::repeat_opt.getValue(); i++) {
+    auto const start = chr::steady_clock::now();
+
+    event_count = 0;
+    for (std::filesystem::path const &path : paths) {
+      event_count += grapher::read_trace_events(path, {}, input).size();
+    }
+
+    best_time = std::min<chr::duration<double>>(
+        best_time, chr::steady_clock::now() - start);
+  }
+
+  double const megabytes = static_cast<double>(total_size) / (1024. * 1024.);
+  llvm::outs() << fmt::format("{:<10} {:>10.2f} MB {:>10} events {:>10.3f} s "
+                              "{:>10.2f} MB/s\n",
+                              input_name, megabytes, event_count,
+                              best_time.count(),
+                              megabytes / best_time.count());
+}
+
+} // namespace
+
+int main(int argc, char const *argv[]) {
+  llvm::cl::extrahelp(
+      "\nMeasure time-trace file reading throughput for each input method.\n");
+  llvm::cl::ParseCommandLineOptions(argc, argv);
+
+  std::vector<std::filesystem::path> paths;
+  std::uintmax_t total_size = 0;
+  for (std::string const &path : cli::trace_path_list) {
+    paths.emplace_back(path);
+    total_size += std::filesystem::file_size(path);
+  }
+
+  bench_input("ifstream", grapher::buffered_input_v, paths, total_size);
+  bench_input("mmap", grapher::mapped_input_v, paths, total_size);
+
+  return 0;
+}
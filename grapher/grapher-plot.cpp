@@ -1,15 +1,22 @@
+#include <filesystem>
 #include <fstream>
 #include <string>
 
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <fmt/core.h>
+
 #include <nlohmann/json.hpp>
 
 #include <grapher/core.hpp>
+#include <grapher/manifest.hpp>
 #include <grapher/plotters/plotters.hpp>
 #include <grapher/utils/cli.hpp>
+#include <grapher/utils/error.hpp>
 #include <grapher/utils/json.hpp>
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/render.hpp>
 
 namespace cli {
 namespace lc = llvm::cl;
@@ -20,6 +27,29 @@ lc::opt<std::string> config_opt("config", lc::Required,
 lc::opt<std::string> output_folder_opt("output", lc::Required,
                                        lc::desc("<output folder>"));
 
+lc::opt<unsigned>
+    jobs_opt("jobs", lc::init(0),
+             lc::desc("<number of threads for trace ingestion, defaults to "
+                      "the number of hardware threads>"));
+
+lc::opt<unsigned> render_jobs_opt(
+    "render-jobs", lc::init(0),
+    lc::desc("<number of plots rendered concurrently, ie. maximum number of "
+             "gnuplot processes, defaults to the number of hardware "
+             "threads>"));
+
+lc::opt<bool> trace_cache_opt(
+    "trace-cache", lc::init(false),
+    lc::desc("<read and write binary trace cache files (.ctbc) next to "
+             "time-trace files. Files without a cache file are parsed whole "
+             "to write it, which only pays off when they are read again>"));
+
+lc::opt<bool> incremental_opt(
+    "incremental", lc::init(false),
+    lc::desc("<only re-read changed repetition files and redraw the affected "
+             "plots, using a manifest stored in the output folder. The "
+             "manifest holds the values read from every repetition>"));
+
 lc::list<std::string> benchmark_path_list(lc::Positional, lc::OneOrMore,
                                           lc::desc("<input folders>"));
 } // namespace cli
@@ -27,6 +57,9 @@ lc::list<std::string> benchmark_path_list(lc::Positional, lc::OneOrMore,
 int main(int argc, char const *argv[]) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
 
+  grapher::set_job_count(cli::jobs_opt.getValue());
+  grapher::set_render_job_count(cli::render_jobs_opt.getValue());
+
   // Get configed
   grapher::json_t config;
   {
@@ -50,9 +83,10 @@ int main(int argc, char const *argv[]) {
           grapher::get_as_ref<grapher::json_t::string_t const &>(config,
                                                                  "plotter")));
 
-  // Build cats
-  grapher::benchmark_set_t bset =
-      grapher::build_category(cli::benchmark_path_list);
+  // Build cats, trace files will only be read for the data used by the plotter
+  grapher::benchmark_set_t bset = grapher::build_category(
+      cli::benchmark_path_list, plotter->get_trace_projection(config),
+      cli::trace_cache_opt.getValue());
 
   // Set destiny
   std::string dest = cli::output_folder_opt.getValue();
@@ -60,7 +94,25 @@ int main(int argc, char const *argv[]) {
   // ???
 
   // Plotten
-  plotter->plot(bset, dest, config);
+  if (!cli::incremental_opt.getValue()) {
+    plotter->plot(bset, dest, config);
+    return 0;
+  }
+
+  // Incremental run, reusing what was recorded by the previous one
+  std::filesystem::path const manifest_path = grapher::get_manifest_path(dest);
+  grapher::results_manifest_t manifest =
+      grapher::results_manifest_t::load(manifest_path, config);
+
+  plotter->plot_incremental(bset, dest, config, manifest);
+
+  if (!manifest.empty()) {
+    std::filesystem::create_directories(dest);
+    grapher::check(manifest.save(manifest_path),
+                   fmt::format("Could not write results manifest {}.",
+                               manifest_path.string()),
+                   grapher::info_v);
+  }
 
   return 0;
 }
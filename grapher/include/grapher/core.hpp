@@ -3,8 +3,14 @@
 /// \file
 /// Data types for benchmark results representation.
 
+#include <array>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -37,6 +43,171 @@ using value_t = unsigned long;
 // - std::map -> 87.08 secs
 // - boost::container::map -> 80.16 secs
 
+/// Interned string identifier (see utils/intern.hpp).
+using symbol_t = std::uint32_t;
+
+/// Symbol value reserved for absent strings.
+inline constexpr symbol_t no_symbol_v = 0;
+
+// Columnar time-trace event representation
+
+/// Value kinds of event fields.
+enum event_value_kind_t : std::uint8_t {
+  absent_kind_v,
+  null_kind_v,
+  boolean_kind_v,
+  unsigned_kind_v,
+  integer_kind_v,
+  float_kind_v,
+  string_kind_v,
+};
+
+/// Scalar event field value. Numbers are stored by their bit pattern and
+/// strings by their symbol.
+struct event_value_t {
+  event_value_kind_t kind = absent_kind_v;
+  std::uint64_t bits = 0;
+
+  bool is_present() const { return kind != absent_kind_v; }
+  bool is_string() const { return kind == string_kind_v; }
+  bool is_number() const {
+    return kind == unsigned_kind_v || kind == integer_kind_v ||
+           kind == float_kind_v;
+  }
+
+  /// Returns the symbol of a string value.
+  symbol_t get_symbol() const { return static_cast<symbol_t>(bits); }
+
+  /// Converts a number value to value_t.
+  value_t get_value() const;
+
+  /// Converts the value to JSON. Absent values are converted to null.
+  json_t to_json() const;
+
+  /// Converts a scalar JSON value. Strings are interned.
+  static event_value_t from_json(json_t const &value);
+
+  bool operator==(event_value_t const &) const = default;
+};
+
+/// Columns of an event table.
+enum event_column_t : std::uint8_t {
+  name_column_v,
+  detail_column_v,
+  ts_column_v,
+  dur_column_v,
+  pid_column_v,
+  tid_column_v,
+  args_column_v,
+};
+
+/// JSON pointers of the fields stored in dedicated columns, in column order.
+inline constexpr std::array<std::string_view, args_column_v>
+    event_column_pointers = {"/name", "/args/detail", "/ts",
+                             "/dur",  "/pid",         "/tid"};
+
+/// Appends an object key to a JSON pointer string, escaped as a reference
+/// token.
+void append_reference_token(std::string &pointer, std::string_view key);
+
+/// Event field location in an event table, resolved once from a JSON pointer.
+/// Only scalar fields are addressable: pointers to objects or arrays never
+/// match a field.
+struct event_field_t {
+  /// Column holding the field when its value has the column type
+  event_column_t column = args_column_v;
+
+  /// Interned JSON pointer, used as the key in the args table
+  symbol_t key = no_symbol_v;
+
+  /// Resolves a JSON pointer.
+  static event_field_t resolve(json_t::json_pointer const &pointer);
+
+  /// Resolves a JSON pointer string.
+  static event_field_t resolve(std::string_view pointer);
+
+  bool operator==(event_field_t const &) const = default;
+};
+
+/// Event field stored in the args table of an event table.
+struct event_arg_t {
+  symbol_t key;
+  event_value_t value;
+
+  bool operator==(event_arg_t const &) const = default;
+};
+
+/// Columnar storage of time-trace events (struct of arrays).
+///
+/// Event names and details (`/name` and `/args/detail`) are stored as symbols,
+/// and `ts`, `dur`, `pid` and `tid` as unsigned values in contiguous columns.
+/// Fields that are not covered by a column, or whose type doesn't match the
+/// column type, are stored in a sparse args table indexed by row.
+class event_table_t {
+public:
+  /// Number of events.
+  std::size_t size() const { return names_.size(); }
+  bool empty() const { return names_.empty(); }
+
+  /// Returns the value of an event field.
+  event_value_t get(std::size_t row, event_field_t const &field) const;
+
+  /// Returns the fields of an event that are stored in the args table.
+  std::span<event_arg_t const> get_args(std::size_t row) const {
+    return {args_.data() + arg_offsets_[row],
+            args_.data() + arg_offsets_[row + 1]};
+  }
+
+  /// Direct column access.
+  std::span<symbol_t const> names() const { return names_; }
+  std::span<symbol_t const> details() const { return details_; }
+  std::span<value_t const> column(event_column_t numeric_column) const;
+
+  /// Presence bits of the numeric columns, by row. A field is stored in its
+  /// column if the column bit is set, and in the args table otherwise.
+  std::span<std::uint8_t const> column_masks() const { return column_masks_; }
+
+  /// Presence bit of a numeric column.
+  static std::uint8_t get_column_bit(event_column_t column) {
+    return static_cast<std::uint8_t>(1u << column);
+  }
+
+  /// Appends an event without any field.
+  void push_row();
+
+  /// Sets a field of the last event.
+  void set(event_field_t const &field, event_value_t const &value);
+
+  /// Removes the last event.
+  void pop_row();
+
+  /// Appends a time-trace event. Nested fields are flattened.
+  void push_event(json_t const &event);
+
+  /// Appends an event from another table.
+  void push_event(event_table_t const &table, std::size_t row);
+
+  /// Materializes an event as JSON.
+  json_t get_event(std::size_t row) const;
+
+  bool operator==(event_table_t const &) const = default;
+
+private:
+  std::vector<symbol_t> names_;
+  std::vector<symbol_t> details_;
+  std::vector<value_t> ts_;
+  std::vector<value_t> dur_;
+  std::vector<value_t> pid_;
+  std::vector<value_t> tid_;
+  std::vector<std::uint8_t> column_masks_;
+
+  std::vector<std::size_t> arg_offsets_ = {0};
+  std::vector<event_arg_t> args_;
+};
+
+/// Parsed time-trace events of a benchmark instance (see event_store.hpp).
+class event_store_t;
+
 /// Results for a benchmark case instantiated at a given size.
 struct benchmark_instance_t {
   /// Size at which the benchmark is instantiated at
@@ -44,6 +215,9 @@ struct benchmark_instance_t {
 
   /// Data for each repetition of the benchmark iteration
   std::vector<std::filesystem::path> repetitions;
+
+  /// Parsed events of the repetitions, shared by all plotters
+  std::shared_ptr<event_store_t const> events;
 };
 
 /// Represents results for a benchmark case as a series of benchmark instances.
@@ -0,0 +1,54 @@
+#pragma once
+
+/// \file
+/// In-memory storage of parsed time-trace events.
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <grapher/core.hpp>
+#include <grapher/trace_reader.hpp>
+
+namespace grapher {
+
+/// Immutable store of parsed time-trace events for the repetitions of a
+/// benchmark instance.
+///
+/// Each repetition file is parsed at most once, the first time its events are
+/// requested. The parsed events are then kept in memory and shared by all the
+/// plotters and group descriptors that read them.
+///
+/// Only the fields and events selected by the projection are stored. When
+/// trace caching is enabled, repetitions are read from their binary cache file
+/// if it is valid, and the cache file is written otherwise.
+class event_store_t {
+public:
+  explicit event_store_t(
+      std::vector<std::filesystem::path> repetition_paths,
+      std::shared_ptr<trace_projection_t const> projection =
+          std::make_shared<trace_projection_t const>(),
+      bool use_trace_cache = false);
+
+  /// Number of repetitions in the store.
+  std::size_t size() const { return repetition_count_; }
+
+  /// Returns the events of a repetition, parsing its file on first access.
+  /// Safe to call concurrently.
+  event_table_t const &get(std::size_t repetition_id) const;
+
+private:
+  struct entry_t {
+    std::filesystem::path path;
+    std::once_flag parsed;
+    event_table_t events;
+  };
+
+  std::size_t repetition_count_;
+  std::unique_ptr<entry_t[]> entries_;
+  std::shared_ptr<trace_projection_t const> projection_;
+  bool use_trace_cache_;
+};
+
+} // namespace grapher
@@ -0,0 +1,93 @@
+#pragma once
+
+/// \file
+/// Results manifest for incremental grapher runs.
+///
+/// A results manifest records every repetition file consumed by a grapher run,
+/// with its size, modification time and content hash, along with the partial
+/// aggregate the plotter derived from it. On the next run with the same config,
+/// plotters reuse the partial aggregates of unchanged repetitions instead of
+/// reading them again, and only redraw the plots affected by new, changed or
+/// removed repetitions. The outputs written by the run are recorded as well,
+/// so outputs that are not written anymore can be removed.
+///
+/// Partial aggregates may hold every measured value, so manifests grow with
+/// the data. Incremental runs are therefore opt-in.
+///
+/// Manifests are stored in the output folder as CBOR files. A manifest written
+/// for another config or another format version is discarded.
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <grapher/core.hpp>
+#include <grapher/utils/fingerprint.hpp>
+
+namespace grapher {
+
+/// File name of results manifests in output folders.
+inline constexpr std::string_view manifest_filename = ".ctbench-manifest.cbor";
+
+/// Returns the path of the results manifest of an output folder.
+std::filesystem::path get_manifest_path(std::filesystem::path const &dest);
+
+/// Fingerprint and partial aggregate of a repetition file.
+struct manifest_entry_t {
+  file_stamp_t stamp;
+  std::uint64_t hash;
+
+  /// Plotter-specific partial aggregate derived from the repetition
+  grapher::json_t aggregate;
+
+  /// Returns true if the file at path still has the recorded content. Hashing
+  /// is skipped if the stamp didn't change.
+  bool matches(std::filesystem::path const &path,
+               file_stamp_t const &current_stamp) const;
+};
+
+/// Repetition files consumed by a grapher run and their partial aggregates.
+class results_manifest_t {
+public:
+  /// Creates an empty manifest for the given plotter config.
+  explicit results_manifest_t(grapher::json_t config = {})
+      : config_(std::move(config)) {}
+
+  /// Loads the manifest at path. Returns an empty manifest if the file doesn't
+  /// exist, is invalid, or was written for another config.
+  static results_manifest_t load(std::filesystem::path const &path,
+                                 grapher::json_t const &config);
+
+  /// Writes the manifest at path. Returns false if it could not be written.
+  bool save(std::filesystem::path const &path) const;
+
+  /// Number of recorded repetition files.
+  std::size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  /// Returns the entry of a repetition file, or nullptr if there is none.
+  /// Safe to call concurrently.
+  manifest_entry_t const *find(std::filesystem::path const &path) const;
+
+  /// Records the entry of a repetition file.
+  void set(std::filesystem::path const &path, manifest_entry_t entry);
+
+  /// Removes the entries of the files that are not in paths, and returns them.
+  std::vector<manifest_entry_t>
+  prune(std::unordered_set<std::string> const &paths);
+
+  /// Plotter-specific record of the outputs written by the run.
+  grapher::json_t const &get_outputs() const { return outputs_; }
+  void set_outputs(grapher::json_t outputs) { outputs_ = std::move(outputs); }
+
+private:
+  grapher::json_t config_;
+  grapher::json_t outputs_ = grapher::json_t::object();
+  std::unordered_map<std::string, manifest_entry_t> entries_;
+};
+
+} // namespace grapher
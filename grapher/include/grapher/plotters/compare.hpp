@@ -35,6 +35,7 @@ namespace grapher::plotters {
 ///   ],
 ///   "height": 500,
 ///   "legend_title": "Timings",
+///   "plot_backend": "sciplot",
 ///   "plot_file_extensions": [
 ///     ".svg",
 ///     ".png"
@@ -52,6 +53,9 @@ struct plotter_compare_t : plotter_base_t {
             grapher::json_t const &config) const override;
 
   grapher::json_t get_default_config() const override;
+
+  trace_projection_t
+  get_trace_projection(grapher::json_t const &config) const override;
 };
 
 } // namespace grapher::plotters
@@ -11,10 +11,27 @@ namespace grapher::plotters {
 /// - `key_ptrs` (string array): pointers to JSON values to use as a key
 /// - `value_ptr` (`string`): pointer to the JSON value to measure
 /// - `draw_average` (`bool`): enable average curve drawing
-/// - `draw_points` (`bool`): enable value point drawing
+/// - `draw_points` (`bool`): enable value point drawing. Values are only kept
+///   in memory when points are drawn. Otherwise, points only hold online
+///   statistics and the median is estimated.
 /// - `demangle` (`bool`): demangle C++ symbol names
 /// - `filters` (`array`, optional): array of predicates to filter observed
 ///   events. Useful for large datasets.
+/// - `top_k` (`unsigned`, optional): only plot the keys with the highest
+///   totals of measured values. No limit if 0.
+/// - `min_total_dur` (`number`, optional): only plot the keys whose measured
+///   values add up to at least this total.
+///
+/// When only `min_total_dur` is set, keys are selected with their exact totals.
+/// When `top_k` is set, heavy keys are found with a streaming heavy-hitter
+/// sketch that monitors 16 keys per kept key, so the selection is approximate:
+/// with many keys of similar totals, some keys heavier than the kept ones may
+/// be missed, and kept keys may miss some values (a warning is printed then).
+///
+/// Incremental runs are supported: the values of each repetition are recorded
+/// by key in the results manifest, and only the plots of the keys found in
+/// new, changed or removed repetitions are generated again. Plots of keys that
+/// are not found anymore are removed.
 ///
 /// \copydoc base_default_config
 ///
@@ -37,11 +54,14 @@ namespace grapher::plotters {
 ///     "/args/detail"
 ///   ],
 ///   "legend_title": "Timings",
+///   "plot_backend": "sciplot",
 ///   "plot_file_extensions": [
 ///     ".svg",
 ///     ".png"
 ///   ],
+///   "min_total_dur": 0,
 ///   "plotter": "compare_by",
+///   "top_k": 0,
 ///   "value_ptr": "/dur",
 ///   "width": 1500,
 ///   "x_label": "Benchmark size factor",
@@ -53,7 +73,15 @@ struct plotter_compare_by_t : plotter_base_t {
   void plot(benchmark_set_t const &bset, std::filesystem::path const &dest,
             grapher::json_t const &config) const override;
 
+  void plot_incremental(benchmark_set_t const &bset,
+                        std::filesystem::path const &dest,
+                        grapher::json_t const &config,
+                        results_manifest_t &manifest) const override;
+
   grapher::json_t get_default_config() const override;
+
+  trace_projection_t
+  get_trace_projection(grapher::json_t const &config) const override;
 };
 
 } // namespace grapher::plotters
@@ -0,0 +1,105 @@
+#pragma once
+
+/// \file
+/// Per-key curve aggregation of the compare_by plotter, shared with the
+/// plotters that present the same curves in other forms.
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+#include "grapher/core.hpp"
+#include "grapher/manifest.hpp"
+#include "grapher/predicates.hpp"
+#include "grapher/utils/demangle.hpp"
+#include "grapher/utils/math.hpp"
+
+namespace grapher::plotters {
+
+/// Value key type. Contains multiple values to group by a tuple of parameters,
+/// as interned strings
+using key_t = boost::container::small_vector<grapher::symbol_t, 4>;
+
+/// Y coordinates of a single repetition
+using point_data_t = std::vector<grapher::value_t>;
+
+/// Point aggregate (statistics on multiple Y coordinates)
+using point_aggregate_t = math::accumulator_t;
+
+/// Curve: X -> Y statistics
+using benchmark_curve_t = grapher::map_t<std::size_t, point_aggregate_t>;
+
+/// Benchmark name -> Curve
+using curve_aggregate_t = grapher::map_t<std::string, benchmark_curve_t>;
+
+/// Feature -> Benchmark aggregate
+using curve_aggregate_map_t = grapher::map_t<key_t, curve_aggregate_t>;
+
+/// Set of features
+using key_set_t = std::set<key_t>;
+
+/// Orders keys by their strings, missing parts first. Unlike the order of
+/// symbols, this order is the same from one run to another.
+struct key_string_less_t {
+  bool operator()(key_t const &a, key_t const &b) const;
+};
+
+/// Heavy-hitter key selection parameters. Keys are only pruned if either of
+/// them is set.
+struct key_pruning_parameters_t {
+  /// Maximum number of kept keys, no limit if 0
+  std::size_t top_k = 0;
+
+  /// Minimum total of the values of a kept key
+  double min_total = 0;
+
+  bool is_enabled() const { return top_k != 0 || min_total > 0; }
+};
+
+/// Scans event data at value_pointer and generates curves for each key
+/// generated from key_pointers. The curves are stored in a nested map
+/// structure which is far from optimal but we're limited by gnuplot's
+/// performance anyway.
+///
+/// Values are only kept if keep_samples is true, otherwise points only hold
+/// their statistics.
+///
+/// If a manifest is given, the aggregates of unchanged repetitions are read
+/// from it instead of their events, and the manifest is updated. The keys of
+/// new, changed and removed repetitions are then inserted in affected_keys.
+///
+/// If key pruning is enabled, keys are selected by their totals once they are
+/// aggregated. With top_k, the totals of every key are fed to a heavy-hitter
+/// sketch in the same pass, only the keys it monitors are aggregated, and the
+/// aggregates of the keys it evicts are dropped. The selection is then
+/// approximate, and a warning is printed for kept keys that were evicted at
+/// some point since they miss some values.
+curve_aggregate_map_t
+get_bench_curves(benchmark_set_t const &input,
+                 std::vector<json_t::json_pointer> const &key_pointers,
+                 json_t::json_pointer const &value_pointer,
+                 std::vector<predicate_t> filters = {},
+                 bool keep_samples = true,
+                 results_manifest_t *manifest = nullptr,
+                 key_set_t *affected_keys = nullptr,
+                 key_pruning_parameters_t const &pruning = {});
+
+/// Transforms a key into a string that's usable as a path. Key parts are
+/// demangled if a demangle cache is given.
+std::string to_string(key_t const &key,
+                      demangle_cache_t const *demangle_cache = nullptr);
+
+/// Reads key JSON pointers from the config
+std::vector<json_t::json_pointer>
+get_key_pointers(grapher::json_t const &config);
+
+/// Reads event filters from the config
+grapher::json_t::array_t get_filters(grapher::json_t const &config);
+
+/// Reads heavy-hitter key selection parameters from the config
+key_pruning_parameters_t
+get_key_pruning_parameters(grapher::json_t const &config);
+
+} // namespace grapher::plotters
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "grapher/plotters/plotter_base.hpp"
+
+namespace grapher::plotters {
+
+/// Exports measured values as tables for external analysis tools, instead of
+/// drawing graphs. Rows are streamed to the output files as they are computed,
+/// so only the rows of a batch of repetitions are held in memory. Parsed
+/// events are kept in the event store of each benchmark instance like for
+/// other plotters.
+///
+/// Each row holds the benchmark name, the benchmark size, the repetition
+/// index, and:
+/// - if `group_descriptors` is set, the descriptor name and the sum of the
+///   values of the events it matches in the repetition, as in the `stack` and
+///   `compare` plotters,
+/// - otherwise one column per key pointer and the sum of the values of the
+///   events with that key in the repetition, as in the `compare_by` plotter.
+///   Missing key parts are left empty, and rows are sorted by key within each
+///   repetition.
+///
+/// JSON config parameters:
+/// - `file_extensions` (string array): output formats, `.csv` for CSV files
+///   and `.ctcol` for binary columnar files (see grapher/utils/columnar.hpp).
+///   Files are named `values` followed by the extension.
+/// - `value_ptr` (`string`): pointer to the JSON value to measure
+/// - `group_descriptors` (group descriptors, optional): see
+///   group_descriptor_t documentation
+/// - `key_ptrs` (string array): pointers to JSON values to use as a key,
+///   ignored if `group_descriptors` is set
+/// - `filters` (`array`, optional): array of predicates to filter observed
+///   events, ignored if `group_descriptors` is set
+///
+/// Columnar files store benchmark names and keys in a string dictionary, and
+/// sizes, repetitions and values as 64-bit integers.
+///
+/// Example config:
+/// \code{.json}
+/// {
+///   "file_extensions": [
+///     ".csv",
+///     ".ctcol"
+///   ],
+///   "filters": [
+///     {
+///       "pointer": "/name",
+///       "regex": ".*",
+///       "type": "regex"
+///     }
+///   ],
+///   "key_ptrs": [
+///     "/name",
+///     "/args/detail"
+///   ],
+///   "plotter": "export",
+///   "value_ptr": "/dur"
+/// }
+/// \endcode
+
+struct plotter_export_t : plotter_base_t {
+  void plot(benchmark_set_t const &bset, std::filesystem::path const &dest,
+            grapher::json_t const &config) const override;
+
+  grapher::json_t get_default_config() const override;
+
+  trace_projection_t
+  get_trace_projection(grapher::json_t const &config) const override;
+};
+
+} // namespace grapher::plotters
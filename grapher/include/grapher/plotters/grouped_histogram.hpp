@@ -1,14 +1,96 @@
 #pragma once
 
+#include <vector>
+
 #include "grapher/plotters/plotter_base.hpp"
+#include "grapher/utils/json.hpp"
+#include "grapher/utils/plot.hpp"
 
 namespace grapher::plotters {
 
+/// For each benchmark in the category, generates a histogram of the time
+/// spent in each group of events, with a group of bars per benchmark size and
+/// a bar per group descriptor. Bar heights are the sums of the values of the
+/// events matched by the descriptors, averaged over repetitions.
+///
+/// Events are matched against every descriptor in a single pass over each
+/// repetition. Descriptors may overlap, in which case an event counts in
+/// every group that matches it.
+///
+/// Plotter-specific JSON parameters:
+/// - `value_json_pointer` (`string`): pointer to JSON value to measure
+/// - `group_descriptors` (group descriptors): see group_descriptor_t
+/// documentation
+///
+/// \copydetails base_default_config
+///
+/// Example config, grouping function instantiations by namespace:
+/// \code{.json}
+/// {
+///   "group_descriptors": [
+///     {
+///       "name": "std",
+///       "predicates": [
+///         {
+///           "pointer": "/name",
+///           "string": "InstantiateFunction",
+///           "type": "streq"
+///         },
+///         {
+///           "pointer": "/args/detail",
+///           "regex": "std::.*",
+///           "type": "regex"
+///         }
+///       ]
+///     },
+///     {
+///       "name": "boost",
+///       "predicates": [
+///         {
+///           "pointer": "/name",
+///           "string": "InstantiateFunction",
+///           "type": "streq"
+///         },
+///         {
+///           "pointer": "/args/detail",
+///           "regex": "boost::.*",
+///           "type": "regex"
+///         }
+///       ]
+///     }
+///   ],
+///   "height": 500,
+///   "legend_title": "Timings",
+///   "plot_backend": "sciplot",
+///   "plot_file_extensions": [
+///     ".svg",
+///     ".png"
+///   ],
+///   "plotter": "grouped_histogram",
+///   "value_json_pointer": "/dur",
+///   "width": 1500,
+///   "x_label": "Benchmark size factor",
+///   "y_label": "Time (µs)"
+/// }
+/// \endcode
+
+/// Draws the histogram of a benchmark, with a filled series per descriptor
+/// holding its bar for each instance. Bars of an instance are laid out side by
+/// side and centered on its size, over 80% of the smallest distance between
+/// two sizes. The dispatcher must be built from the descriptors.
+plot_t get_grouped_histogram(benchmark_case_t const &bench,
+                             std::vector<group_descriptor_t> const &descriptors,
+                             descriptor_dispatcher_t const &dispatcher,
+                             json_t::json_pointer const &value_pointer);
+
 struct plotter_grouped_histogram_t : public plotter_base_t {
   void plot(benchmark_set_t const &bset, std::filesystem::path const &dest,
             grapher::json_t const &config) const override;
 
   grapher::json_t get_default_config() const override;
+
+  trace_projection_t
+  get_trace_projection(grapher::json_t const &config) const override;
 };
 
 } // namespace grapher::plotters
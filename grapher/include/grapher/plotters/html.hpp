@@ -0,0 +1,95 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "grapher/plotters/curve_aggregate.hpp"
+#include "grapher/plotters/plotter_base.hpp"
+
+namespace grapher::plotters {
+
+/// Generates an HTML report of the curves of the compare_by plotter. Instead of
+/// an image per key, the report is made of an index page listing every key,
+/// and of compressed data files holding the curves of the keys. Curves are
+/// drawn in the browser, and data files are only loaded when a key is opened.
+///
+/// The index page can be sorted by key name, by total of the measured values,
+/// or by growth rate. The growth rate of a key is the largest exponent among
+/// benchmarks of a power law fitted to its average curve, ie. 1 for values
+/// growing linearly with the benchmark size, 2 for quadratic growth.
+///
+/// The report is written in the destination folder:
+/// - `index.html`: the index page, with the key list embedded,
+/// - `data/chunk_<n>.js`: the curves of `keys_per_chunk` keys, stored as
+///   gzip-compressed JSON. Data files are scripts, so the report can be
+///   opened straight from the disk. Data files of a previous report are
+///   removed first.
+///
+/// The report is rendered by browsers that support `DecompressionStream`.
+///
+/// JSON config parameters:
+/// - `key_ptrs` (string array): pointers to JSON values to use as a key
+/// - `value_ptr` (`string`): pointer to the JSON value to measure
+/// - `demangle` (`bool`): demangle C++ symbol names
+/// - `filters` (`array`, optional): array of predicates to filter observed
+///   events. Useful for large datasets.
+/// - `top_k` (`unsigned`, optional): only report the keys with the highest
+///   totals of measured values. No limit if 0.
+/// - `min_total_dur` (`number`, optional): only report the keys whose measured
+///   values add up to at least this total.
+/// - `keys_per_chunk` (`unsigned`): number of keys per data file
+/// - `title` (`string`): report title
+/// - `x_label` (`string`): X axis label
+/// - `y_label` (`string`): Y axis label
+///
+/// Example config:
+/// \code{.json}
+/// {
+///   "demangle": true,
+///   "filters": [
+///     {
+///       "pointer": "/name",
+///       "regex": "*",
+///       "type": "regex"
+///     }
+///   ],
+///   "key_ptrs": [
+///     "/name",
+///     "/args/detail"
+///   ],
+///   "keys_per_chunk": 64,
+///   "min_total_dur": 0,
+///   "plotter": "html",
+///   "title": "ctbench report",
+///   "top_k": 0,
+///   "value_ptr": "/dur",
+///   "x_label": "Benchmark size factor",
+///   "y_label": "Time (µs)"
+/// }
+/// \endcode
+
+struct plotter_html_t : plotter_base_t {
+  void plot(benchmark_set_t const &bset, std::filesystem::path const &dest,
+            grapher::json_t const &config) const override;
+
+  grapher::json_t get_default_config() const override;
+
+  trace_projection_t
+  get_trace_projection(grapher::json_t const &config) const override;
+};
+
+/// Encodes data in base64, with padding.
+std::string to_base64(std::string_view data);
+
+/// Returns the largest exponent among benchmarks of a power law
+/// average = c * size ^ k, fitted by least squares in log-log coordinates.
+/// Returns std::nullopt if no benchmark has two sizes to fit.
+std::optional<double>
+get_growth_rate(curve_aggregate_t const &curve_aggregate);
+
+/// Escapes `</` in script data embedded in a page, so it can't close the
+/// script element it is embedded in.
+std::string escape_script_data(std::string data);
+
+} // namespace grapher::plotters
@@ -5,6 +5,8 @@
 #include <string_view>
 
 #include "grapher/core.hpp"
+#include "grapher/manifest.hpp"
+#include "grapher/trace_reader.hpp"
 
 namespace grapher {
 
@@ -30,8 +32,28 @@ struct plotter_base_t {
                     std::filesystem::path const &dest,
                     grapher::json_t const &config) const = 0;
 
+  /// Plots a given ctbench::category_t incrementally. Plotters that support
+  /// incremental runs reuse the partial aggregates recorded in the manifest for
+  /// unchanged repetitions, only redraw the affected plots, and record the
+  /// repetitions they consumed in the manifest.
+  /// By default, everything is plotted again and the manifest is left as is.
+  virtual void plot_incremental(benchmark_set_t const &bset,
+                                std::filesystem::path const &dest,
+                                grapher::json_t const &config,
+                                results_manifest_t & /* manifest */) const {
+    plot(bset, dest, config);
+  }
+
   /// Returns a default config for end-users.
   virtual grapher::json_t get_default_config() const = 0;
+
+  /// Returns the parts of the trace events read by the plotter for a given
+  /// config. Other fields and events are dropped while parsing trace files.
+  /// By default, events are kept whole.
+  virtual trace_projection_t
+  get_trace_projection(grapher::json_t const & /* config */) const {
+    return {};
+  }
 };
 
 /// Polymorphic representation of a plotter.
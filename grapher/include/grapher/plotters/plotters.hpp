@@ -7,7 +7,9 @@
 #include "grapher/plotters/compare.hpp"
 #include "grapher/plotters/compare_by.hpp"
 #include "grapher/plotters/debug.hpp"
-//#include "grapher/plotters/grouped_histogram.hpp"
+#include "grapher/plotters/export.hpp"
+#include "grapher/plotters/html.hpp"
+#include "grapher/plotters/grouped_histogram.hpp"
 #include "grapher/plotters/stack.hpp"
 
 namespace grapher {
@@ -19,6 +21,12 @@ namespace grapher {
 /// \copydoc grapher::plotters::plotter_compare_by_t
 /// # debug
 /// \copydoc grapher::plotters::plotter_debug_t
+/// # export
+/// \copydoc grapher::plotters::plotter_export_t
+/// # grouped_histogram
+/// \copydoc grapher::plotters::plotter_grouped_histogram_t
+/// # html
+/// \copydoc grapher::plotters::plotter_html_t
 /// # stack
 /// \copydoc grapher::plotters::plotter_stack_t
 
@@ -27,7 +35,9 @@ enum plotter_type_t {
   compare_v,
   compare_by_v,
   debug_v,
-  // grouped_histogram_v,
+  export_v,
+  grouped_histogram_v,
+  html_v,
   stack_v,
 };
 
@@ -36,7 +46,9 @@ inline const std::map<std::string, plotter_type_t> plotter_name_map = {
     {"compare", compare_v},
     {"compare_by", compare_by_v},
     {"debug", debug_v},
-    // {"grouped_histogram", grouped_histogram_v},
+    {"export", export_v},
+    {"grouped_histogram", grouped_histogram_v},
+    {"html", html_v},
     {"stack", stack_v},
 };
 
@@ -48,8 +60,12 @@ inline const llvm::cl::ValuesClass plotter_cl_values{
                               "Stack features for each benchmark."},
     llvm::cl::OptionEnumValue{"debug", debug_v,
                               "Output category stats for debug."},
-    // llvm::cl::OptionEnumValue{"grouped_histogram", grouped_histogram_v,
-    //                           "Stack features for groups of symbols."},
+    llvm::cl::OptionEnumValue{"export", export_v,
+                              "Export values as CSV or columnar files."},
+    llvm::cl::OptionEnumValue{"grouped_histogram", grouped_histogram_v,
+                              "Histogram of features for groups of symbols."},
+    llvm::cl::OptionEnumValue{"html", html_v,
+                              "Generate an HTML report of compare_by curves."},
     llvm::cl::OptionEnumValue{"stack", stack_v,
                               "Stack features for each benchmark."},
 };
@@ -63,8 +79,12 @@ inline plotter_t plotter_type_to_plotter(plotter_type_t type) {
     return std::make_unique<plotters::plotter_compare_by_t>();
   case debug_v:
     return std::make_unique<plotters::plotter_debug_t>();
-  // case grouped_histogram_v:
-  //   return std::make_unique<plotters::plotter_grouped_histogram_t>();
+  case export_v:
+    return std::make_unique<plotters::plotter_export_t>();
+  case grouped_histogram_v:
+    return std::make_unique<plotters::plotter_grouped_histogram_t>();
+  case html_v:
+    return std::make_unique<plotters::plotter_html_t>();
   case stack_v:
     return std::make_unique<plotters::plotter_stack_t>();
   }
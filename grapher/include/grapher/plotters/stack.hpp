@@ -32,6 +32,7 @@ namespace grapher::plotters {
 ///   "height": 500,
 ///   "legend_title": "Timings",
 ///   "name_json_pointer": "/name",
+///   "plot_backend": "sciplot",
 ///   "plot_file_extensions": [
 ///     ".svg",
 ///     ".png"
@@ -49,6 +50,9 @@ struct plotter_stack_t : plotter_base_t {
             grapher::json_t const &config) const override;
 
   grapher::json_t get_default_config() const override;
+
+  trace_projection_t
+  get_trace_projection(grapher::json_t const &config) const override;
 };
 
 } // namespace grapher::plotters
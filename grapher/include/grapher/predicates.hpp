@@ -2,21 +2,227 @@
 
 #include <grapher/core.hpp>
 
-#include <functional>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_set>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include <grapher/utils/pattern.hpp>
+#include <grapher/utils/simd.hpp>
+
 namespace grapher {
 
 /// \defgroup predicates Predicates
 /// Predicates for group descriptors.
 
 /// \ingroup predicates
-/// Dynamic representation of a predicate.
-using predicate_t = std::function<bool(grapher::json_t const &)>;
+/// Opcodes of compiled predicate instructions.
+enum predicate_opcode_t : std::uint8_t {
+  /// Constant result, held by the operand
+  constant_op_v,
+
+  /// The field is a string equal to the symbol
+  streq_op_v,
+
+  /// The field is a string that matches the pattern at the operand index
+  regex_op_v,
+
+  /// The field is present and equal to the JSON value at the operand index
+  equals_op_v,
+
+  /// The field is a string or an id in the set at the operand index
+  in_set_op_v,
+
+  /// The field is a number within the range at the operand index
+  range_op_v,
+
+  /// All the sub-expressions are satisfied
+  all_op_v,
+
+  /// One of the sub-expressions is satisfied
+  any_op_v,
+};
+
+/// \ingroup predicates
+/// Set of strings and ids matched by in_set_op_v, looked up in constant time.
+struct predicate_set_t {
+  /// Strings of the set, as symbols
+  std::unordered_set<symbol_t> symbols;
+
+  /// Unsigned integers of the set, ie. process or thread ids
+  std::unordered_set<std::uint64_t> ids;
+
+  /// Bitmap of the symbols of the set, indexed by symbol (see
+  /// simd::mask_in_bitmap). Used to match whole symbol columns at once.
+  std::vector<std::uint32_t> symbol_bitmap;
+
+  bool contains(event_value_t const &value) const {
+    switch (value.kind) {
+    case string_kind_v:
+      return symbols.contains(value.get_symbol());
+    case unsigned_kind_v:
+      return ids.contains(value.bits);
+    case integer_kind_v:
+      return std::bit_cast<std::int64_t>(value.bits) >= 0 &&
+             ids.contains(value.bits);
+    default:
+      return false;
+    }
+  }
+};
+
+/// \ingroup predicates
+/// Inclusive bounds matched by range_op_v.
+struct predicate_range_t {
+  double min;
+  double max;
+
+  bool contains(double value) const { return min <= value && value <= max; }
+};
+
+/// \ingroup predicates
+/// Instruction of a compiled predicate program. Programs are expression trees
+/// stored in prefix order: the sub-expressions of an instruction directly
+/// follow it.
+struct predicate_instruction_t {
+  predicate_opcode_t opcode;
+
+  /// Event field read by leaf instructions
+  event_field_t field = {};
+
+  /// Symbol compared by streq_op_v
+  symbol_t symbol = no_symbol_v;
+
+  /// Constant value, or index in the pattern or value table
+  std::uint32_t operand = 0;
+
+  /// Number of instructions of the expression, including this one
+  std::uint32_t size = 1;
+};
+
+/// \ingroup predicates
+/// Cache of predicate results, keyed by the values of the fields read by the
+/// predicate (see predicates.cpp).
+struct predicate_memo_t;
 
 /// \ingroup predicates
-/// Builds predicate and stores it in an std::function object.
+/// Compiled predicate. Predicates are evaluated on rows of event tables, JSON
+/// events are converted into one-row tables.
+///
+/// Predicates are compiled from JSON into flat programs whose fields are
+/// resolved once. Nested conjunctions and disjunctions are merged, constant
+/// sub-expressions are folded, and their operands are ordered so the cheapest
+/// and most decisive ones are evaluated first.
+///
+/// Predicates can also be evaluated on batches of consecutive rows, in which
+/// case string comparisons and set lookups on the name and detail columns, and
+/// range checks on the numeric columns are vectorized and produce row
+/// bitmasks.
+class predicate_t {
+public:
+  /// Maximum number of rows of a batch.
+  static constexpr std::size_t batch_size = 4096;
+
+  /// Number of mask words of a full batch.
+  static constexpr std::size_t batch_words =
+      simd::get_mask_word_count(batch_size);
+
+  /// Compiled program and its constants.
+  struct program_t {
+    std::vector<predicate_instruction_t> instructions;
+    std::vector<pattern_matcher_t> patterns;
+    std::vector<grapher::json_t> values;
+    std::vector<predicate_set_t> sets;
+    std::vector<predicate_range_t> ranges;
+
+    /// Memoized results, if memoization is enabled
+    std::shared_ptr<predicate_memo_t> memo;
+  };
+
+  /// Default predicate, always satisfied.
+  predicate_t() = default;
+  explicit predicate_t(program_t program)
+      : program_(std::make_shared<program_t const>(std::move(program))) {}
+
+  /// Evaluates the predicate on an event table row.
+  bool operator()(grapher::event_table_t const &table, std::size_t row) const {
+    if (program_ == nullptr || program_->instructions.empty()) {
+      return true;
+    }
+    if (program_->memo != nullptr) {
+      return evaluate_memoized(table, row);
+    }
+    return evaluate(0, table, row);
+  }
+
+  /// Evaluates the predicate on a JSON event.
+  bool operator()(grapher::json_t const &event) const;
+
+  /// Evaluates the predicate on count rows starting at begin, with count at
+  /// most batch_size. Bit i of mask is set for rows begin + i to evaluate, and
+  /// is cleared if the row doesn't satisfy the predicate.
+  void evaluate(grapher::event_table_t const &table, std::size_t begin,
+                std::size_t count, std::span<std::uint64_t> mask) const {
+    if (program_ == nullptr || program_->instructions.empty()) {
+      return;
+    }
+    if (program_->memo != nullptr) {
+      evaluate_memoized(table, begin, count, mask);
+      return;
+    }
+    evaluate_batch(0, table, begin, count, mask);
+  }
+
+  /// Returns the compiled instructions.
+  std::span<predicate_instruction_t const> get_instructions() const {
+    if (program_ == nullptr) {
+      return {};
+    }
+    return program_->instructions;
+  }
+
+  /// Returns the sets of in_set_op_v instructions.
+  std::span<predicate_set_t const> get_sets() const {
+    if (program_ == nullptr) {
+      return {};
+    }
+    return program_->sets;
+  }
+
+private:
+  /// Evaluates the expression starting at a given instruction.
+  bool evaluate(std::size_t instruction_id, grapher::event_table_t const &table,
+                std::size_t row) const;
+
+  /// Evaluates the predicate on a row, using memoized results if possible.
+  bool evaluate_memoized(grapher::event_table_t const &table,
+                         std::size_t row) const;
+
+  /// Evaluates the predicate on the rows of a batch with memoized results.
+  void evaluate_memoized(grapher::event_table_t const &table,
+                         std::size_t begin, std::size_t count,
+                         std::span<std::uint64_t> mask) const;
+
+  /// Evaluates the expression starting at a given instruction on a batch.
+  void evaluate_batch(std::size_t instruction_id,
+                      grapher::event_table_t const &table, std::size_t begin,
+                      std::size_t count, std::span<std::uint64_t> mask) const;
+
+  /// Programs are immutable and shared by copies
+  std::shared_ptr<program_t const> program_;
+};
+
+/// \ingroup predicates
+/// Compiles a predicate from its JSON description.
 predicate_t get_predicate(grapher::json_t const &constraint);
 
+/// \ingroup predicates
+/// Returns pointers to the event fields that are read by a predicate.
+std::vector<grapher::json_t::json_pointer>
+get_predicate_pointers(grapher::json_t const &constraint);
+
 } // namespace grapher
@@ -0,0 +1,53 @@
+#pragma once
+
+/// \file
+/// Binary time-trace cache files.
+///
+/// A trace cache file holds the events of a time-trace file in a compact
+/// columnar form, next to the original file with an additional `.ctbc`
+/// extension. It contains:
+/// - a header with the size, modification time and hash of the source file,
+/// - a table of interned strings,
+/// - fixed-width name, detail, ts, dur, pid and tid columns,
+/// - an args table holding the other event fields, indexed by event.
+///
+/// Cache files are memory-mapped and read without any parsing. A cache file is
+/// ignored when the source file size changes, or when its modification time
+/// changes along with its content hash. When only the modification time
+/// changes, it is updated in the cache file so the source file is hashed once.
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include <grapher/core.hpp>
+#include <grapher/trace_reader.hpp>
+
+namespace grapher {
+
+/// Extension added to time-trace file names for their cache file.
+inline constexpr std::string_view trace_cache_extension = ".ctbc";
+
+/// Returns the path of the cache file of a time-trace file.
+std::filesystem::path get_trace_cache_path(std::filesystem::path const &path);
+
+/// Returns true if a file is a trace cache file.
+bool is_trace_cache_path(std::filesystem::path const &path);
+
+/// Writes the cache file of a time-trace file from its whole events.
+/// Returns false if the cache file could not be written.
+bool write_trace_cache(std::filesystem::path const &path,
+                       event_table_t const &events);
+
+/// Reads events from the cache file of a time-trace file using the given
+/// projection. Returns std::nullopt if there is no valid cache file.
+std::optional<event_table_t>
+read_trace_cache(std::filesystem::path const &path,
+                 trace_projection_t const &projection = {});
+
+/// Reads the events of a time-trace file using its cache file if it is valid.
+/// Otherwise, the time-trace file is parsed and its cache file is written.
+event_table_t read_cached_trace_events(std::filesystem::path const &path,
+                                       trace_projection_t const &projection);
+
+} // namespace grapher
@@ -0,0 +1,60 @@
+#pragma once
+
+/// \file
+/// Time-trace file reading.
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include <grapher/core.hpp>
+#include <grapher/predicates.hpp>
+
+namespace grapher {
+
+/// Describes the parts of time-trace events that are read by a plotter.
+/// Time-trace files are read with a streaming parser that only materializes
+/// the projected fields of the events that pass the filters, so memory usage
+/// is bounded by the data that is actually needed.
+struct trace_projection_t {
+  /// If true, events are kept whole and pointers are ignored.
+  bool keep_all_fields = true;
+
+  /// Pointers to the event fields to keep. Fields nested under a kept pointer
+  /// are kept as well.
+  std::vector<grapher::json_t::json_pointer> pointers = {};
+
+  /// Events are kept if they satisfy all the predicates of at least one of
+  /// the filters. All events are kept if there is no filter.
+  std::vector<std::vector<predicate_t>> filters = {};
+};
+
+/// Returns true if an event passes the filters of a projection.
+bool is_selected(event_table_t const &events, std::size_t row,
+                 trace_projection_t const &projection);
+
+/// Returns true if a field is kept by a projection.
+bool is_projected(std::string_view pointer,
+                  trace_projection_t const &projection);
+
+/// Applies a projection to events that were read whole.
+event_table_t project_events(event_table_t const &events,
+                             trace_projection_t const &projection);
+
+/// Input method for time-trace files.
+enum trace_input_t : std::uint8_t {
+  /// Parse straight from a read-only memory mapping of the file. Falls back to
+  /// buffered_input_v if the file can't be mapped.
+  mapped_input_v,
+  /// Parse from a buffered file stream.
+  buffered_input_v,
+};
+
+/// Reads the trace events of a time-trace file, keeping only the fields and
+/// events selected by the projection.
+event_table_t read_trace_events(std::filesystem::path const &path,
+                                trace_projection_t const &projection = {},
+                                trace_input_t input = mapped_input_v);
+
+} // namespace grapher
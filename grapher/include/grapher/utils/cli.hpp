@@ -1,16 +1,49 @@
 #pragma once
 
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include <llvm/Support/CommandLine.h>
 
 #include <nlohmann/json.hpp>
 
 #include "grapher/core.hpp"
+#include "grapher/trace_reader.hpp"
 
 namespace grapher {
 
+/// File name of benchmark indexes. A benchmark index lists the repetition
+/// files of a benchmark directory so they can be found without crawling it.
+///
+/// Index format, with paths relative to the benchmark directory:
+///
+/// \code{.json}
+/// {
+///   "repetitions": [
+///     { "size": 1, "path": "1/1.json" },
+///     { "size": 1, "path": "1/2.json" }
+///   ]
+/// }
+/// \endcode
+inline constexpr std::string_view benchmark_index_filename =
+    "ctbench-index.json";
+
+/// Builds a category from a list of paths to benchmarks. Benchmark directories
+/// are read from their index if they have one, and scanned in parallel
+/// otherwise. Trace files are read using the given projection, and through
+/// their binary cache files if use_trace_cache is true.
+grapher::benchmark_set_t
+build_category(std::vector<std::filesystem::path> const &benchmark_paths,
+               trace_projection_t projection = {},
+               bool use_trace_cache = false);
+
 /// Builds a category from a list of string arguments that contains paths to
-/// benchmarks.
+/// benchmarks (see above).
 grapher::benchmark_set_t
-build_category(llvm::cl::list<std::string> const &benchmark_path_list);
+build_category(llvm::cl::list<std::string> const &benchmark_path_list,
+               trace_projection_t projection = {},
+               bool use_trace_cache = false);
 
 } // namespace grapher
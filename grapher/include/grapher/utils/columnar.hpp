@@ -0,0 +1,150 @@
+#pragma once
+
+/// \file
+/// Binary columnar data files.
+///
+/// A columnar file holds a table of rows with fixed-width columns, written as
+/// a stream of blocks so tables of any size are written in constant memory.
+/// It contains:
+/// - a header with the number of columns and their types,
+/// - blocks of rows, each column of a block being a contiguous array,
+/// - a dictionary of the strings held by string columns, and the column
+///   names,
+/// - the offsets of the blocks, and a footer locating the other sections.
+///
+/// String columns hold 32-bit dictionary ids, and unsigned columns hold 64-bit
+/// values. All the sections are aligned on 8 bytes, so files can be
+/// memory-mapped and their columns read in place. Values are stored with the
+/// byte order of the machine that wrote the file.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <grapher/core.hpp>
+#include <grapher/utils/mmap.hpp>
+
+namespace grapher {
+
+/// Types of columnar file columns.
+enum column_type_t : std::uint32_t {
+  /// Dictionary-encoded strings, stored as std::uint32_t ids
+  string_column_v,
+
+  /// Unsigned integers, stored as std::uint64_t
+  unsigned_column_v,
+};
+
+/// Column of a columnar file.
+struct column_schema_t {
+  std::string name;
+  column_type_t type;
+};
+
+/// Dictionary id of missing strings.
+inline constexpr std::uint32_t no_string_id_v = ~std::uint32_t{0};
+
+/// Streaming columnar file writer. Rows are buffered until a block is full,
+/// then written to the file.
+class columnar_writer_t {
+public:
+  /// Default number of rows per block.
+  static constexpr std::size_t default_block_size = 65536;
+
+  /// Creates a columnar file at path. Check is_open() for success.
+  columnar_writer_t(std::filesystem::path const &path,
+                    std::vector<column_schema_t> schema,
+                    std::size_t block_size = default_block_size);
+
+  columnar_writer_t(columnar_writer_t const &) = delete;
+  columnar_writer_t &operator=(columnar_writer_t const &) = delete;
+
+  /// Writes the file tail if close() wasn't called.
+  ~columnar_writer_t();
+
+  bool is_open() const { return output_.is_open(); }
+
+  /// Appends a row with a value per column. Values of string columns are
+  /// interned string symbols, no_symbol_v for missing strings.
+  void append_row(std::span<std::uint64_t const> values);
+
+  /// Writes the buffered rows and the file tail, and closes the file. Returns
+  /// false if the file could not be written.
+  bool close();
+
+private:
+  void write_block();
+  std::uint32_t get_string_id(symbol_t symbol);
+
+  std::ofstream output_;
+  std::vector<column_schema_t> schema_;
+  std::size_t block_size_;
+
+  /// Buffered rows, one vector per column
+  std::vector<std::vector<std::uint64_t>> columns_;
+
+  std::vector<std::uint64_t> block_offsets_;
+  std::uint64_t row_count_ = 0;
+
+  std::vector<std::string_view> strings_;
+  std::unordered_map<symbol_t, std::uint32_t> string_ids_;
+};
+
+/// Memory-mapped columnar file.
+class columnar_reader_t {
+public:
+  /// Maps the file at path. Check is_open() for success.
+  explicit columnar_reader_t(std::filesystem::path const &path);
+
+  /// Returns true if the file was mapped and is a valid columnar file.
+  bool is_open() const { return is_valid_; }
+
+  std::size_t get_row_count() const { return row_count_; }
+  std::size_t get_block_count() const { return block_offsets_.size(); }
+  std::size_t get_column_count() const { return column_types_.size(); }
+
+  std::string_view get_column_name(std::size_t column_id) const;
+  column_type_t get_column_type(std::size_t column_id) const {
+    return column_type_t(column_types_[column_id]);
+  }
+
+  /// Returns the index of a column, or get_column_count() if there is none
+  /// with that name.
+  std::size_t find_column(std::string_view name) const;
+
+  std::size_t get_block_row_count(std::size_t block_id) const;
+
+  /// Returns the dictionary ids of a string column in a block.
+  std::span<std::uint32_t const> get_string_column(std::size_t block_id,
+                                                   std::size_t column_id) const;
+
+  /// Returns the values of an unsigned column in a block.
+  std::span<std::uint64_t const>
+  get_unsigned_column(std::size_t block_id, std::size_t column_id) const;
+
+  /// Returns the string of a dictionary id, or an empty string for
+  /// no_string_id_v.
+  std::string_view get_string(std::uint32_t string_id) const;
+
+private:
+  std::size_t get_column_offset(std::size_t block_id,
+                                std::size_t column_id) const;
+
+  mapped_file_t file_;
+  bool is_valid_ = false;
+
+  std::size_t row_count_ = 0;
+  std::span<std::uint32_t const> column_types_;
+  std::span<std::uint32_t const> column_names_;
+  std::span<std::uint64_t const> block_offsets_;
+  std::span<std::uint64_t const> string_offsets_;
+  std::string_view string_data_;
+};
+
+} // namespace grapher
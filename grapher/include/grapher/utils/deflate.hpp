@@ -0,0 +1,30 @@
+#pragma once
+
+/// \file
+/// Minimal deflate compressor, used for PNG files and compressed report data
+/// so no compression library is needed.
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace grapher {
+
+/// Compresses data as a raw deflate stream (RFC 1951) made of a single block
+/// with the fixed Huffman codes. LZ77 matches are found with hash chains over
+/// the whole 32K window, with zlib-like limits on the search so images with
+/// long runs of background pixels compress quickly.
+std::vector<std::uint8_t> deflate(std::span<std::uint8_t const> data);
+
+/// Returns the CRC-32 of data, as used by PNG and gzip.
+std::uint32_t get_crc32(std::string_view data);
+
+/// Returns the Adler-32 checksum of data, as used by zlib streams.
+std::uint32_t get_adler32(std::span<std::uint8_t const> data);
+
+/// Compresses data as a gzip file (RFC 1952).
+std::string gzip(std::string_view data);
+
+} // namespace grapher
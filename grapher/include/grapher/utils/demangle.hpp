@@ -0,0 +1,37 @@
+#pragma once
+
+/// \file
+/// Memoized demangling of interned symbols.
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <grapher/core.hpp>
+
+namespace grapher {
+
+/// Demangles a C++ symbol name. Strings that aren't mangled names are returned
+/// as is.
+std::string demangle(std::string const &name);
+
+/// Demangled strings of interned symbols. Each symbol is demangled once, and
+/// symbols are demangled in parallel when they're added to the cache.
+class demangle_cache_t {
+public:
+  /// Demangles the symbols that aren't in the cache yet.
+  void insert(std::span<symbol_t const> symbols);
+
+  /// Returns the demangled string of a symbol. The symbol must have been
+  /// inserted before. Safe to call concurrently.
+  std::string const &get(symbol_t symbol) const;
+
+  /// Number of demangled symbols.
+  std::size_t size() const { return demangled_names_.size(); }
+
+private:
+  std::unordered_map<symbol_t, std::string> demangled_names_;
+};
+
+} // namespace grapher
@@ -0,0 +1,31 @@
+#pragma once
+
+/// \file
+/// File fingerprints used to detect changes in input files between runs.
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace grapher {
+
+/// Size and modification time of a file.
+struct file_stamp_t {
+  std::uint64_t size;
+  std::int64_t mtime;
+
+  bool operator==(file_stamp_t const &) const = default;
+};
+
+/// Returns the stamp of a file, or std::nullopt if it can't be read.
+std::optional<file_stamp_t> get_file_stamp(std::filesystem::path const &path);
+
+/// FNV-1a hash of a byte sequence.
+std::uint64_t hash_bytes(std::string_view data);
+
+/// Returns the hash of the content of a file, or std::nullopt if it can't be
+/// read.
+std::optional<std::uint64_t> hash_file(std::filesystem::path const &path);
+
+} // namespace grapher
@@ -0,0 +1,64 @@
+#pragma once
+
+/// \file
+/// Long-lived gnuplot processes fed over a pipe.
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace grapher {
+
+/// gnuplot process reading commands from a pipe. Plots are rendered by
+/// switching terminals and outputs between them, so rendering many files
+/// doesn't start a process per file.
+class gnuplot_session_t {
+public:
+  /// Starts a session running command, which reads gnuplot commands from its
+  /// standard input.
+  explicit gnuplot_session_t(std::string command = "gnuplot");
+
+  gnuplot_session_t(gnuplot_session_t const &) = delete;
+  gnuplot_session_t &operator=(gnuplot_session_t const &) = delete;
+
+  /// Waits for the commands to be processed.
+  ~gnuplot_session_t();
+
+  /// Returns true if the process is running and accepted every command so
+  /// far.
+  bool is_open() const { return pipe_ != nullptr; }
+
+  /// Sends commands, returns false if the process doesn't accept them
+  /// anymore. The session is closed in that case. Destination names what the
+  /// commands render, so errors reported when the session is closed can name
+  /// the last plot it was sent.
+  ///
+  /// SIGPIPE is blocked on the calling thread while writing, so a process
+  /// that exited early makes sending fail instead of killing grapher.
+  bool send(std::string_view commands, std::string_view destination = {});
+
+  /// Closes the pipe and waits for the commands to be processed. Returns
+  /// false if the process couldn't be started, stopped accepting commands, or
+  /// exited with an error.
+  bool close();
+
+  /// Returns the destination of the last commands sent to the session.
+  std::string const &get_last_destination() const { return last_destination_; }
+
+private:
+  std::string command_;
+  std::string last_destination_;
+  std::FILE *pipe_ = nullptr;
+  bool failed_ = false;
+};
+
+/// Returns the gnuplot terminal command for a file extension (`.svg`, `.png`,
+/// `.pdf`, ...), with a size in points.
+std::string get_gnuplot_terminal(std::string_view extension, std::size_t width,
+                                 std::size_t height);
+
+/// Quotes a string for gnuplot commands.
+std::string quote_gnuplot_string(std::string_view str);
+
+} // namespace grapher
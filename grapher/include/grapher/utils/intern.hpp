@@ -0,0 +1,40 @@
+#pragma once
+
+/// \file
+/// Process-wide string interning.
+///
+/// Strings that repeat across events and repetitions (event names, details,
+/// keys, predicate operands) are stored once and referred to with 32-bit
+/// symbols, so hashing and comparing them is integer work.
+///
+/// Symbol values depend on interning order, which isn't deterministic when
+/// strings are interned concurrently. Symbols must be ordered by their strings
+/// whenever the order is observable.
+
+#include <string>
+#include <string_view>
+
+#include <grapher/core.hpp>
+
+namespace grapher {
+
+/// Returns the symbol of a string, adding it to the interning table if
+/// needed. Safe to call concurrently.
+symbol_t intern(std::string_view str);
+
+/// Returns the symbol of a string if it was interned already, no_symbol_v
+/// otherwise. Safe to call concurrently.
+symbol_t find_symbol(std::string_view str);
+
+/// Returns the string of a symbol. The reference remains valid until the end
+/// of the program. Safe to call concurrently.
+std::string const &get_symbol_string(symbol_t symbol);
+
+/// Compares symbols by their strings.
+struct symbol_string_less_t {
+  bool operator()(symbol_t a, symbol_t b) const {
+    return a != b && get_symbol_string(a) < get_symbol_string(b);
+  }
+};
+
+} // namespace grapher
@@ -4,6 +4,8 @@
 #include <source_location>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include <llvm/Support/raw_ostream.h>
 
@@ -13,7 +15,9 @@
 
 #include "grapher/core.hpp"
 #include "grapher/predicates.hpp"
+#include "grapher/trace_reader.hpp"
 #include "grapher/utils/error.hpp"
+#include "grapher/utils/plot.hpp"
 
 namespace grapher {
 
@@ -177,6 +181,86 @@ group_descriptor_t read_descriptor(grapher::json_t const &descriptor_json);
 std::vector<group_descriptor_t>
 read_descriptors(grapher::json_t::array_t const &list);
 
+/// Returns a trace projection that only keeps the value and the fields read by
+/// the descriptors, for the events matched by at least one descriptor.
+trace_projection_t
+get_descriptors_projection(std::vector<group_descriptor_t> const &descriptors,
+                           grapher::json_t::json_pointer value_json_pointer);
+
+/// Finds the group descriptors matching events. Descriptors with a predicate
+/// that requires a field to hold one of a few strings (`streq` or string-only
+/// `in_set` predicates, possibly combined with `op_and` or `op_or`) are indexed
+/// by these strings, so a hash lookup per event selects the few descriptors
+/// worth evaluating. Other descriptors are evaluated on every event.
+class descriptor_dispatcher_t {
+public:
+  explicit descriptor_dispatcher_t(
+      std::vector<group_descriptor_t> const &descriptors);
+
+  /// Number of descriptors.
+  std::size_t size() const { return predicates_.size(); }
+
+  /// Number of descriptors that are evaluated on every event.
+  std::size_t unindexed_size() const { return unindexed_descriptor_ids_.size(); }
+
+  /// Calls function with the index of every descriptor matching an event, in
+  /// no particular order.
+  template <typename FunctionType>
+  void for_each_match(event_table_t const &table, std::size_t row,
+                      FunctionType &&function) const {
+    for (index_t const &index : indexes_) {
+      event_value_t const value = table.get(row, index.field);
+      if (!value.is_string()) {
+        continue;
+      }
+      if (auto const it = index.descriptor_ids.find(value.get_symbol());
+          it != index.descriptor_ids.end()) {
+        for (std::size_t const descriptor_id : it->second) {
+          if (is_matching(descriptor_id, table, row)) {
+            function(descriptor_id);
+          }
+        }
+      }
+    }
+
+    for (std::size_t const descriptor_id : unindexed_descriptor_ids_) {
+      if (is_matching(descriptor_id, table, row)) {
+        function(descriptor_id);
+      }
+    }
+  }
+
+private:
+  /// Descriptors indexed by the string value of a field.
+  struct index_t {
+    event_field_t field;
+    std::unordered_map<symbol_t, std::vector<std::size_t>> descriptor_ids;
+  };
+
+  bool is_matching(std::size_t descriptor_id, event_table_t const &table,
+                   std::size_t row) const {
+    for (predicate_t const &predicate : predicates_[descriptor_id]) {
+      if (!predicate(table, row)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<std::vector<predicate_t>> predicates_;
+  std::vector<index_t> indexes_;
+  std::vector<std::size_t> unindexed_descriptor_ids_;
+};
+
+/// For each descriptor and each repetition in instance, returns the sum of the
+/// values pointed by value_json_pointer in the events matching the
+/// descriptor's predicates. Events are scanned once for all the descriptors.
+/// Sums are indexed by descriptor, then by repetition.
+std::vector<std::vector<grapher::value_t>>
+filtered_values_sums(benchmark_instance_t const &instance,
+                     descriptor_dispatcher_t const &dispatcher,
+                     grapher::json_t::json_pointer value_json_pointer);
+
 // =============================================================================
 // Plotter configuration
 
@@ -185,10 +269,22 @@ read_descriptors(grapher::json_t::array_t const &list);
 void save_plot(sciplot::Plot2D plot, std::string const &dest,
                grapher::json_t const &config);
 
+/// Saves a plot to a given destination. With the `native` plot backend, SVG
+/// and PNG files are rendered without gnuplot. Otherwise the plot is converted
+/// to a sciplot plot and saved as such.
+void save_plot(plot_t plot, std::string const &dest,
+               grapher::json_t const &config);
+
+/// Converts a plot to a sciplot plot.
+sciplot::Plot2D to_sciplot(plot_t const &plot);
+
 /// Returns a default configuration for apply_config.
 grapher::json_t base_default_config();
 
 /// Apply config to plot.
 sciplot::Plot &apply_config(sciplot::Plot &plot, grapher::json_t const &config);
 
+/// Apply config to plot.
+plot_t &apply_config(plot_t &plot, grapher::json_t const &config);
+
 } // namespace grapher
@@ -1,7 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <functional>
+#include <map>
 #include <numeric>
+#include <optional>
+#include <set>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include <grapher/core.hpp>
@@ -20,12 +29,17 @@ inline double average(std::vector<value_t> const &values) {
 /// Conputes median of a series of value_t values.
 inline double median(std::vector<value_t> values) {
   check(!values.empty(), "Cannot compute median of an empty vector.");
-  std::ranges::sort(values);
   bool const y_values_even = (values.size() & std::size_t(1)) == 0;
   std::size_t const mid = values.size() / 2;
 
-  return y_values_even ? ((double(values[mid - 1]) + double(values[mid])) / 2)
-                       : double(values[mid]);
+  // Partial sort, the lower middle value is the maximum of the lower half
+  std::ranges::nth_element(values, values.begin() + mid);
+  if (!y_values_even) {
+    return double(values[mid]);
+  }
+  return (double(*std::max_element(values.begin(), values.begin() + mid)) +
+          double(values[mid])) /
+         2;
 }
 
 /// Computes standard deviation of a series of value_t values.
@@ -43,4 +57,267 @@ inline double stddev(std::vector<value_t> const &values) {
   return std::sqrt(acc / count);
 }
 
+/// Streaming quantile estimator using the P² algorithm (Jain & Chlamtac). It
+/// uses constant memory and is exact for up to 5 values.
+class p2_quantile_t {
+public:
+  explicit p2_quantile_t(double quantile = 0.5)
+      : desired_increments_{0, quantile / 2, quantile, (1 + quantile) / 2, 1},
+        quantile_(quantile) {}
+
+  /// Adds a value to the series.
+  void push(double value) {
+    // Initialization with the first values
+    if (count_ < marker_count) {
+      heights_[count_++] = value;
+      if (count_ == marker_count) {
+        std::ranges::sort(heights_);
+        positions_ = {0, 1, 2, 3, 4};
+        desired_positions_ = {0, 2 * quantile_, 4 * quantile_,
+                              2 + 2 * quantile_, 4};
+      }
+      return;
+    }
+    count_++;
+
+    // Cell of the value, extreme markers are moved if needed
+    std::size_t cell;
+    if (value < heights_[0]) {
+      heights_[0] = value;
+      cell = 0;
+    } else if (value >= heights_[4]) {
+      heights_[4] = value;
+      cell = 3;
+    } else {
+      cell = 0;
+      while (value >= heights_[cell + 1]) {
+        cell++;
+      }
+    }
+
+    for (std::size_t i = cell + 1; i < marker_count; i++) {
+      positions_[i]++;
+    }
+    for (std::size_t i = 0; i < marker_count; i++) {
+      desired_positions_[i] += desired_increments_[i];
+    }
+
+    // Middle markers adjustment
+    for (std::size_t i = 1; i < marker_count - 1; i++) {
+      double const offset = desired_positions_[i] - positions_[i];
+      if ((offset >= 1 && positions_[i + 1] - positions_[i] > 1) ||
+          (offset <= -1 && positions_[i - 1] - positions_[i] < -1)) {
+        double const direction = offset > 0 ? 1 : -1;
+        double const height = get_parabolic_height(i, direction);
+        heights_[i] = heights_[i - 1] < height && height < heights_[i + 1]
+                          ? height
+                          : get_linear_height(i, direction);
+        positions_[i] += direction;
+      }
+    }
+  }
+
+  /// Returns the estimated quantile of the series.
+  double get() const {
+    check(count_ != 0, "Cannot compute quantile of an empty series.");
+    if (count_ >= marker_count) {
+      return heights_[2];
+    }
+
+    // Exact quantile of the first values, interpolated like median
+    std::array<double, marker_count> values = heights_;
+    std::sort(values.begin(), values.begin() + count_);
+    double const rank = quantile_ * double(count_ - 1);
+    std::size_t const lower_rank = std::size_t(rank);
+    if (lower_rank + 1 >= count_) {
+      return values[lower_rank];
+    }
+    return values[lower_rank] +
+           (rank - double(lower_rank)) *
+               (values[lower_rank + 1] - values[lower_rank]);
+  }
+
+  /// Number of values in the series.
+  std::size_t count() const { return count_; }
+
+private:
+  static constexpr std::size_t marker_count = 5;
+
+  double get_parabolic_height(std::size_t i, double direction) const {
+    return heights_[i] +
+           direction / (positions_[i + 1] - positions_[i - 1]) *
+               ((positions_[i] - positions_[i - 1] + direction) *
+                    (heights_[i + 1] - heights_[i]) /
+                    (positions_[i + 1] - positions_[i]) +
+                (positions_[i + 1] - positions_[i] - direction) *
+                    (heights_[i] - heights_[i - 1]) /
+                    (positions_[i] - positions_[i - 1]));
+  }
+
+  double get_linear_height(std::size_t i, double direction) const {
+    std::size_t const neighbor = direction > 0 ? i + 1 : i - 1;
+    return heights_[i] + direction * (heights_[neighbor] - heights_[i]) /
+                             (positions_[neighbor] - positions_[i]);
+  }
+
+  std::array<double, marker_count> heights_{};
+  std::array<double, marker_count> positions_{};
+  std::array<double, marker_count> desired_positions_{};
+  std::array<double, marker_count> desired_increments_;
+  double quantile_;
+  std::size_t count_ = 0;
+};
+
+/// Online statistics of a series of value_t values. Average and standard
+/// deviation are computed with Welford's algorithm, and the median with a P²
+/// estimator. If samples are kept, the median is exact and the samples can be
+/// read back.
+class accumulator_t {
+public:
+  explicit accumulator_t(bool keep_samples = false)
+      : keep_samples_(keep_samples) {}
+
+  /// Adds a value to the series.
+  void push(value_t value) {
+    count_++;
+    sum_ += double(value);
+    double const delta = double(value) - mean_;
+    mean_ += delta / double(count_);
+    squared_deviations_ += delta * (double(value) - mean_);
+
+    if (keep_samples_) {
+      samples_.push_back(value);
+    } else {
+      median_.push(double(value));
+    }
+  }
+
+  /// Number of values in the series.
+  std::size_t count() const { return count_; }
+  bool empty() const { return count_ == 0; }
+
+  /// Returns the average of the series.
+  double average() const {
+    check(count_ != 0, "Cannot compute average on empty series.");
+    return mean_;
+  }
+
+  /// Returns the sum of the series.
+  double sum() const { return sum_; }
+
+  /// Returns the standard deviation of the series.
+  double stddev() const {
+    check(count_ != 0, "Cannot compute stddev on empty series.");
+    return std::sqrt(squared_deviations_ / double(count_));
+  }
+
+  /// Returns the median of the series, exact if samples are kept.
+  double median() const {
+    return keep_samples_ ? math::median(samples_) : median_.get();
+  }
+
+  /// Returns the values of the series if samples are kept, in insertion
+  /// order. Returns an empty series otherwise.
+  std::span<value_t const> samples() const { return samples_; }
+
+  bool keeps_samples() const { return keep_samples_; }
+
+private:
+  std::size_t count_ = 0;
+  double sum_ = 0;
+  double mean_ = 0;
+  double squared_deviations_ = 0;
+
+  p2_quantile_t median_;
+  std::vector<value_t> samples_;
+  bool keep_samples_;
+};
+
+/// Streaming weighted heavy-hitter sketch using the Space-Saving algorithm
+/// (Metwally et al.). At most `capacity` keys are monitored at once. The
+/// estimated weight of a monitored key is never lower than its actual weight,
+/// and exceeds it by at most the total weight divided by the capacity. Every
+/// key heavier than that bound is monitored.
+///
+/// Keys of equal weight are ordered with Compare: the smallest one is evicted
+/// first, so results only depend on the order in which keys are pushed.
+template <typename Key, typename Compare = std::less<Key>>
+class heavy_hitters_t {
+public:
+  /// Weight estimate of a monitored key.
+  struct counter_t {
+    /// Estimated weight, an upper bound of the actual weight
+    double weight;
+
+    /// Maximum overestimation of the weight
+    double error;
+  };
+
+  explicit heavy_hitters_t(std::size_t capacity) : capacity_(capacity) {
+    check(capacity != 0, "Heavy-hitter sketch capacity must be positive.");
+  }
+
+  /// Adds weight to a key. When the sketch is full and the key isn't
+  /// monitored, it replaces the lightest monitored key and inherits its
+  /// weight. Returns the replaced key, if any.
+  std::optional<Key> push(Key const &key, double weight) {
+    total_weight_ += weight;
+
+    if (auto const it = counters_.find(key); it != counters_.end()) {
+      order_.erase({it->second.weight, key});
+      it->second.weight += weight;
+      order_.emplace(it->second.weight, key);
+      return std::nullopt;
+    }
+
+    counter_t counter{.weight = weight, .error = 0};
+    std::optional<Key> evicted_key;
+    if (counters_.size() == capacity_) {
+      auto const lightest = order_.begin();
+      counter = {.weight = lightest->first + weight, .error = lightest->first};
+      evicted_key = lightest->second;
+      counters_.erase(lightest->second);
+      order_.erase(lightest);
+    }
+
+    counters_.emplace(key, counter);
+    order_.emplace(counter.weight, key);
+    return evicted_key;
+  }
+
+  /// Returns the monitored keys, heaviest first.
+  std::vector<std::pair<Key, counter_t>> get_heavy_hitters() const {
+    std::vector<std::pair<Key, counter_t>> res;
+    res.reserve(order_.size());
+    for (auto it = order_.rbegin(); it != order_.rend(); it++) {
+      res.emplace_back(it->second, counters_.at(it->second));
+    }
+    return res;
+  }
+
+  /// Number of monitored keys.
+  std::size_t size() const { return counters_.size(); }
+
+  /// Sum of all the weights added to the sketch.
+  double total_weight() const { return total_weight_; }
+
+private:
+  /// Orders monitored keys by estimated weight, then by key.
+  struct weight_less_t {
+    bool operator()(std::pair<double, Key> const &a,
+                    std::pair<double, Key> const &b) const {
+      return a.first != b.first ? a.first < b.first
+                                : Compare{}(a.second, b.second);
+    }
+  };
+
+  std::size_t capacity_;
+  double total_weight_ = 0;
+
+  std::map<Key, counter_t, Compare> counters_;
+
+  /// Monitored keys ordered by estimated weight
+  std::set<std::pair<double, Key>, weight_less_t> order_;
+};
+
 } // namespace grapher::math
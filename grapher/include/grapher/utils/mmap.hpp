@@ -0,0 +1,49 @@
+#pragma once
+
+/// \file
+/// Read-only memory-mapped files.
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace grapher {
+
+/// Read-only memory mapping of a whole file. The mapping is released when the
+/// object is destroyed.
+class mapped_file_t {
+public:
+  /// Creates an empty, unopened mapping.
+  mapped_file_t() = default;
+
+  /// Maps the file at the given path. Check is_open() for success.
+  explicit mapped_file_t(std::filesystem::path const &path);
+
+  mapped_file_t(mapped_file_t const &) = delete;
+  mapped_file_t &operator=(mapped_file_t const &) = delete;
+
+  mapped_file_t(mapped_file_t &&other) noexcept;
+  mapped_file_t &operator=(mapped_file_t &&other) noexcept;
+
+  ~mapped_file_t();
+
+  /// Returns true if the file was successfully mapped (or is empty).
+  bool is_open() const { return is_open_; }
+
+  /// Hints the kernel that the mapping will be read sequentially, so pages are
+  /// read ahead aggressively and released early.
+  void advise_sequential() const;
+
+  /// Returns the content of the mapped file.
+  std::string_view data() const { return {data_, size_}; }
+
+  /// Returns the size of the mapped file.
+  std::size_t size() const { return size_; }
+
+private:
+  char const *data_ = nullptr;
+  std::size_t size_ = 0;
+  bool is_open_ = false;
+};
+
+} // namespace grapher
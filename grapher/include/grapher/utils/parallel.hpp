@@ -0,0 +1,30 @@
+#pragma once
+
+/// \file
+/// Minimal parallel execution helpers for data ingestion.
+
+#include <cstddef>
+#include <functional>
+
+namespace grapher {
+
+/// Sets the maximum number of threads used by parallel_for. 0 selects the
+/// number of hardware threads.
+void set_job_count(unsigned job_count);
+
+/// Returns the maximum number of threads used by parallel_for (at least 1).
+unsigned get_job_count();
+
+/// Calls function for every index in [0, count) using up to get_job_count()
+/// threads, including the calling thread. Indices are distributed dynamically,
+/// so function must not rely on any execution order. Calls made from within a
+/// parallel_for worker run serially.
+void parallel_for(std::size_t count,
+                  std::function<void(std::size_t)> const &function);
+
+/// Same as parallel_for, using up to job_count threads instead of
+/// get_job_count().
+void parallel_for(std::size_t count, unsigned job_count,
+                  std::function<void(std::size_t)> const &function);
+
+} // namespace grapher
@@ -0,0 +1,70 @@
+#pragma once
+
+/// \file
+/// Regex matching with fast paths for literal and glob-shaped patterns.
+
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace grapher {
+
+/// Shapes of regex patterns recognized by pattern_matcher_t.
+enum pattern_shape_t {
+  /// No special character, ie. `Total Source`
+  literal_shape_v,
+
+  /// Literal followed by `.*`, ie. `/usr/include/boost/.*`
+  prefix_shape_v,
+
+  /// `.*` followed by a literal, ie. `.*\.hpp`
+  suffix_shape_v,
+
+  /// Literal followed by a repeated character, ie. `Total*`
+  repeat_shape_v,
+
+  /// Literals separated by `.*`, ie. `.*boost.*\.hpp`
+  glob_shape_v,
+
+  /// Any other regex
+  regex_shape_v,
+};
+
+/// Returns the only string matched by a pattern, or std::nullopt if it matches
+/// several strings or isn't recognized as a literal.
+std::optional<std::string> get_pattern_literal(std::string const &pattern);
+
+/// ECMAScript regex matched against whole strings, like std::regex_match.
+///
+/// Patterns are compiled once. Patterns that are literals or literals
+/// separated by `.*` are matched with plain string comparisons and searches
+/// instead of the regex engine.
+class pattern_matcher_t {
+public:
+  explicit pattern_matcher_t(std::string const &pattern);
+
+  /// Returns true if the whole value matches the pattern.
+  bool operator()(std::string_view value) const;
+
+  pattern_shape_t get_shape() const { return shape_; }
+
+private:
+  /// Matches literals separated by wildcards.
+  bool match_glob(std::string_view value) const;
+
+  pattern_shape_t shape_;
+
+  /// Literals of the pattern, separated by `.*`
+  std::vector<std::string> literals_;
+
+  /// Repeated character of repeat_shape_v
+  char repeated_character_ = '\0';
+
+  /// Used for regex_shape_v, and for values with line terminators since `.`
+  /// doesn't match them
+  std::regex regex_;
+};
+
+} // namespace grapher
@@ -0,0 +1,143 @@
+#pragma once
+
+/// \file
+/// Backend-independent plots, and native SVG and PNG rendering.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace grapher {
+
+/// Kinds of plot series.
+enum series_kind_t : std::uint8_t {
+  /// Line through the points
+  curve_series_v,
+
+  /// Unconnected points
+  points_series_v,
+
+  /// Line through the points, with vertical error bars
+  error_bars_series_v,
+
+  /// Area between two curves
+  filled_series_v,
+};
+
+/// Series of a plot.
+struct plot_series_t {
+  series_kind_t kind;
+  std::string label;
+  std::vector<double> x;
+  std::vector<double> y;
+
+  /// Error bar half-heights of error_bars_series_v
+  std::vector<double> y_delta = {};
+
+  /// Lower curve of filled_series_v, y being the upper one
+  std::vector<double> y_low = {};
+};
+
+/// Legend locations.
+enum legend_position_t : std::uint8_t {
+  /// Outside of the graph, on the right
+  legend_right_v,
+
+  /// Below the graph
+  legend_bottom_v,
+};
+
+/// 2D plot description, independent of the rendering backend. Plots are
+/// either rendered natively (see layout_plot), or converted to sciplot plots
+/// and rendered by gnuplot.
+struct plot_t {
+  std::vector<plot_series_t> series;
+
+  std::string x_label;
+  std::string y_label;
+  std::string legend_title;
+  legend_position_t legend_position = legend_right_v;
+
+  /// Legend entries are listed from the last series to the first
+  bool legend_from_last = false;
+
+  /// Y axis bounds, computed from the data if absent
+  std::optional<std::pair<double, double>> y_range;
+
+  plot_series_t &draw_curve(std::vector<double> x, std::vector<double> y,
+                            std::string label);
+
+  plot_series_t &draw_points(std::vector<double> x, std::vector<double> y,
+                             std::string label);
+
+  plot_series_t &draw_curve_with_error_bars_y(std::vector<double> x,
+                                              std::vector<double> y,
+                                              std::vector<double> y_delta,
+                                              std::string label);
+
+  plot_series_t &draw_curves_filled(std::vector<double> x,
+                                    std::vector<double> y_low,
+                                    std::vector<double> y_high,
+                                    std::string label);
+};
+
+/// Point of a plot scene, in pixels from the top left corner.
+struct scene_point_t {
+  double x;
+  double y;
+};
+
+/// Horizontal text alignments.
+enum text_anchor_t : std::uint8_t {
+  anchor_start_v,
+  anchor_middle_v,
+  anchor_end_v,
+};
+
+/// Kinds of plot scene shapes.
+enum shape_kind_t : std::uint8_t {
+  rectangle_shape_v,
+  polyline_shape_v,
+  polygon_shape_v,
+  marker_shape_v,
+  text_shape_v,
+};
+
+/// Shape of a plot scene. Colors are indexes in the plot palette.
+struct scene_shape_t {
+  shape_kind_t kind;
+  std::uint8_t color;
+
+  /// Opposite corners of rectangles, vertices of polylines and polygons, or
+  /// positions of markers and text. Text is vertically centered on its
+  /// position.
+  std::vector<scene_point_t> points;
+
+  double line_width = 1.;
+  std::string text = {};
+  text_anchor_t anchor = anchor_start_v;
+  bool is_vertical = false;
+};
+
+/// Plot laid out for a given image size, as shapes drawn in order. A scene is
+/// converted to every output format without laying out the plot again.
+struct plot_scene_t {
+  std::size_t width;
+  std::size_t height;
+  std::vector<scene_shape_t> shapes;
+};
+
+/// Lays out a plot for an image of width x height pixels.
+plot_scene_t layout_plot(plot_t const &plot, std::size_t width,
+                         std::size_t height);
+
+/// Converts a plot scene to an SVG document.
+std::string to_svg(plot_scene_t const &scene);
+
+/// Rasterizes a plot scene to a PNG image.
+std::string to_png(plot_scene_t const &scene);
+
+} // namespace grapher
@@ -0,0 +1,29 @@
+#pragma once
+
+/// \file
+/// Minimal PNG encoder for rendered plots.
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace grapher {
+
+/// RGB color.
+struct rgb_t {
+  std::uint8_t r;
+  std::uint8_t g;
+  std::uint8_t b;
+
+  bool operator==(rgb_t const &) const = default;
+};
+
+/// Encodes an image with 8-bit palette indexes as a PNG file. Pixels are
+/// stored row by row. Image data is compressed with the built-in deflate
+/// compressor, whose matches cover the runs and repeated rows of plots.
+std::string encode_png(std::size_t width, std::size_t height,
+                       std::span<rgb_t const> palette,
+                       std::span<std::uint8_t const> pixels);
+
+} // namespace grapher
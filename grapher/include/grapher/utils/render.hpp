@@ -0,0 +1,45 @@
+#pragma once
+
+/// \file
+/// Concurrent plot rendering.
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+#include <grapher/utils/gnuplot.hpp>
+
+namespace grapher {
+
+/// Sets the maximum number of plots rendered concurrently, which bounds the
+/// number of gnuplot processes running at once. 0 selects the number of
+/// hardware threads.
+void set_render_job_count(unsigned job_count);
+
+/// Returns the maximum number of plots rendered concurrently (at least 1).
+unsigned get_render_job_count();
+
+/// Calls render for every index in [0, count) using up to
+/// get_render_job_count() threads. Each call usually prepares a plot and saves
+/// it with save_plot, which blocks on gnuplot.
+///
+/// A call that throws doesn't stop the other ones. Once every call is done,
+/// the exception thrown by the call with the lowest index is rethrown, so the
+/// reported error doesn't depend on scheduling.
+///
+/// Calls share a pool of gnuplot sessions (see get_render_session), which are
+/// closed before returning so every file is written.
+void render_parallel(std::size_t count,
+                     std::function<void(std::size_t)> const &render);
+
+/// Returns the gnuplot session lent to the render_parallel call running on
+/// the current thread, starting one if needed, or nullptr outside of
+/// render_parallel. Sessions that stopped accepting commands are replaced.
+gnuplot_session_t *get_render_session();
+
+/// Mutex held while constructing sciplot objects. Sciplot numbers its objects
+/// with unsynchronized counters and names gnuplot script files after them, so
+/// objects can't be constructed concurrently.
+std::mutex &get_sciplot_mutex();
+
+} // namespace grapher
@@ -0,0 +1,99 @@
+#pragma once
+
+/// \file
+/// Row bitmasks and vectorized kernels for batch predicate evaluation.
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/// Row bitmasks and vectorized kernels. Kernels are selected at runtime
+/// depending on the instruction sets supported by the CPU.
+namespace grapher::simd {
+
+/// Number of rows covered by a mask word.
+inline constexpr std::size_t mask_word_bits = 64;
+
+/// Returns the number of mask words needed for a number of rows.
+constexpr std::size_t get_mask_word_count(std::size_t row_count) {
+  return (row_count + mask_word_bits - 1) / mask_word_bits;
+}
+
+/// Sets the bits of the first row_count rows of a mask, and clears the others.
+inline void fill_mask(std::span<std::uint64_t> mask, std::size_t row_count) {
+  std::size_t const full_words = row_count / mask_word_bits;
+  std::fill(mask.begin(), mask.begin() + full_words, ~std::uint64_t{0});
+  std::fill(mask.begin() + full_words, mask.end(), std::uint64_t{0});
+  if (std::size_t const remainder = row_count % mask_word_bits;
+      remainder != 0) {
+    mask[full_words] = (std::uint64_t{1} << remainder) - 1;
+  }
+}
+
+/// Returns true if no bit of the mask is set.
+inline bool is_empty(std::span<std::uint64_t const> mask) {
+  return std::ranges::all_of(mask,
+                             [](std::uint64_t word) { return word == 0; });
+}
+
+/// Calls function with the index of every set bit of a mask, in increasing
+/// order.
+template <typename FunctionType>
+inline void for_each_set_bit(std::span<std::uint64_t const> mask,
+                             FunctionType &&function) {
+  for (std::size_t word_id = 0; word_id < mask.size(); word_id++) {
+    for (std::uint64_t word = mask[word_id]; word != 0; word &= word - 1) {
+      function(word_id * mask_word_bits + std::size_t(std::countr_zero(word)));
+    }
+  }
+}
+
+/// Sets bit i of mask if values[i] is equal to key, and clears it otherwise.
+/// Bits past the values are cleared. The mask must hold at least
+/// get_mask_word_count(values.size()) words.
+void mask_equal(std::span<std::uint32_t const> values, std::uint32_t key,
+                std::span<std::uint64_t> mask);
+
+/// Portable implementation of mask_equal.
+void mask_equal_scalar(std::span<std::uint32_t const> values,
+                       std::uint32_t key, std::span<std::uint64_t> mask);
+
+/// Sets bit i of mask if values[i] is in a bitmap, ie. if bit values[i] % 32 of
+/// bitmap[values[i] / 32] is set, and clears it otherwise. Values past the
+/// bitmap are not in it. Bits past the values are cleared.
+void mask_in_bitmap(std::span<std::uint32_t const> values,
+                    std::span<std::uint32_t const> bitmap,
+                    std::span<std::uint64_t> mask);
+
+/// Portable implementation of mask_in_bitmap.
+void mask_in_bitmap_scalar(std::span<std::uint32_t const> values,
+                           std::span<std::uint32_t const> bitmap,
+                           std::span<std::uint64_t> mask);
+
+/// Sets bit i of mask if min <= values[i] <= max, and clears it otherwise.
+/// Bits past the values are cleared.
+void mask_in_range(std::span<std::uint64_t const> values, std::uint64_t min,
+                   std::uint64_t max, std::span<std::uint64_t> mask);
+
+/// Portable implementation of mask_in_range.
+void mask_in_range_scalar(std::span<std::uint64_t const> values,
+                          std::uint64_t min, std::uint64_t max,
+                          std::span<std::uint64_t> mask);
+
+/// Sets bit i of mask if values[i] & bits is not zero, and clears it
+/// otherwise. Bits past the values are cleared.
+void mask_any_bits(std::span<std::uint8_t const> values, std::uint8_t bits,
+                   std::span<std::uint64_t> mask);
+
+/// Portable implementation of mask_any_bits.
+void mask_any_bits_scalar(std::span<std::uint8_t const> values,
+                          std::uint8_t bits, std::span<std::uint64_t> mask);
+
+/// Name of the instruction set used by the kernels: `avx2`, `sse2` or
+/// `scalar`.
+std::string_view get_instruction_set();
+
+} // namespace grapher::simd
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <string>
+
+#include <fmt/core.h>
+
+#include <grapher/core.hpp>
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/intern.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// Sets the scalar fields nested in value into the last row of a table.
+/// Empty objects and arrays are stored as null, like json_t::flatten does.
+void set_fields(event_table_t &table, json_t const &value, std::string &path) {
+  std::size_t const path_size = path.size();
+
+  switch (value.type()) {
+  case json_t::value_t::object:
+    if (value.empty()) {
+      break;
+    }
+    for (auto const &[key, child] : value.items()) {
+      append_reference_token(path, key);
+      set_fields(table, child, path);
+      path.resize(path_size);
+    }
+    return;
+
+  case json_t::value_t::array:
+    if (value.empty()) {
+      break;
+    }
+    for (std::size_t i = 0; i < value.size(); i++) {
+      append_reference_token(path, std::to_string(i));
+      set_fields(table, value[i], path);
+      path.resize(path_size);
+    }
+    return;
+
+  default:
+    break;
+  }
+
+  table.set(event_field_t::resolve(path), event_value_t::from_json(value));
+}
+
+} // namespace
+
+// =============================================================================
+// event_value_t
+
+value_t event_value_t::get_value() const {
+  switch (kind) {
+  case unsigned_kind_v:
+    return bits;
+  case integer_kind_v:
+    return static_cast<value_t>(std::bit_cast<std::int64_t>(bits));
+  case float_kind_v:
+    return static_cast<value_t>(std::bit_cast<double>(bits));
+  default:
+    return 0;
+  }
+}
+
+json_t event_value_t::to_json() const {
+  switch (kind) {
+  case boolean_kind_v:
+    return bits != 0;
+  case unsigned_kind_v:
+    return json_t::number_unsigned_t{bits};
+  case integer_kind_v:
+    return std::bit_cast<json_t::number_integer_t>(bits);
+  case float_kind_v:
+    return std::bit_cast<json_t::number_float_t>(bits);
+  case string_kind_v:
+    return get_symbol_string(get_symbol());
+  default:
+    return nullptr;
+  }
+}
+
+event_value_t event_value_t::from_json(json_t const &value) {
+  switch (value.type()) {
+  case json_t::value_t::boolean:
+    return {.kind = boolean_kind_v, .bits = value.get<bool>() ? 1u : 0u};
+  case json_t::value_t::number_unsigned:
+    return {.kind = unsigned_kind_v,
+            .bits = value.get<json_t::number_unsigned_t>()};
+  case json_t::value_t::number_integer:
+    return {.kind = integer_kind_v,
+            .bits = std::bit_cast<std::uint64_t>(
+                value.get<json_t::number_integer_t>())};
+  case json_t::value_t::number_float:
+    return {.kind = float_kind_v,
+            .bits = std::bit_cast<std::uint64_t>(
+                value.get<json_t::number_float_t>())};
+  case json_t::value_t::string:
+    return {.kind = string_kind_v,
+            .bits = intern(value.get_ref<json_t::string_t const &>())};
+  default:
+    return {.kind = null_kind_v};
+  }
+}
+
+// =============================================================================
+// event_field_t
+
+event_field_t event_field_t::resolve(json_t::json_pointer const &pointer) {
+  return resolve(pointer.to_string());
+}
+
+event_field_t event_field_t::resolve(std::string_view pointer) {
+  auto const column_it = std::ranges::find(event_column_pointers, pointer);
+  return {.column = static_cast<event_column_t>(column_it -
+                                                event_column_pointers.begin()),
+          .key = intern(pointer)};
+}
+
+void append_reference_token(std::string &pointer, std::string_view key) {
+  pointer += '/';
+  for (char const character : key) {
+    if (character == '~') {
+      pointer += "~0";
+    } else if (character == '/') {
+      pointer += "~1";
+    } else {
+      pointer += character;
+    }
+  }
+}
+
+// =============================================================================
+// event_table_t
+
+event_value_t event_table_t::get(std::size_t row,
+                                 event_field_t const &field) const {
+  switch (field.column) {
+  case name_column_v:
+  case detail_column_v:
+    if (symbol_t const symbol =
+            (field.column == name_column_v ? names_ : details_)[row];
+        symbol != no_symbol_v) {
+      return {.kind = string_kind_v, .bits = symbol};
+    }
+    break;
+
+  case ts_column_v:
+  case dur_column_v:
+  case pid_column_v:
+  case tid_column_v:
+    if ((column_masks_[row] & get_column_bit(field.column)) != 0) {
+      return {.kind = unsigned_kind_v, .bits = column(field.column)[row]};
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  // Fallback to the args table
+  for (event_arg_t const &arg : get_args(row)) {
+    if (arg.key == field.key) {
+      return arg.value;
+    }
+  }
+  return {};
+}
+
+std::span<value_t const> event_table_t::column(event_column_t numeric_column) const {
+  switch (numeric_column) {
+  case ts_column_v:
+    return ts_;
+  case dur_column_v:
+    return dur_;
+  case pid_column_v:
+    return pid_;
+  case tid_column_v:
+    return tid_;
+  default:
+    check(false, fmt::format("Not a numeric column: {}.",
+                             static_cast<unsigned>(numeric_column)));
+    return {};
+  }
+}
+
+void event_table_t::push_row() {
+  names_.push_back(no_symbol_v);
+  details_.push_back(no_symbol_v);
+  ts_.push_back(0);
+  dur_.push_back(0);
+  pid_.push_back(0);
+  tid_.push_back(0);
+  column_masks_.push_back(0);
+  arg_offsets_.push_back(args_.size());
+}
+
+void event_table_t::set(event_field_t const &field,
+                        event_value_t const &value) {
+  switch (field.column) {
+  case name_column_v:
+  case detail_column_v:
+    if (value.is_string()) {
+      (field.column == name_column_v ? names_ : details_).back() =
+          value.get_symbol();
+      return;
+    }
+    break;
+
+  case ts_column_v:
+  case dur_column_v:
+  case pid_column_v:
+  case tid_column_v:
+    if (value.kind == unsigned_kind_v) {
+      std::array const numeric_columns = {&ts_, &dur_, &pid_, &tid_};
+      numeric_columns[field.column - ts_column_v]->back() = value.bits;
+      column_masks_.back() |= get_column_bit(field.column);
+      return;
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  args_.push_back({.key = field.key, .value = value});
+  arg_offsets_.back() = args_.size();
+}
+
+void event_table_t::pop_row() {
+  names_.pop_back();
+  details_.pop_back();
+  ts_.pop_back();
+  dur_.pop_back();
+  pid_.pop_back();
+  tid_.pop_back();
+  column_masks_.pop_back();
+  arg_offsets_.pop_back();
+  args_.resize(arg_offsets_.back());
+}
+
+void event_table_t::push_event(json_t const &event) {
+  push_row();
+
+  std::string path;
+  if (!event.empty()) {
+    set_fields(*this, event, path);
+  }
+}
+
+void event_table_t::push_event(event_table_t const &table, std::size_t row) {
+  names_.push_back(table.names_[row]);
+  details_.push_back(table.details_[row]);
+  ts_.push_back(table.ts_[row]);
+  dur_.push_back(table.dur_[row]);
+  pid_.push_back(table.pid_[row]);
+  tid_.push_back(table.tid_[row]);
+  column_masks_.push_back(table.column_masks_[row]);
+
+  std::span<event_arg_t const> const row_args = table.get_args(row);
+  args_.insert(args_.end(), row_args.begin(), row_args.end());
+  arg_offsets_.push_back(args_.size());
+}
+
+json_t event_table_t::get_event(std::size_t row) const {
+  json_t event = json_t::object();
+
+  for (std::size_t column_id = 0; column_id < event_column_pointers.size();
+       column_id++) {
+    event_value_t const value = get(
+        row, {.column = static_cast<event_column_t>(column_id),
+              .key = no_symbol_v});
+    if (value.is_present()) {
+      event[json_t::json_pointer(std::string(event_column_pointers[column_id]))] =
+          value.to_json();
+    }
+  }
+
+  for (event_arg_t const &arg : get_args(row)) {
+    event[json_t::json_pointer(get_symbol_string(arg.key))] =
+        arg.value.to_json();
+  }
+
+  return event;
+}
+
+} // namespace grapher
@@ -0,0 +1,34 @@
+#include <fmt/core.h>
+
+#include <grapher/event_store.hpp>
+#include <grapher/trace_cache.hpp>
+#include <grapher/utils/error.hpp>
+
+namespace grapher {
+
+event_store_t::event_store_t(
+    std::vector<std::filesystem::path> repetition_paths,
+    std::shared_ptr<trace_projection_t const> projection, bool use_trace_cache)
+    : repetition_count_(repetition_paths.size()),
+      entries_(std::make_unique<entry_t[]>(repetition_paths.size())),
+      projection_(std::move(projection)), use_trace_cache_(use_trace_cache) {
+  for (std::size_t i = 0; i < repetition_count_; i++) {
+    entries_[i].path = std::move(repetition_paths[i]);
+  }
+}
+
+event_table_t const &event_store_t::get(std::size_t repetition_id) const {
+  check(repetition_id < repetition_count_,
+        fmt::format("Repetition {} out of range (store size: {}).",
+                    repetition_id, repetition_count_));
+
+  entry_t &entry = entries_[repetition_id];
+  std::call_once(entry.parsed, [&]() {
+    entry.events = use_trace_cache_
+                       ? read_cached_trace_events(entry.path, *projection_)
+                       : read_trace_events(entry.path, *projection_);
+  });
+  return entry.events;
+}
+
+} // namespace grapher
@@ -0,0 +1,154 @@
+#include <fstream>
+#include <iterator>
+
+#include <unistd.h>
+
+#include <fmt/core.h>
+
+#include <grapher/manifest.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// Manifest format version, to be bumped on every format change, including
+/// changes in the partial aggregates of plotters
+constexpr std::uint64_t manifest_version = 2;
+
+/// Returns true if a serialized manifest entry has the expected fields.
+bool is_valid_entry(grapher::json_t const &entry) {
+  return entry.is_object() && entry.contains("path") &&
+         entry["path"].is_string() && entry.contains("size") &&
+         entry["size"].is_number_unsigned() && entry.contains("mtime") &&
+         entry["mtime"].is_number_integer() && entry.contains("hash") &&
+         entry["hash"].is_number_unsigned() && entry.contains("aggregate");
+}
+
+} // namespace
+
+std::filesystem::path get_manifest_path(std::filesystem::path const &dest) {
+  return dest / manifest_filename;
+}
+
+bool manifest_entry_t::matches(std::filesystem::path const &path,
+                               file_stamp_t const &current_stamp) const {
+  if (current_stamp.size != stamp.size) {
+    return false;
+  }
+  return current_stamp.mtime == stamp.mtime || hash_file(path) == hash;
+}
+
+results_manifest_t results_manifest_t::load(std::filesystem::path const &path,
+                                            grapher::json_t const &config) {
+  ZoneScoped;
+
+  results_manifest_t res(config);
+
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    return res;
+  }
+
+  grapher::json_t const manifest = grapher::json_t::from_cbor(
+      std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>(),
+      true, false);
+
+  if (manifest.is_discarded() || !manifest.is_object() ||
+      manifest.value("version", grapher::json_t{}) != manifest_version ||
+      manifest.value("config", grapher::json_t{}) != config ||
+      !manifest.contains("entries") || !manifest["entries"].is_array() ||
+      !manifest.contains("outputs") || !manifest["outputs"].is_object()) {
+    return res;
+  }
+
+  for (grapher::json_t const &entry : manifest["entries"]) {
+    // A single invalid entry invalidates the whole manifest
+    if (!is_valid_entry(entry)) {
+      res.entries_.clear();
+      return res;
+    }
+
+    res.entries_.insert_or_assign(
+        entry["path"].get<std::string>(),
+        manifest_entry_t{
+            .stamp = {.size = entry["size"].get<std::uint64_t>(),
+                      .mtime = entry["mtime"].get<std::int64_t>()},
+            .hash = entry["hash"].get<std::uint64_t>(),
+            .aggregate = entry["aggregate"]});
+  }
+  res.outputs_ = manifest["outputs"];
+
+  return res;
+}
+
+bool results_manifest_t::save(std::filesystem::path const &path) const {
+  ZoneScoped;
+
+  grapher::json_t::array_t entries;
+  entries.reserve(entries_.size());
+  for (auto const &[entry_path, entry] : entries_) {
+    entries.push_back({{"path", entry_path},
+                       {"size", entry.stamp.size},
+                       {"mtime", entry.stamp.mtime},
+                       {"hash", entry.hash},
+                       {"aggregate", entry.aggregate}});
+  }
+
+  grapher::json_t const manifest = {{"version", manifest_version},
+                                    {"config", config_},
+                                    {"entries", std::move(entries)},
+                                    {"outputs", outputs_}};
+  std::vector<std::uint8_t> const data = grapher::json_t::to_cbor(manifest);
+
+  // Writing to a temporary file first so an interrupted run never leaves a
+  // truncated manifest behind
+  std::filesystem::path temporary_path = path;
+  temporary_path += fmt::format(".{}.tmp", ::getpid());
+
+  {
+    std::ofstream output(temporary_path, std::ios::binary);
+    if (!output) {
+      return false;
+    }
+
+    output.write(reinterpret_cast<char const *>(data.data()),
+                 static_cast<std::streamsize>(data.size()));
+
+    if (!output) {
+      std::filesystem::remove(temporary_path);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, path, error);
+  return !error;
+}
+
+manifest_entry_t const *
+results_manifest_t::find(std::filesystem::path const &path) const {
+  auto const it = entries_.find(path.string());
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+void results_manifest_t::set(std::filesystem::path const &path,
+                             manifest_entry_t entry) {
+  entries_.insert_or_assign(path.string(), std::move(entry));
+}
+
+std::vector<manifest_entry_t>
+results_manifest_t::prune(std::unordered_set<std::string> const &paths) {
+  std::vector<manifest_entry_t> res;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (paths.contains(it->first)) {
+      ++it;
+      continue;
+    }
+    res.push_back(std::move(it->second));
+    it = entries_.erase(it);
+  }
+  return res;
+}
+
+} // namespace grapher
@@ -9,13 +9,12 @@
 
 #include <nlohmann/json.hpp>
 
-#include <sciplot/sciplot.hpp>
-
 #include <grapher/core.hpp>
 #include <grapher/plotters/compare.hpp>
 #include <grapher/predicates.hpp>
 #include <grapher/utils/error.hpp>
 #include <grapher/utils/json.hpp>
+#include <grapher/utils/plot.hpp>
 
 namespace grapher::plotters {
 
@@ -34,6 +33,15 @@ grapher::json_t plotter_compare_t::get_default_config() const {
   return res;
 }
 
+trace_projection_t
+plotter_compare_t::get_trace_projection(grapher::json_t const &config) const {
+  return get_descriptors_projection(
+      read_descriptors(
+          get_as_ref<json_t::array_t const &>(config, "group_descriptors")),
+      grapher::json_t::json_pointer{
+          get_as_ref<json_t::string_t const &>(config, "value_json_pointer")});
+}
+
 void plotter_compare_t::plot(benchmark_set_t const &bset,
                              std::filesystem::path const &dest,
                              grapher::json_t const &config) const {
@@ -48,31 +56,48 @@ void plotter_compare_t::plot(benchmark_set_t const &bset,
   std::vector<group_descriptor_t> group_descriptors = read_descriptors(
       get_as_ref<json_t::array_t const &>(config, "group_descriptors"));
 
+  // Sums of all the descriptors, computed in a single pass over the events of
+  // each instance. Indexed by benchmark, instance, descriptor and repetition.
+  descriptor_dispatcher_t const dispatcher(group_descriptors);
+  std::vector<std::vector<std::vector<std::vector<grapher::value_t>>>>
+      values_sums(bset.size());
+
+  for (std::size_t bench_id = 0; bench_id < bset.size(); bench_id++) {
+    for (benchmark_instance_t const &instance : bset[bench_id].instances) {
+      check(!instance.repetitions.empty(),
+            fmt::format("No data in benchmark {} for instance size {}.",
+                        bset[bench_id].name, instance.size),
+            error_level_t::warning_v);
+
+      values_sums[bench_id].push_back(
+          filtered_values_sums(instance, dispatcher, value_json_pointer));
+    }
+  }
+
   // Drawing
 
-  for (group_descriptor_t const &descriptor : group_descriptors) {
+  for (std::size_t descriptor_id = 0; descriptor_id < group_descriptors.size();
+       descriptor_id++) {
+    group_descriptor_t &descriptor = group_descriptors[descriptor_id];
+
     // Plot init
-    sciplot::Plot2D plot;
+    plot_t plot;
     apply_config(plot, config);
 
-    // Generating predicates
-    std::vector<predicate_t> predicates = get_predicates(descriptor);
+    for (std::size_t bench_id = 0; bench_id < bset.size(); bench_id++) {
+      benchmark_case_t const &bench = bset[bench_id];
 
-    for (benchmark_case_t const &bench : bset) {
       std::vector<grapher::value_t> x_points;
       std::vector<grapher::value_t> y_points;
 
       std::vector<grapher::value_t> x_average;
       std::vector<grapher::value_t> y_average;
 
-      for (benchmark_instance_t const &instance : bench.instances) {
-        check(!instance.repetitions.empty(),
-              fmt::format("No data in benchmark {} for instance size {}.",
-                          bench.name, instance.size),
-              error_level_t::warning_v);
-
-        std::vector<grapher::value_t> const values =
-            filtered_values_sums(instance, predicates, value_json_pointer);
+      for (std::size_t instance_id = 0; instance_id < bench.instances.size();
+           instance_id++) {
+        benchmark_instance_t const &instance = bench.instances[instance_id];
+        std::vector<grapher::value_t> const &values =
+            values_sums[bench_id][instance_id][descriptor_id];
 
         check(!values.empty(),
               fmt::format("No event in benchmark {} at size {} matched by "
@@ -97,17 +122,19 @@ void plotter_compare_t::plot(benchmark_set_t const &bset,
       }
 
       if (draw_points) {
-        plot.drawPoints(x_points, y_points).label(bench.name);
+        plot.draw_points({x_points.begin(), x_points.end()},
+                         {y_points.begin(), y_points.end()}, bench.name);
       }
 
       if (draw_average) {
-        plot.drawCurve(x_average, y_average).label(bench.name);
+        plot.draw_curve({x_average.begin(), x_average.end()},
+                        {y_average.begin(), y_average.end()}, bench.name);
       }
     }
 
     // Saving plot
     std::filesystem::create_directories(dest);
-    save_plot(plot, dest / std::move(descriptor.name), config);
+    save_plot(std::move(plot), dest / std::move(descriptor.name), config);
   }
 }
 
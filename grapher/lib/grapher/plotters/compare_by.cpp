@@ -1,24 +1,34 @@
 #include <algorithm>
+#include <array>
 #include <filesystem>
-#include <fstream>
 #include <numeric>
+#include <optional>
+#include <set>
+#include <span>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <fmt/core.h>
 
 #include <boost/container/small_vector.hpp>
 
-#include <boost/core/demangle.hpp>
-
-#include <sciplot/sciplot.hpp>
-
 #include <grapher/core.hpp>
+#include <grapher/event_store.hpp>
+#include <grapher/manifest.hpp>
 #include <grapher/plotters/compare_by.hpp>
+#include <grapher/plotters/curve_aggregate.hpp>
 #include <grapher/predicates.hpp>
+#include <grapher/utils/demangle.hpp>
 #include <grapher/utils/error.hpp>
+#include <grapher/utils/fingerprint.hpp>
+#include <grapher/utils/intern.hpp>
 #include <grapher/utils/json.hpp>
 #include <grapher/utils/math.hpp>
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/plot.hpp>
+#include <grapher/utils/render.hpp>
+#include <grapher/utils/simd.hpp>
 #include <grapher/utils/tracy.hpp>
 
 namespace grapher::plotters {
@@ -28,26 +38,34 @@ namespace grapher::plotters {
 
 // Plot-friendly data structures
 
-/// Value key type. Contains multiple values to group by a tuple of parameters
-using key_t = boost::container::small_vector<std::string, 4>;
+/// Feature -> Values of a single repetition. Partial aggregate recorded in
+/// results manifests.
+using repetition_aggregate_t = grapher::map_t<key_t, point_data_t>;
 
-/// Point aggregate (multiple Y coordinates)
-using point_data_t = std::vector<grapher::value_t>;
+/// Repetition of a benchmark instance. Unit of work for parallel ingestion.
+struct repetition_ref_t {
+  benchmark_case_t const &bench_case;
+  benchmark_instance_t const &instance;
+  std::size_t repetition_id;
+};
 
-/// Curve: X -> vec<Y>
-using benchmark_curve_t = grapher::map_t<std::size_t, point_data_t>;
+/// Manifest update for a repetition, computed during parallel ingestion.
+struct repetition_update_t {
+  /// New manifest entry, if the recorded one must be replaced
+  std::optional<manifest_entry_t> entry;
 
-/// Benchmark name -> Curve
-using curve_aggregate_t = grapher::map_t<std::string, benchmark_curve_t>;
+  /// True if the repetition was read again instead of reusing its aggregate
+  bool changed = false;
+};
 
-/// Feature -> Benchmark aggregate
-using curve_aggregate_map_t = grapher::map_t<key_t, curve_aggregate_t>;
+/// Number of keys monitored by the heavy-hitter sketch for each kept key when
+/// top_k is set
+constexpr std::size_t sketch_capacity_factor = 16;
 
 struct process_event_parameters_t {
-  std::vector<json_t::json_pointer> const &key_pointers;
+  std::vector<event_field_t> const &key_fields;
+  event_field_t const &value_field;
   json_t::json_pointer const &value_pointer;
-  benchmark_case_t const &bench_case;
-  benchmark_instance_t const &instance;
 };
 
 /// Set of X and Y coordinate vectors for all curves and points of a graph.
@@ -74,32 +92,45 @@ struct generate_plot_parameters_t {
   bool draw_points;
   bool draw_median;
   bool demangle;
+
+  /// Demangled key parts, filled before plots are generated
+  demangle_cache_t const *demangle_cache = nullptr;
   grapher::json_t const &plotter_config;
 };
 
 // =============================================================================
 // Forward declarations
 
-/// Generate a curve for a given time-trace event and stores it in output_map.
-inline void process_event(curve_aggregate_map_t &output_map,
-                          grapher::json_t const &event,
+/// Reads the value of a given time-trace event and stores it in output_map.
+inline void process_event(repetition_aggregate_t &output_map,
+                          event_table_t const &events, std::size_t row,
                           process_event_parameters_t const &parameters);
 
-/// Scans event data at value_pointer and generates curves for each key
-/// generated from key_pointers. The curves are stored in a nested map
-/// structure which is far from optimal but we're limited by gnuplot's
-/// performance anyway.
-curve_aggregate_map_t
-get_bench_curves(benchmark_set_t const &input,
-                 std::vector<json_t::json_pointer> const &key_pointers,
-                 json_t::json_pointer const &value_pointer,
-                 std::vector<predicate_t> filters = {});
+/// Aggregates the values of the events of a repetition that pass the filters.
+repetition_aggregate_t
+get_repetition_aggregate(event_table_t const &events,
+                         std::vector<predicate_t> const &filters,
+                         process_event_parameters_t const &parameters);
+
+/// Converts a repetition aggregate to JSON for results manifests.
+grapher::json_t to_json(repetition_aggregate_t const &aggregate);
 
-/// Transforms a key into a string that's usable as a path.
-std::string to_string(key_t const &key, bool demangle = true);
+/// Reads a repetition aggregate from a results manifest. Returns std::nullopt
+/// if it is invalid.
+std::optional<repetition_aggregate_t>
+read_repetition_aggregate(grapher::json_t const &aggregate_json);
+
+/// Adds the values of source to destination.
+inline void merge_aggregates(point_aggregate_t &destination,
+                             point_data_t const &source);
+
+/// Keeps the top_k keys with the highest totals among the ones whose total is
+/// at least min_total.
+void prune_keys(curve_aggregate_map_t &curve_aggregate_map,
+                key_pruning_parameters_t const &pruning);
 
 /// Draws the curves and points for a given benchmark.
-inline void draw_bench_curves(sciplot::Plot2D &plot,
+inline void draw_bench_curves(plot_t &plot,
                               coordinate_vectors_t const &coord_vectors,
                               std::string const &bench_name,
                               generate_plot_parameters_t const &parameters);
@@ -111,110 +142,444 @@ get_plotgen_parameters(grapher::json_t const &config,
 
 /// Function to generate one plot.
 /// NB: This function must remain free of config reading logic.
-inline void generate_plot(
-    curve_aggregate_map_t::const_iterator::value_type aggregate_key_value,
-    generate_plot_parameters_t const &parameters);
+inline void
+generate_plot(curve_aggregate_map_t::value_type const &aggregate_key_value,
+              generate_plot_parameters_t const &parameters);
+
+/// Generates the plots of the benchmark set. With a manifest, only the plots of
+/// the keys affected since the last run are generated.
+void plot_curves(benchmark_set_t const &bset,
+                 std::filesystem::path const &dest,
+                 grapher::json_t const &config,
+                 results_manifest_t *manifest);
 
 // =============================================================================
 // Function definitions
 
-inline void process_event(curve_aggregate_map_t &output_map,
-                          grapher::json_t const &event,
+inline void process_event(repetition_aggregate_t &output_map,
+                          event_table_t const &events, std::size_t row,
                           process_event_parameters_t const &parameters) {
-  // Building key from JSON pointers
+  // Building key from the key fields
   key_t key;
-  for (json_t::json_pointer const &key_ptr : parameters.key_pointers) {
-    if (event.contains(key_ptr) && event[key_ptr].is_string()) {
-      key.push_back(event[key_ptr]);
+  for (event_field_t const &key_field : parameters.key_fields) {
+    if (event_value_t const key_value = events.get(row, key_field);
+        key_value.is_string()) {
+      key.push_back(key_value.get_symbol());
+    }
+  }
+
+  event_value_t const value = events.get(row, parameters.value_field);
+
+  // Key/value presence and type checks. Events are only rebuilt as JSON to
+  // report invalid values.
+  if (!value.is_present()) {
+    warn(fmt::format("No value at {}: {}",
+                     parameters.value_pointer.to_string(),
+                     events.get_event(row).dump()),
+         info_v);
+    return;
+  }
+  if (!value.is_number()) {
+    warn(fmt::format("Value at {} is not an integer: {}",
+                     parameters.value_pointer.to_string(),
+                     events.get_event(row).dump()),
+         info_v);
+    return;
+  }
+
+  // Storing value
+  output_map[key].push_back(value.get_value());
+}
+
+repetition_aggregate_t
+get_repetition_aggregate(event_table_t const &events,
+                         std::vector<predicate_t> const &filters,
+                         process_event_parameters_t const &parameters) {
+  repetition_aggregate_t res;
+
+  // Filters are applied on batches of rows, producing masks of the events to
+  // process
+  std::array<std::uint64_t, predicate_t::batch_words> mask;
+  for (std::size_t begin = 0; begin < events.size();
+       begin += predicate_t::batch_size) {
+    std::size_t const count =
+        std::min(predicate_t::batch_size, events.size() - begin);
+    std::span<std::uint64_t> const batch_mask =
+        std::span(mask).first(simd::get_mask_word_count(count));
+
+    simd::fill_mask(batch_mask, count);
+    for (predicate_t const &predicate : filters) {
+      predicate.evaluate(events, begin, count, batch_mask);
+    }
+
+    // Event processing, ie. building the key and storing the value
+    simd::for_each_set_bit(batch_mask, [&](std::size_t row) {
+      process_event(res, events, begin + row, parameters);
+    });
+  }
+  return res;
+}
+
+grapher::json_t to_json(repetition_aggregate_t const &aggregate) {
+  // Keys are stored as strings since symbols are specific to a process
+  grapher::json_t res = grapher::json_t::array();
+  for (auto const &[key, values] : aggregate) {
+    grapher::json_t key_json = grapher::json_t::array();
+    for (grapher::symbol_t const part : key) {
+      key_json.push_back(get_symbol_string(part));
+    }
+    res.push_back(grapher::json_t::array({std::move(key_json), values}));
+  }
+  return res;
+}
+
+std::optional<repetition_aggregate_t>
+read_repetition_aggregate(grapher::json_t const &aggregate_json) {
+  if (!aggregate_json.is_array()) {
+    return std::nullopt;
+  }
+
+  repetition_aggregate_t res;
+  for (grapher::json_t const &item : aggregate_json) {
+    if (!item.is_array() || item.size() != 2 || !item[0].is_array() ||
+        !item[1].is_array()) {
+      return std::nullopt;
+    }
+
+    key_t key;
+    for (grapher::json_t const &part : item[0]) {
+      if (!part.is_string()) {
+        return std::nullopt;
+      }
+      key.push_back(intern(part.get_ref<grapher::json_t::string_t const &>()));
+    }
+
+    point_data_t &values = res[key];
+    for (grapher::json_t const &value : item[1]) {
+      if (!value.is_number_unsigned()) {
+        return std::nullopt;
+      }
+      values.push_back(value.get<grapher::value_t>());
+    }
+  }
+  return res;
+}
+
+inline void merge_aggregates(point_aggregate_t &destination,
+                             point_data_t const &source) {
+  for (grapher::value_t const value : source) {
+    destination.push(value);
+  }
+}
+
+void prune_keys(curve_aggregate_map_t &curve_aggregate_map,
+                key_pruning_parameters_t const &pruning) {
+  ZoneScoped;
+
+  // Totals over all benchmarks and sizes
+  std::vector<std::pair<double, key_t>> totals;
+  for (auto const &[key, curve_aggregate] : curve_aggregate_map) {
+    double total = 0;
+    for (auto const &[bench_name, benchmark_curve] : curve_aggregate) {
+      for (auto const &[size, point_aggregate] : benchmark_curve) {
+        total += point_aggregate.sum();
+      }
+    }
+    if (total >= pruning.min_total) {
+      totals.emplace_back(total, key);
     }
   }
 
-  // Key/value presence and type checks
-  if (check(event.contains(parameters.value_pointer),
-            fmt::format("No value at {}: {}",
-                        parameters.value_pointer.to_string(), event.dump()),
-            info_v) &&
-      check(event[parameters.value_pointer].is_number(),
-            fmt::format("Value at {} is not an integer: {}",
-                        parameters.value_pointer.to_string(), event.dump()),
-            info_v)) {
-    // Storing value
-    output_map[key][parameters.bench_case.name][parameters.instance.size]
-        .push_back(event[parameters.value_pointer]);
+  // Heaviest keys first, ties are broken by key strings so the kept keys
+  // don't depend on symbol order
+  std::ranges::sort(totals, [](auto const &a, auto const &b) -> bool {
+    return a.first != b.first ? a.first > b.first
+                              : key_string_less_t{}(a.second, b.second);
+  });
+  if (pruning.top_k != 0 && totals.size() > pruning.top_k) {
+    totals.resize(pruning.top_k);
+  }
+
+  key_set_t kept_keys;
+  for (auto &[total, key] : totals) {
+    kept_keys.insert(std::move(key));
   }
+
+  curve_aggregate_map_t pruned_map;
+  pruned_map.reserve(kept_keys.size());
+  for (auto &[key, curve_aggregate] : curve_aggregate_map) {
+    if (kept_keys.contains(key)) {
+      pruned_map.emplace_hint(pruned_map.end(), key,
+                              std::move(curve_aggregate));
+    }
+  }
+  curve_aggregate_map = std::move(pruned_map);
 }
 
 curve_aggregate_map_t
 get_bench_curves(benchmark_set_t const &input,
                  std::vector<json_t::json_pointer> const &key_pointers,
                  json_t::json_pointer const &value_pointer,
-                 std::vector<predicate_t> filters) {
+                 std::vector<predicate_t> filters, bool keep_samples,
+                 results_manifest_t *manifest, key_set_t *affected_keys,
+                 key_pruning_parameters_t const &pruning) {
   ZoneScoped;
-  namespace fs = std::filesystem;
 
-  curve_aggregate_map_t res;
-
-  // Unfolding the benchmark set data structure
+  // Unfolding the benchmark set data structure into a list of repetitions
+  std::vector<repetition_ref_t> repetitions;
   for (benchmark_case_t const &bench_case : input) {
     for (benchmark_instance_t const &instance : bench_case.instances) {
-      for (fs::path const &repetition : instance.repetitions) {
-        // JSON file extraction
-        grapher::json_t repetition_json;
-        {
-          std::ifstream repetition_ifstream(repetition);
-          repetition_ifstream >> repetition_json;
+      check(instance.events != nullptr,
+            fmt::format("No event store for benchmark {} at size {}.",
+                        bench_case.name, instance.size));
+
+      for (std::size_t repetition_id = 0;
+           repetition_id < instance.events->size(); repetition_id++) {
+        repetitions.push_back({.bench_case = bench_case,
+                               .instance = instance,
+                               .repetition_id = repetition_id});
+      }
+    }
+  }
+
+  // Fields are resolved once for all the repetitions
+  std::vector<event_field_t> key_fields;
+  std::ranges::transform(
+      key_pointers, std::back_inserter(key_fields),
+      [](json_t::json_pointer const &pointer) -> event_field_t {
+        return event_field_t::resolve(pointer);
+      });
+  event_field_t const value_field = event_field_t::resolve(value_pointer);
+
+  process_event_parameters_t const parameters{.key_fields = key_fields,
+                                              .value_field = value_field,
+                                              .value_pointer = value_pointer};
+
+  // Repetitions are aggregated concurrently in batches. Batch aggregates are
+  // passed to consume in repetition order afterwards so values end up in the
+  // same order as with a serial traversal, and raw values of only one batch
+  // are kept in memory at once.
+  constexpr std::size_t repetitions_per_job = 64;
+  std::size_t const batch_size =
+      std::size_t{get_job_count()} * repetitions_per_job;
+
+  auto for_each_aggregate = [&](auto &&consume) {
+    std::vector<repetition_aggregate_t> aggregates;
+    std::vector<repetition_update_t> updates;
+
+    // Manifest update, collecting the keys affected by changes along the way
+    std::unordered_set<std::string> paths;
+
+    auto insert_keys = [&](repetition_aggregate_t const &aggregate) {
+      if (affected_keys != nullptr) {
+        for (auto const &[key, values] : aggregate) {
+          affected_keys->insert(key);
+        }
+      }
+    };
+
+    auto insert_recorded_keys = [&](manifest_entry_t const *entry) {
+      if (entry == nullptr) {
+        return;
+      }
+      if (std::optional<repetition_aggregate_t> const aggregate =
+              read_repetition_aggregate(entry->aggregate)) {
+        insert_keys(*aggregate);
+      }
+    };
+
+    for (std::size_t batch_begin = 0; batch_begin < repetitions.size();
+         batch_begin += batch_size) {
+      std::size_t const batch_end =
+          std::min(batch_begin + batch_size, repetitions.size());
+
+      aggregates.assign(batch_end - batch_begin, {});
+      updates.assign(manifest ? batch_end - batch_begin : 0, {});
+
+      parallel_for(batch_end - batch_begin, [&](std::size_t i) {
+        auto const &[bench_case, instance, repetition_id] =
+            repetitions[batch_begin + i];
+
+        if (manifest == nullptr) {
+          aggregates[i] = get_repetition_aggregate(
+              instance.events->get(repetition_id), filters, parameters);
+          return;
         }
 
-        // Time-trace event reading
-        for (grapher::json_t const &current_event :
-             get_as_ref<json_t::array_t const &>(repetition_json,
-                                                 "traceEvents")) {
-          // Applying filter
-          if (std::ranges::all_of(
-                  filters,
-                  [&current_event](predicate_t const &predicate) -> bool {
-                    return predicate(current_event);
-                  })) {
-            // Event processing, ie. building the key and storing the value in
-            // the imbricated map data structure
-            process_event(res, current_event,
-                          {.key_pointers = key_pointers,
-                           .value_pointer = value_pointer,
-                           .bench_case = bench_case,
-                           .instance = instance});
+        std::filesystem::path const &path =
+            instance.repetitions[repetition_id];
+        std::optional<file_stamp_t> const stamp = get_file_stamp(path);
+
+        // Unchanged repetitions are not read again
+        if (manifest_entry_t const *entry = manifest->find(path);
+            entry != nullptr && stamp && entry->matches(path, *stamp)) {
+          if (std::optional<repetition_aggregate_t> aggregate =
+                  read_repetition_aggregate(entry->aggregate)) {
+            aggregates[i] = std::move(*aggregate);
+
+            // Refreshing the stamp avoids hashing the file again on the next
+            // run
+            if (entry->stamp != *stamp) {
+              updates[i].entry =
+                  manifest_entry_t{.stamp = *stamp,
+                                   .hash = entry->hash,
+                                   .aggregate = entry->aggregate};
+            }
+            return;
           }
         }
+
+        // Hashing before reading so changes made in the meantime are detected
+        // on the next run
+        std::optional<std::uint64_t> const hash = hash_file(path);
+
+        aggregates[i] = get_repetition_aggregate(
+            instance.events->get(repetition_id), filters, parameters);
+        updates[i].changed = true;
+
+        if (stamp && hash) {
+          updates[i].entry = manifest_entry_t{.stamp = *stamp,
+                                              .hash = *hash,
+                                              .aggregate =
+                                                  to_json(aggregates[i])};
+        }
+      });
+
+      for (std::size_t i = 0; i < aggregates.size(); i++) {
+        repetition_ref_t const &repetition = repetitions[batch_begin + i];
+
+        if (manifest != nullptr) {
+          std::filesystem::path const &path =
+              repetition.instance.repetitions[repetition.repetition_id];
+          paths.insert(path.string());
+
+          if (updates[i].changed) {
+            insert_recorded_keys(manifest->find(path));
+            insert_keys(aggregates[i]);
+          }
+
+          if (updates[i].entry) {
+            manifest->set(path, std::move(*updates[i].entry));
+          }
+        }
+
+        consume(repetition, aggregates[i]);
+      }
+    }
+
+    // Keys of removed repetitions are affected as well
+    if (manifest != nullptr) {
+      for (manifest_entry_t const &removed_entry : manifest->prune(paths)) {
+        insert_recorded_keys(&removed_entry);
+      }
+    }
+  };
+
+  curve_aggregate_map_t res;
+
+  auto merge_key = [&](repetition_ref_t const &repetition, key_t const &key,
+                       point_data_t const &values) {
+    merge_aggregates(res[key][repetition.bench_case.name]
+                         .try_emplace(repetition.instance.size, keep_samples)
+                         .first->second,
+                     values);
+  };
+
+  // Without top_k, keys are selected with their exact totals once every key
+  // is aggregated
+  if (pruning.top_k == 0) {
+    for_each_aggregate([&](repetition_ref_t const &repetition,
+                           repetition_aggregate_t const &aggregate) {
+      for (auto const &[key, values] : aggregate) {
+        merge_key(repetition, key, values);
       }
+    });
+    if (pruning.is_enabled()) {
+      prune_keys(res, pruning);
     }
+    return res;
   }
 
+  // With top_k, a heavy-hitter sketch monitors a bounded number of keys in a
+  // single pass. Only monitored keys are aggregated, and the aggregates of the
+  // keys it evicts are dropped so cold keys don't pile up.
+  math::heavy_hitters_t<key_t, key_string_less_t> sketch(
+      pruning.top_k * sketch_capacity_factor);
+  key_set_t evicted_keys;
+
+  // Sketch results depend on the order in which keys are pushed, so keys of a
+  // repetition are pushed in string order rather than symbol order
+  std::vector<repetition_aggregate_t::value_type const *> sorted_entries;
+  for_each_aggregate([&](repetition_ref_t const &repetition,
+                         repetition_aggregate_t const &aggregate) {
+    sorted_entries.clear();
+    for (auto const &entry : aggregate) {
+      sorted_entries.push_back(&entry);
+    }
+    std::ranges::sort(sorted_entries, key_string_less_t{},
+                      [](auto const *entry) -> key_t const & {
+                        return entry->first;
+                      });
+
+    for (auto const *entry : sorted_entries) {
+      if (std::optional<key_t> evicted_key = sketch.push(
+              entry->first, double(std::reduce(entry->second.begin(),
+                                               entry->second.end(),
+                                               grapher::value_t{0})))) {
+        res.erase(*evicted_key);
+        evicted_keys.insert(std::move(*evicted_key));
+      }
+      merge_key(repetition, entry->first, entry->second);
+    }
+  });
+
+  // Monitored keys are ranked with their aggregated totals
+  prune_keys(res, pruning);
+
+  // Kept keys that were evicted at some point miss the values seen before
+  for (auto const &[key, curve_aggregate] : res) {
+    check(!evicted_keys.contains(key),
+          fmt::format("Key {} was evicted from the top_k sketch before being "
+                      "kept, its plot misses some values. Increase top_k to "
+                      "monitor more keys.",
+                      to_string(key)),
+          warning_v);
+  }
   return res;
 }
 
-inline std::string to_string(key_t const &key, bool demangle) {
+bool key_string_less_t::operator()(key_t const &a, key_t const &b) const {
+  return std::ranges::lexicographical_compare(
+      a, b, [](grapher::symbol_t lhs, grapher::symbol_t rhs) {
+        if (lhs == no_symbol_v || rhs == no_symbol_v) {
+          return lhs == no_symbol_v && rhs != no_symbol_v;
+        }
+        return symbol_string_less_t{}(lhs, rhs);
+      });
+}
+
+std::string to_string(key_t const &key,
+                      demangle_cache_t const *demangle_cache) {
   if (key.empty()) {
     return "empty";
   }
 
+  auto get_part = [&](grapher::symbol_t part_symbol) -> std::string const & {
+    return demangle_cache != nullptr ? demangle_cache->get(part_symbol)
+                                     : get_symbol_string(part_symbol);
+  };
+
   // Gets head
-  std::string result(
-      demangle ? boost::core::scoped_demangled_name(key[0].c_str()).get()
-               : key[0]);
+  std::string result(get_part(key[0]));
 
   // Concatenate the rest
-  std::for_each(
-      key.begin() + 1, key.end(), [&](std::string const &mangled_part) {
-        result += '/';
-
-        std::string part(
-            demangle
-                ? boost::core::scoped_demangled_name(mangled_part.c_str()).get()
-                : mangled_part);
-
-        for (char const name_character : part) {
-          result += name_character == '/' ? '_' : name_character;
-        }
-      });
+  std::for_each(key.begin() + 1, key.end(),
+                [&](grapher::symbol_t part_symbol) {
+                  result += '/';
+                  for (char const name_character : get_part(part_symbol)) {
+                    result += name_character == '/' ? '_' : name_character;
+                  }
+                });
 
   return result;
 }
@@ -247,6 +612,8 @@ grapher::json_t plotter_compare_by_t::get_default_config() const {
   res["draw_points"] = true;
   res["draw_median"] = true;
   res["demangle"] = true;
+  res["top_k"] = 0;
+  res["min_total_dur"] = 0;
 
   // Simple default filter as an example
   res["filters"] = json_t::array({grapher::json_t{
@@ -258,44 +625,48 @@ grapher::json_t plotter_compare_by_t::get_default_config() const {
   return res;
 }
 
-inline void draw_bench_curves(sciplot::Plot2D &plot,
+inline void draw_bench_curves(plot_t &plot,
                               coordinate_vectors_t const &coord_vectors,
                               std::string const &bench_name,
                               generate_plot_parameters_t const &parameters) {
+  std::vector<double> const x_curve(coord_vectors.x_curve.begin(),
+                                    coord_vectors.x_curve.end());
+
   // Draw average curve
   if (parameters.draw_average) {
     if (parameters.average_error_bars) {
-      plot.drawCurveWithErrorBarsY(coord_vectors.x_curve,
-                                   coord_vectors.y_average_curve,
-                                   coord_vectors.y_delta_curve)
-          .label(bench_name + " avg + stddev");
+      plot.draw_curve_with_error_bars_y(
+          x_curve, coord_vectors.y_average_curve, coord_vectors.y_delta_curve,
+          bench_name + " avg + stddev");
     } else {
-      plot.drawCurve(coord_vectors.x_curve, coord_vectors.y_average_curve)
-          .label(bench_name + " average");
+      plot.draw_curve(x_curve, coord_vectors.y_average_curve,
+                      bench_name + " average");
     }
   }
 
   // Draw median curve
   if (parameters.draw_median) {
-    plot.drawCurve(coord_vectors.x_curve, coord_vectors.y_median_curve)
-        .label(bench_name + " median");
+    plot.draw_curve(x_curve, coord_vectors.y_median_curve,
+                    bench_name + " median");
   }
 
   // Draw points
   if (parameters.draw_points) {
-    plot.drawPoints(coord_vectors.x_points, coord_vectors.y_points)
-        .label(bench_name + " points");
+    plot.draw_points(
+        {coord_vectors.x_points.begin(), coord_vectors.x_points.end()},
+        {coord_vectors.y_points.begin(), coord_vectors.y_points.end()},
+        bench_name + " points");
   }
 }
 
-inline void generate_plot(
-    curve_aggregate_map_t::const_iterator::value_type aggregate_key_value,
-    generate_plot_parameters_t const &parameters) {
+inline void
+generate_plot(curve_aggregate_map_t::value_type const &aggregate_key_value,
+              generate_plot_parameters_t const &parameters) {
   ZoneScoped; // Used for profiling with Tracy
 
   auto const &[key, curve_aggregate] = aggregate_key_value;
 
-  sciplot::Plot2D plot;
+  plot_t plot;
 
   // Plot init
   for (auto const &[bench_name, benchmark_curve] : curve_aggregate) {
@@ -307,18 +678,18 @@ inline void generate_plot(
 
       // Building average curve Y vector
       if (parameters.draw_average && !y_values.empty()) {
-        curves.y_average_curve.push_back(math::average(y_values));
-        curves.y_delta_curve.push_back(math::stddev(y_values));
+        curves.y_average_curve.push_back(y_values.average());
+        curves.y_delta_curve.push_back(y_values.stddev());
       }
 
       // Building median curve Y vector
       if (parameters.draw_median && !y_values.empty()) {
-        curves.y_median_curve.push_back(math::median(y_values));
+        curves.y_median_curve.push_back(y_values.median());
       }
 
       // Building point XY vectors
       if (parameters.draw_points) {
-        for (grapher::value_t y_value : y_values) {
+        for (grapher::value_t y_value : y_values.samples()) {
           curves.x_points.push_back(x_value);
           curves.y_points.push_back(y_value);
         }
@@ -329,16 +700,69 @@ inline void generate_plot(
     draw_bench_curves(plot, curves, bench_name, parameters);
   }
 
-  plot.legend().atBottom();
+  plot.legend_position = legend_bottom_v;
   save_plot(std::move(plot),
-            parameters.plot_output_folder / to_string(key, parameters.demangle),
+            parameters.plot_output_folder /
+                to_string(key, parameters.demangle_cache),
             parameters.plotter_config);
 }
 
-void plotter_compare_by_t::plot(benchmark_set_t const &bset,
-                                std::filesystem::path const &dest,
-                                grapher::json_t const &config) const {
-  ZoneScoped;
+std::vector<json_t::json_pointer>
+get_key_pointers(grapher::json_t const &config) {
+  std::vector<json_t::json_pointer> key_json_pointers;
+
+  // The default value is a pair of pointers to the name
+  // and the details field of a timer event.
+  std::vector<json_t::string_t> key_json_pointer_strings =
+      config.value("key_ptrs", json_t::array({"/name", "/args/detail"}));
+
+  // Converting the strings to JSON pointer objects
+  std::transform(key_json_pointer_strings.begin(),
+                 key_json_pointer_strings.end(),
+                 std::back_inserter(key_json_pointers),
+                 [](std::string &pointer) -> json_t::json_pointer {
+                   return json_t::json_pointer{std::move(pointer)};
+                 });
+
+  return key_json_pointers;
+}
+
+grapher::json_t::array_t get_filters(grapher::json_t const &config) {
+  if (config.contains("filters") && config["filters"].is_array()) {
+    return grapher::get_as_ref<grapher::json_t::array_t const &>(config,
+                                                                 "filters");
+  }
+  return {};
+}
+
+key_pruning_parameters_t
+get_key_pruning_parameters(grapher::json_t const &config) {
+  return {.top_k = config.value("top_k", std::size_t{0}),
+          .min_total = config.value("min_total_dur", 0.)};
+}
+
+trace_projection_t plotter_compare_by_t::get_trace_projection(
+    grapher::json_t const &config) const {
+  trace_projection_t res{.keep_all_fields = false,
+                         .pointers = get_key_pointers(config)};
+
+  res.pointers.emplace_back(config.value("value_ptr", "/dur"));
+
+  // Events that are filtered out are dropped while reading trace files
+  std::vector<predicate_t> filters;
+  for (grapher::json_t const &filter : get_filters(config)) {
+    std::ranges::move(get_predicate_pointers(filter),
+                      std::back_inserter(res.pointers));
+    filters.push_back(get_predicate(filter));
+  }
+  res.filters.push_back(std::move(filters));
+
+  return res;
+}
+
+void plot_curves(benchmark_set_t const &bset,
+                 std::filesystem::path const &dest,
+                 grapher::json_t const &config, results_manifest_t *manifest) {
   namespace fs = std::filesystem;
 
   // Config reading
@@ -349,47 +773,117 @@ void plotter_compare_by_t::plot(benchmark_set_t const &bset,
   json_t::json_pointer value_ptr(config.value("value_ptr", "/dur"));
 
   // Key JSON pointers extraction
-  std::vector<json_t::json_pointer> key_json_pointers;
-
-  {
-    // The default value is a pair of pointers to the name
-    // and the details field of a timer event.
-    std::vector<json_t::string_t> key_json_pointer_strings =
-        config.value("key_ptrs", json_t::array({"/name", "/args/detail"}));
-
-    // Converting the strings to JSON pointer objects
-    std::transform(key_json_pointer_strings.begin(),
-                   key_json_pointer_strings.end(),
-                   std::back_inserter(key_json_pointers),
-                   [](std::string &pointer) -> json_t::json_pointer {
-                     return json_t::json_pointer{std::move(pointer)};
-                   });
-  }
+  std::vector<json_t::json_pointer> key_json_pointers =
+      get_key_pointers(config);
 
   // Predicate extraction
   std::vector<predicate_t> filters;
-
-  if (config.contains("filters") && config["filters"].is_array()) {
-    grapher::json_t::array_t const &filter_json_array =
-        grapher::get_as_ref<grapher::json_t::array_t const &>(config,
-                                                              "filters");
+  {
+    grapher::json_t::array_t const filter_json_array = get_filters(config);
     filters.reserve(filter_json_array.size());
     std::ranges::transform(filter_json_array, std::back_inserter(filters),
                            &get_predicate);
   }
 
+  key_pruning_parameters_t const pruning = get_key_pruning_parameters(config);
+
+  // Every plot is generated when nothing was recorded by a previous run. Kept
+  // keys may change whenever a repetition changes, so their plots are all
+  // generated again when keys are pruned.
+  bool const plot_all_keys =
+      manifest == nullptr || manifest->empty() || pruning.is_enabled();
+  key_set_t affected_keys;
+
   // Wrangling happens there
-  curve_aggregate_map_t curve_aggregate_map =
-      get_bench_curves(bset, key_json_pointers, value_ptr, filters);
+  curve_aggregate_map_t curve_aggregate_map = get_bench_curves(
+      bset, key_json_pointers, value_ptr, filters,
+      plotgen_parameters.draw_points, manifest, &affected_keys, pruning);
+
+  // Plots written by the previous run, recorded in the manifest as the paths
+  // of their files without extension and indexed by key. Keys without a
+  // recorded plot are plotted again.
+  grapher::json_t const no_plots = grapher::json_t::object();
+  grapher::json_t const &previous_plots =
+      manifest != nullptr ? manifest->get_outputs() : no_plots;
+  grapher::json_t plots = grapher::json_t::object();
+
+  std::vector<curve_aggregate_map_t::value_type const *> plotted_aggregates;
+  for (auto const &aggregate_key_value : curve_aggregate_map) {
+    key_t const &key = aggregate_key_value.first;
+    if (plot_all_keys || affected_keys.contains(key)) {
+      plotted_aggregates.push_back(&aggregate_key_value);
+      continue;
+    }
+
+    std::string key_string = to_string(key, nullptr);
+    if (auto const it = previous_plots.find(key_string);
+        it != previous_plots.end()) {
+      plots[std::move(key_string)] = *it;
+    } else {
+      plotted_aggregates.push_back(&aggregate_key_value);
+    }
+  }
+
+  // Key parts are demangled once and in parallel before drawing
+  demangle_cache_t demangle_cache;
+  if (plotgen_parameters.demangle) {
+    std::vector<grapher::symbol_t> key_parts;
+    for (auto const *aggregate_key_value : plotted_aggregates) {
+      key_parts.insert(key_parts.end(), aggregate_key_value->first.begin(),
+                       aggregate_key_value->first.end());
+    }
+    demangle_cache.insert(key_parts);
+    plotgen_parameters.demangle_cache = &demangle_cache;
+  }
 
   // Ensure the destination folder exists
   fs::create_directories(dest);
 
-  // Drawing, ie. unwrapping the nested maps and drawing curves + saving plots
-  std::for_each(curve_aggregate_map.begin(), curve_aggregate_map.end(),
-                [&](auto const &aggregate_key_value) {
-                  generate_plot(aggregate_key_value, plotgen_parameters);
-                });
+  // Drawing, ie. unwrapping the nested maps and drawing curves + saving plots.
+  // Plots are independent and rendered concurrently.
+  render_parallel(plotted_aggregates.size(), [&](std::size_t i) {
+    generate_plot(*plotted_aggregates[i], plotgen_parameters);
+  });
+
+  if (manifest == nullptr) {
+    return;
+  }
+
+  for (auto const *aggregate_key_value : plotted_aggregates) {
+    key_t const &key = aggregate_key_value->first;
+    plots[to_string(key, nullptr)] =
+        to_string(key, plotgen_parameters.demangle_cache);
+  }
+
+  // Plots of keys that are gone are removed so they don't get mixed up with
+  // the current ones
+  std::vector<std::string> const plot_file_extensions = config.value(
+      "plot_file_extensions", grapher::json_t::array({".svg", ".png"}));
+  for (auto const &[key_string, plot_path] : previous_plots.items()) {
+    if (plots.contains(key_string) || !plot_path.is_string()) {
+      continue;
+    }
+    for (std::string const &extension : plot_file_extensions) {
+      std::error_code error;
+      fs::remove(dest / (plot_path.get<std::string>() + extension), error);
+    }
+  }
+
+  manifest->set_outputs(std::move(plots));
+}
+
+void plotter_compare_by_t::plot(benchmark_set_t const &bset,
+                                std::filesystem::path const &dest,
+                                grapher::json_t const &config) const {
+  ZoneScoped;
+  plot_curves(bset, dest, config, nullptr);
+}
+
+void plotter_compare_by_t::plot_incremental(
+    benchmark_set_t const &bset, std::filesystem::path const &dest,
+    grapher::json_t const &config, results_manifest_t &manifest) const {
+  ZoneScoped;
+  plot_curves(bset, dest, config, &manifest);
 }
 
 } // namespace grapher::plotters
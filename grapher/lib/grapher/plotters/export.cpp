@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <grapher/core.hpp>
+#include <grapher/event_store.hpp>
+#include <grapher/plotters/curve_aggregate.hpp>
+#include <grapher/plotters/export.hpp>
+#include <grapher/predicates.hpp>
+#include <grapher/utils/columnar.hpp>
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/intern.hpp>
+#include <grapher/utils/json.hpp>
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/simd.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher::plotters {
+
+namespace {
+
+/// Event value and its key, with no_symbol_v for missing key parts
+struct key_value_t {
+  key_t key;
+  grapher::value_t value;
+};
+
+/// Repetition of a benchmark instance. Unit of work for parallel export.
+struct repetition_ref_t {
+  benchmark_case_t const &bench_case;
+  benchmark_instance_t const &instance;
+  std::size_t repetition_id;
+};
+
+/// Number of repetitions read by each job between two writes, bounding the
+/// number of rows held in memory
+constexpr std::size_t repetitions_per_job = 64;
+
+/// Number of leading columns: benchmark name, size, and repetition
+constexpr std::size_t instance_column_count = 3;
+
+/// Appends a CSV field to a row, quoting it if needed.
+void append_csv_field(std::string &row, std::string_view field) {
+  if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+    row += field;
+    return;
+  }
+
+  row += '"';
+  for (char const c : field) {
+    if (c == '"') {
+      row += '"';
+    }
+    row += c;
+  }
+  row += '"';
+}
+
+/// Streams rows to the output formats enabled in the config.
+class table_writer_t {
+public:
+  table_writer_t(std::filesystem::path const &dest,
+                 grapher::json_t const &config,
+                 std::vector<column_schema_t> schema)
+      : schema_(std::move(schema)) {
+    std::vector<std::string> const extensions = config.value(
+        "file_extensions", std::vector<std::string>{".csv", ".ctcol"});
+
+    std::filesystem::create_directories(dest);
+    for (std::string const &extension : extensions) {
+      std::filesystem::path const path = dest / ("values" + extension);
+
+      if (extension == ".csv") {
+        csv_.emplace(path, std::ios::binary);
+        if (!check(csv_->is_open(),
+                   fmt::format("Could not open {}.", path.string()),
+                   warning_v)) {
+          csv_.reset();
+          continue;
+        }
+
+        std::string header;
+        for (column_schema_t const &column : schema_) {
+          if (!header.empty()) {
+            header += ',';
+          }
+          append_csv_field(header, column.name);
+        }
+        *csv_ << header << '\n';
+      } else if (extension == ".ctcol") {
+        columnar_.emplace(path, schema_);
+        if (!check(columnar_->is_open(),
+                   fmt::format("Could not open {}.", path.string()),
+                   warning_v)) {
+          columnar_.reset();
+        }
+      } else {
+        warn(fmt::format("Unknown export file extension: {}.", extension));
+      }
+    }
+  }
+
+  /// Appends a row. Values of string columns are interned string symbols.
+  void append_row(std::span<std::uint64_t const> values) {
+    if (columnar_) {
+      columnar_->append_row(values);
+    }
+    if (!csv_) {
+      return;
+    }
+
+    row_.clear();
+    for (std::size_t column_id = 0; column_id < schema_.size(); column_id++) {
+      if (column_id != 0) {
+        row_ += ',';
+      }
+      std::uint64_t const value = values[column_id];
+      if (schema_[column_id].type == unsigned_column_v) {
+        fmt::format_to(std::back_inserter(row_), "{}", value);
+      } else if (value != no_symbol_v) {
+        append_csv_field(row_,
+                         get_symbol_string(static_cast<symbol_t>(value)));
+      }
+    }
+    row_ += '\n';
+    csv_->write(row_.data(), std::streamsize(row_.size()));
+  }
+
+  /// Flushes the output files.
+  void close(std::filesystem::path const &dest) {
+    if (csv_) {
+      csv_->close();
+      check(!csv_->fail(),
+            fmt::format("Could not write {}.", (dest / "values.csv").string()),
+            warning_v);
+    }
+    if (columnar_) {
+      check(columnar_->close(),
+            fmt::format("Could not write {}.",
+                        (dest / "values.ctcol").string()),
+            warning_v);
+    }
+  }
+
+private:
+  std::vector<column_schema_t> schema_;
+  std::optional<std::ofstream> csv_;
+  std::optional<columnar_writer_t> columnar_;
+
+  /// CSV row buffer
+  std::string row_;
+};
+
+/// Returns the leading columns of every row.
+std::vector<column_schema_t> get_instance_columns() {
+  return {{.name = "benchmark", .type = string_column_v},
+          {.name = "size", .type = unsigned_column_v},
+          {.name = "repetition", .type = unsigned_column_v}};
+}
+
+/// Reads the keys and values of the events of a repetition that pass the
+/// filters, and returns the sum of the values of each key, sorted by key.
+std::vector<key_value_t>
+get_key_sums(event_table_t const &events,
+               std::vector<predicate_t> const &filters,
+               std::vector<event_field_t> const &key_fields,
+               event_field_t const &value_field) {
+  std::vector<key_value_t> res;
+
+  std::array<std::uint64_t, predicate_t::batch_words> mask;
+  for (std::size_t begin = 0; begin < events.size();
+       begin += predicate_t::batch_size) {
+    std::size_t const count =
+        std::min(predicate_t::batch_size, events.size() - begin);
+    std::span<std::uint64_t> const batch_mask =
+        std::span(mask).first(simd::get_mask_word_count(count));
+
+    simd::fill_mask(batch_mask, count);
+    for (predicate_t const &predicate : filters) {
+      predicate.evaluate(events, begin, count, batch_mask);
+    }
+
+    simd::for_each_set_bit(batch_mask, [&](std::size_t row) {
+      event_value_t const value = events.get(begin + row, value_field);
+      if (!value.is_number()) {
+        return;
+      }
+
+      key_t key;
+      for (event_field_t const &key_field : key_fields) {
+        event_value_t const key_value = events.get(begin + row, key_field);
+        key.push_back(key_value.is_string() ? key_value.get_symbol()
+                                            : no_symbol_v);
+      }
+      res.push_back({.key = std::move(key), .value = value.get_value()});
+    });
+  }
+
+  // Symbol order isn't deterministic, keys are sorted by their strings
+  std::ranges::sort(res, key_string_less_t{}, &key_value_t::key);
+
+  // Values of equal keys are now adjacent and summed in place, as compare_by
+  // sums them per repetition
+  auto sum_end = res.begin();
+  for (auto it = res.begin(); it != res.end(); it++) {
+    if (sum_end != res.begin() && std::prev(sum_end)->key == it->key) {
+      std::prev(sum_end)->value += it->value;
+    } else {
+      *sum_end++ = std::move(*it);
+    }
+  }
+  res.erase(sum_end, res.end());
+  return res;
+}
+
+/// Writes a row per key of each repetition, with the sum of its values.
+void export_key_values(benchmark_set_t const &bset, table_writer_t &writer,
+                       grapher::json_t const &config) {
+  ZoneScoped;
+
+  std::vector<std::string> const key_pointers = config.value(
+      "key_ptrs", std::vector<std::string>{"/name", "/args/detail"});
+
+  std::vector<event_field_t> key_fields;
+  for (std::string const &pointer : key_pointers) {
+    key_fields.push_back(
+        event_field_t::resolve(grapher::json_t::json_pointer{pointer}));
+  }
+  event_field_t const value_field = event_field_t::resolve(
+      grapher::json_t::json_pointer{config.value("value_ptr", "/dur")});
+
+  std::vector<predicate_t> filters;
+  if (config.contains("filters") && config["filters"].is_array()) {
+    for (grapher::json_t const &filter : config["filters"]) {
+      filters.push_back(get_predicate(filter));
+    }
+  }
+
+  std::vector<repetition_ref_t> repetitions;
+  for (benchmark_case_t const &bench_case : bset) {
+    for (benchmark_instance_t const &instance : bench_case.instances) {
+      check(instance.events != nullptr,
+            fmt::format("No event store for benchmark {} at size {}.",
+                        bench_case.name, instance.size));
+
+      for (std::size_t repetition_id = 0;
+           repetition_id < instance.events->size(); repetition_id++) {
+        repetitions.push_back({.bench_case = bench_case,
+                               .instance = instance,
+                               .repetition_id = repetition_id});
+      }
+    }
+  }
+
+  // Repetitions are read concurrently in batches, then written in order
+  std::size_t const batch_size =
+      std::size_t{get_job_count()} * repetitions_per_job;
+  std::vector<std::vector<key_value_t>> batch;
+  std::vector<std::uint64_t> row(instance_column_count + key_fields.size() +
+                                 1);
+
+  for (std::size_t batch_begin = 0; batch_begin < repetitions.size();
+       batch_begin += batch_size) {
+    std::size_t const batch_end =
+        std::min(batch_begin + batch_size, repetitions.size());
+    batch.assign(batch_end - batch_begin, {});
+
+    parallel_for(batch.size(), [&](std::size_t i) {
+      auto const &[bench_case, instance, repetition_id] =
+          repetitions[batch_begin + i];
+      batch[i] = get_key_sums(instance.events->get(repetition_id), filters,
+                              key_fields, value_field);
+    });
+
+    for (std::size_t i = 0; i < batch.size(); i++) {
+      auto const &[bench_case, instance, repetition_id] =
+          repetitions[batch_begin + i];
+      row[0] = intern(bench_case.name);
+      row[1] = instance.size;
+      row[2] = repetition_id;
+
+      for (auto const &[key, value] : batch[i]) {
+        std::ranges::copy(key, row.begin() + instance_column_count);
+        row.back() = value;
+        writer.append_row(row);
+      }
+    }
+  }
+}
+
+/// Writes a row per descriptor sum.
+void export_descriptor_sums(benchmark_set_t const &bset,
+                            table_writer_t &writer,
+                            std::vector<group_descriptor_t> const &descriptors,
+                            grapher::json_t const &config) {
+  ZoneScoped;
+
+  grapher::json_t::json_pointer const value_pointer(
+      config.value("value_ptr", "/dur"));
+  descriptor_dispatcher_t const dispatcher(descriptors);
+
+  std::vector<std::uint64_t> descriptor_names;
+  for (group_descriptor_t const &descriptor : descriptors) {
+    descriptor_names.push_back(intern(descriptor.name));
+  }
+
+  std::vector<std::pair<benchmark_case_t const *,
+                        benchmark_instance_t const *>>
+      instances;
+  for (benchmark_case_t const &bench_case : bset) {
+    for (benchmark_instance_t const &instance : bench_case.instances) {
+      instances.emplace_back(&bench_case, &instance);
+    }
+  }
+
+  // Instances are read concurrently in batches, then written in order.
+  // Sums are indexed by instance, descriptor and repetition.
+  std::size_t const batch_size = std::size_t{get_job_count()};
+  std::vector<std::vector<std::vector<grapher::value_t>>> batch;
+  std::array<std::uint64_t, instance_column_count + 2> row;
+
+  for (std::size_t batch_begin = 0; batch_begin < instances.size();
+       batch_begin += batch_size) {
+    std::size_t const batch_end =
+        std::min(batch_begin + batch_size, instances.size());
+    batch.assign(batch_end - batch_begin, {});
+
+    parallel_for(batch.size(), [&](std::size_t i) {
+      batch[i] = filtered_values_sums(*instances[batch_begin + i].second,
+                                      dispatcher, value_pointer);
+    });
+
+    for (std::size_t i = 0; i < batch.size(); i++) {
+      auto const &[bench_case, instance] = instances[batch_begin + i];
+      row[0] = intern(bench_case->name);
+      row[1] = instance->size;
+
+      for (std::size_t descriptor_id = 0; descriptor_id < descriptors.size();
+           descriptor_id++) {
+        std::vector<grapher::value_t> const &sums = batch[i][descriptor_id];
+        for (std::size_t repetition_id = 0; repetition_id < sums.size();
+             repetition_id++) {
+          row[2] = repetition_id;
+          row[3] = descriptor_names[descriptor_id];
+          row[4] = sums[repetition_id];
+          writer.append_row(row);
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+grapher::json_t plotter_export_t::get_default_config() const {
+  grapher::json_t res;
+
+  res["plotter"] = "export";
+  res["file_extensions"] = json_t::array({".csv", ".ctcol"});
+  res["key_ptrs"] = json_t::array({"/name", "/args/detail"});
+  res["value_ptr"] = "/dur";
+
+  // Simple default filter as an example
+  res["filters"] = json_t::array({grapher::json_t{
+      {"type", "regex"},
+      {"pointer", "/name"},
+      {"regex", ".*"},
+  }});
+
+  return res;
+}
+
+trace_projection_t
+plotter_export_t::get_trace_projection(grapher::json_t const &config) const {
+  grapher::json_t::json_pointer value_pointer(
+      config.value("value_ptr", "/dur"));
+
+  if (config.contains("group_descriptors")) {
+    return get_descriptors_projection(
+        read_descriptors(
+            get_as_ref<json_t::array_t const &>(config, "group_descriptors")),
+        std::move(value_pointer));
+  }
+
+  trace_projection_t res{.keep_all_fields = false,
+                         .pointers = {std::move(value_pointer)}};
+  for (std::string const &pointer :
+       config.value("key_ptrs",
+                    std::vector<std::string>{"/name", "/args/detail"})) {
+    res.pointers.emplace_back(pointer);
+  }
+
+  // Events that are filtered out are dropped while reading trace files
+  std::vector<predicate_t> filters;
+  if (config.contains("filters") && config["filters"].is_array()) {
+    for (grapher::json_t const &filter : config["filters"]) {
+      std::ranges::move(get_predicate_pointers(filter),
+                        std::back_inserter(res.pointers));
+      filters.push_back(get_predicate(filter));
+    }
+  }
+  res.filters.push_back(std::move(filters));
+
+  return res;
+}
+
+void plotter_export_t::plot(benchmark_set_t const &bset,
+                            std::filesystem::path const &dest,
+                            grapher::json_t const &config) const {
+  std::vector<column_schema_t> schema = get_instance_columns();
+
+  if (config.contains("group_descriptors")) {
+    std::vector<group_descriptor_t> const descriptors = read_descriptors(
+        get_as_ref<json_t::array_t const &>(config, "group_descriptors"));
+
+    schema.push_back({.name = "group", .type = string_column_v});
+    schema.push_back({.name = "value", .type = unsigned_column_v});
+    table_writer_t writer(dest, config, std::move(schema));
+    export_descriptor_sums(bset, writer, descriptors, config);
+    writer.close(dest);
+    return;
+  }
+
+  for (std::string const &pointer :
+       config.value("key_ptrs",
+                    std::vector<std::string>{"/name", "/args/detail"})) {
+    schema.push_back({.name = pointer, .type = string_column_v});
+  }
+  schema.push_back({.name = "value", .type = unsigned_column_v});
+
+  table_writer_t writer(dest, config, std::move(schema));
+  export_key_values(bset, writer, config);
+  writer.close(dest);
+}
+
+} // namespace grapher::plotters
@@ -1,21 +1,170 @@
-#include <sciplot/sciplot.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <vector>
 
+#include <fmt/core.h>
+
+#include <grapher/core.hpp>
 #include <grapher/plotters/grouped_histogram.hpp>
-#include <grapher/plotters/plotters.hpp>
+#include <grapher/predicates.hpp>
+#include <grapher/utils/error.hpp>
 #include <grapher/utils/json.hpp>
+#include <grapher/utils/plot.hpp>
+#include <grapher/utils/render.hpp>
 
 namespace grapher::plotters {
 
+namespace {
+
+/// Width of a group of bars, relative to the distance between two sizes
+constexpr double bar_group_width = 0.8;
+
+/// Returns the smallest distance between two benchmark sizes, or 1 if there
+/// are less than two sizes.
+double get_size_spacing(std::vector<double> sizes) {
+  std::ranges::sort(sizes);
+  double res = 0;
+  for (std::size_t i = 1; i < sizes.size(); i++) {
+    double const spacing = sizes[i] - sizes[i - 1];
+    if (spacing > 0 && (res == 0 || spacing < res)) {
+      res = spacing;
+    }
+  }
+  return res == 0 ? 1. : res;
+}
+
+} // namespace
+
+plot_t get_grouped_histogram(benchmark_case_t const &bench,
+                             std::vector<group_descriptor_t> const &descriptors,
+                             descriptor_dispatcher_t const &dispatcher,
+                             json_t::json_pointer const &value_pointer) {
+  plot_t plot;
+
+  std::vector<double> sizes;
+  std::ranges::transform(bench.instances, std::back_inserter(sizes),
+                         [](benchmark_instance_t const &instance) -> double {
+                           return double(instance.size);
+                         });
+
+  // Bars of a size are laid out side by side, centered on the size
+  double const group_width = get_size_spacing(sizes) * bar_group_width;
+  double const bar_width = group_width / double(descriptors.size());
+
+  // Sums of all the descriptors, indexed by instance, descriptor and
+  // repetition
+  std::vector<std::vector<std::vector<grapher::value_t>>> values_sums;
+  std::ranges::transform(bench.instances, std::back_inserter(values_sums),
+                         [&](benchmark_instance_t const &instance) {
+                           return filtered_values_sums(instance, dispatcher,
+                                                       value_pointer);
+                         });
+
+  for (std::size_t descriptor_id = 0; descriptor_id < descriptors.size();
+       descriptor_id++) {
+    group_descriptor_t const &descriptor = descriptors[descriptor_id];
+
+    // Each bar is a filled area, closed at the bottom on both sides so
+    // consecutive bars are not joined
+    std::vector<double> x;
+    std::vector<double> y_high;
+
+    for (std::size_t i = 0; i < bench.instances.size(); i++) {
+      std::vector<grapher::value_t> const &values =
+          values_sums[i][descriptor_id];
+
+      check(!values.empty(),
+            fmt::format("No repetition for descriptor {} in benchmark {} "
+                        "with instance size {}.\n",
+                        descriptor.name, bench.name, bench.instances[i].size));
+
+      double const y_val = double(std::reduce(values.begin(), values.end())) /
+                           double(values.size());
+
+      double const left =
+          sizes[i] - group_width / 2 + double(descriptor_id) * bar_width;
+      double const right = left + bar_width;
+      x.insert(x.end(), {left, left, right, right});
+      y_high.insert(y_high.end(), {0., y_val, y_val, 0.});
+    }
+
+    std::vector<double> y_low(x.size(), 0.);
+    plot.draw_curves_filled(std::move(x), std::move(y_low), std::move(y_high),
+                            descriptor.name);
+  }
+
+  return plot;
+}
+
 grapher::json_t plotter_grouped_histogram_t::get_default_config() const {
-  // TODO
-  return grapher::base_default_config();
+  grapher::json_t res = grapher::base_default_config();
+
+  res["plotter"] = "grouped_histogram";
+  res["value_json_pointer"] = "/dur";
+
+  // Function instantiations grouped by namespace, as an example
+  std::vector<group_descriptor_t> descriptors;
+  for (std::string const name : {"std", "boost"}) {
+    descriptors.push_back(
+        {.name = name,
+         .predicates = grapher::json_t::array(
+             {grapher::json_t{{"type", "streq"},
+                              {"pointer", "/name"},
+                              {"string", "InstantiateFunction"}},
+              grapher::json_t{{"type", "regex"},
+                              {"pointer", "/args/detail"},
+                              {"regex", name + "::.*"}}})});
+  }
+  res["group_descriptors"] = write_descriptors(descriptors);
+
+  return res;
+}
+
+trace_projection_t plotter_grouped_histogram_t::get_trace_projection(
+    grapher::json_t const &config) const {
+  return get_descriptors_projection(
+      read_descriptors(
+          get_as_ref<json_t::array_t const &>(config, "group_descriptors")),
+      grapher::json_t::json_pointer{
+          config.value("value_json_pointer", "/dur")});
 }
 
-void plotter_grouped_histogram_t::plot(
-    const benchmark_set_t & /* bset */,
-    const std::filesystem::path & /* dest */,
-    const grapher::json_t & /* config */) const {
-  // TODO
+void plotter_grouped_histogram_t::plot(benchmark_set_t const &bset,
+                                       std::filesystem::path const &dest,
+                                       grapher::json_t const &config) const {
+  // Config reading
+
+  grapher::json_t::json_pointer feature_value_jptr(
+      config.value("value_json_pointer", "/dur"));
+
+  std::vector<group_descriptor_t> descriptors = read_descriptors(
+      get_as_ref<json_t::array_t const &>(config, "group_descriptors"));
+
+  if (!check(!descriptors.empty(), "No group descriptor to plot.",
+             warning_v)) {
+    return;
+  }
+
+  // Descriptors are evaluated in a single pass over the events
+  descriptor_dispatcher_t const dispatcher(descriptors);
+
+  // Drawing
+
+  std::vector<plot_t> plots;
+  std::ranges::transform(
+      bset, std::back_inserter(plots), [&](benchmark_case_t const &bench) {
+        plot_t plot = get_grouped_histogram(bench, descriptors, dispatcher,
+                                            feature_value_jptr);
+        apply_config(plot, config);
+        return plot;
+      });
+
+  // Saving
+  std::filesystem::create_directories(dest);
+  render_parallel(plots.size(), [&](std::size_t i) {
+    save_plot(plots[i], dest / bset[i].name, config);
+  });
 }
 
 } // namespace grapher::plotters
@@ -0,0 +1,554 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <grapher/core.hpp>
+#include <grapher/plotters/compare_by.hpp>
+#include <grapher/plotters/curve_aggregate.hpp>
+#include <grapher/plotters/html.hpp>
+#include <grapher/predicates.hpp>
+#include <grapher/utils/deflate.hpp>
+#include <grapher/utils/demangle.hpp>
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher::plotters {
+
+namespace {
+
+/// Default number of keys per data file. Opening a key loads the curves of
+/// its whole chunk, which keeps the number of files low without loading much
+/// more than needed.
+constexpr std::size_t default_keys_per_chunk = 64;
+
+/// Index page, up to the embedded report data.
+constexpr std::string_view page_header = R"html(<!DOCTYPE html>
+<html lang="en">
+<head>
+<meta charset="utf-8">
+<title>ctbench report</title>
+<style>
+body { margin: 0; display: flex; height: 100vh; font-family: sans-serif; }
+#keys { width: 45%; overflow: auto; border-right: 1px solid #CCC; }
+#plot { flex: 1; overflow: auto; padding: 0 1em; }
+#filter { width: 100%; box-sizing: border-box; padding: 4px; }
+#status { padding: 4px; color: #666; font-size: 13px; }
+table { border-collapse: collapse; width: 100%; font-size: 13px; }
+th { position: sticky; top: 0; background: #EEE; cursor: pointer; }
+th, td { padding: 2px 6px; text-align: left; }
+td.key { font-family: monospace; word-break: break-all; }
+td.number { text-align: right; font-variant-numeric: tabular-nums; }
+tbody tr:hover { background: #F4F4F4; cursor: pointer; }
+tbody tr.selected { background: #D0E4FF; }
+#plot h2 { font-family: monospace; font-size: 14px; word-break: break-all; }
+.legend span { display: inline-block; margin-right: 1em; font-size: 13px; }
+.legend i { display: inline-block; width: 12px; height: 12px;
+  margin-right: 4px; vertical-align: middle; }
+</style>
+</head>
+<body>
+<div id="keys">
+<input id="filter" placeholder="Filter keys">
+<div id="status"></div>
+<table>
+<thead><tr><th data-column="0">Key</th><th data-column="1">Total</th>
+<th data-column="2">Growth</th></tr></thead>
+<tbody id="rows"></tbody>
+</table>
+</div>
+<div id="plot"><p>Select a key to plot its curves.</p></div>
+<script>const report = )html";
+
+/// Index page, after the embedded report data.
+constexpr std::string_view page_footer = R"html(;</script>
+<script>
+"use strict";
+
+// Keys are [name, total, growth, chunk, index in chunk]
+const max_rows = 1000;
+const colors = ["#1B9E77", "#D95F02", "#7570B3", "#E7298A", "#66A61E",
+                "#E6AB02", "#A6761D", "#666666"];
+let sort_column = 1;
+let sort_descending = true;
+let selected_key = null;
+
+// Chunk id -> promise of its decoded curves
+const chunks = new Map();
+// Chunk id -> callback receiving the compressed data of a loading chunk
+const pending_chunks = new Map();
+
+// Called by data files
+function ctbench_chunk(id, data) {
+  const resolve = pending_chunks.get(id);
+  pending_chunks.delete(id);
+  if (resolve) {
+    resolve(data);
+  }
+}
+
+function decode_chunk(base64) {
+  const bytes = Uint8Array.from(atob(base64), (c) => c.charCodeAt(0));
+  const stream = new Blob([bytes]).stream()
+    .pipeThrough(new DecompressionStream("gzip"));
+  return new Response(stream).json();
+}
+
+function load_chunk(id) {
+  if (!chunks.has(id)) {
+    chunks.set(id, new Promise((resolve, reject) => {
+      pending_chunks.set(id, resolve);
+      const script = document.createElement("script");
+      script.src = "data/chunk_" + id + ".js";
+      script.onerror = () => reject(new Error("Could not load " + script.src));
+      document.head.appendChild(script);
+    }).then(decode_chunk));
+  }
+  return chunks.get(id);
+}
+
+function format_number(value) {
+  return value === null ? "-" :
+    Number(value.toPrecision(4)).toLocaleString("en-US");
+}
+
+function compare_keys(a, b) {
+  const x = a[sort_column];
+  const y = b[sort_column];
+  if (x === y) {
+    return 0;
+  }
+  // Keys without a growth rate come last
+  if (x === null || y === null) {
+    return x === null ? 1 : -1;
+  }
+  return (x < y) !== sort_descending ? -1 : 1;
+}
+
+function render_rows() {
+  const filter = document.getElementById("filter").value.toLowerCase();
+  const keys = report.keys.filter(
+    (key) => key[0].toLowerCase().includes(filter));
+  keys.sort(compare_keys);
+
+  document.getElementById("status").textContent =
+    keys.length + " of " + report.keys.length + " keys" +
+    (keys.length > max_rows ? ", showing the first " + max_rows : "");
+
+  const rows = document.createDocumentFragment();
+  for (const key of keys.slice(0, max_rows)) {
+    const row = document.createElement("tr");
+    if (key === selected_key) {
+      row.className = "selected";
+    }
+    const cells = [[key[0], "key"], [format_number(key[1]), "number"],
+                   [format_number(key[2]), "number"]];
+    for (const [text, class_name] of cells) {
+      const cell = document.createElement("td");
+      cell.textContent = text;
+      cell.className = class_name;
+      row.appendChild(cell);
+    }
+    row.onclick = () => {
+      for (const other of document.querySelectorAll("tr.selected")) {
+        other.className = "";
+      }
+      row.className = "selected";
+      show_key(key);
+    };
+    rows.appendChild(row);
+  }
+  document.getElementById("rows").replaceChildren(rows);
+}
+
+function get_ticks(min, max) {
+  if (!(max > min)) {
+    return [min];
+  }
+  const raw_step = (max - min) / 6;
+  const magnitude = Math.pow(10, Math.floor(Math.log10(raw_step)));
+  const step = [1, 2, 5, 10].map((factor) => factor * magnitude)
+    .find((candidate) => candidate >= raw_step);
+  const ticks = [];
+  for (let i = Math.floor(min / step); i <= Math.ceil(max / step); i++) {
+    ticks.push(i * step);
+  }
+  return ticks;
+}
+
+function make_svg(tag, attributes, text) {
+  const element = document.createElementNS("http://www.w3.org/2000/svg", tag);
+  for (const [name, value] of Object.entries(attributes)) {
+    element.setAttribute(name, value);
+  }
+  if (text !== undefined) {
+    element.textContent = text;
+  }
+  return element;
+}
+
+// Benchmarks are {name, x, average, stddev, median}
+function draw_curves(benchmarks) {
+  const width = 800;
+  const height = 480;
+  const left = 80;
+  const right = 20;
+  const top = 20;
+  const bottom = 50;
+
+  const xs = benchmarks.flatMap((benchmark) => benchmark.x);
+  const ys = benchmarks.flatMap((benchmark) => benchmark.average.map(
+    (average, i) => Math.max(average + benchmark.stddev[i],
+                             benchmark.median[i])));
+  const x_ticks = get_ticks(Math.min(...xs), Math.max(...xs));
+  const y_ticks = get_ticks(0, Math.max(0, ...ys));
+  const x_min = x_ticks[0];
+  const x_max = Math.max(x_ticks[x_ticks.length - 1], x_min + 1);
+  const y_max = Math.max(y_ticks[y_ticks.length - 1], 1);
+
+  const to_x = (x) => left + (x - x_min) / (x_max - x_min) *
+    (width - left - right);
+  const to_y = (y) => height - bottom - y / y_max * (height - top - bottom);
+
+  const svg = make_svg("svg", {width: width, height: height,
+                               "font-size": 11, "font-family": "sans-serif"});
+  for (const tick of x_ticks) {
+    svg.append(
+      make_svg("line", {x1: to_x(tick), x2: to_x(tick), y1: top,
+                        y2: height - bottom, stroke: "#DDD"}),
+      make_svg("text", {x: to_x(tick), y: height - bottom + 15,
+                        "text-anchor": "middle"}, format_number(tick)));
+  }
+  for (const tick of y_ticks) {
+    svg.append(
+      make_svg("line", {x1: left, x2: width - right, y1: to_y(tick),
+                        y2: to_y(tick), stroke: "#DDD"}),
+      make_svg("text", {x: left - 5, y: to_y(tick) + 4,
+                        "text-anchor": "end"}, format_number(tick)));
+  }
+  svg.append(
+    make_svg("text", {x: (left + width - right) / 2, y: height - 10,
+                      "text-anchor": "middle"}, report.x_label),
+    make_svg("text", {x: 15, y: (top + height - bottom) / 2,
+                      "text-anchor": "middle",
+                      transform: "rotate(-90 15 " +
+                        (top + height - bottom) / 2 + ")"},
+             report.y_label));
+
+  const legend = document.createElement("div");
+  legend.className = "legend";
+
+  benchmarks.forEach((benchmark, i) => {
+    const color = colors[i % colors.length];
+    const points = (values) => benchmark.x.map(
+      (x, j) => to_x(x) + "," + to_y(values[j])).join(" ");
+    const high = benchmark.average.map(
+      (average, j) => average + benchmark.stddev[j]);
+    const low = benchmark.average.map(
+      (average, j) => Math.max(0, average - benchmark.stddev[j]));
+
+    svg.append(
+      make_svg("polygon", {
+        points: points(high) + " " + points(low).split(" ").reverse().join(" "),
+        fill: color, "fill-opacity": 0.15}),
+      make_svg("polyline", {points: points(benchmark.average), fill: "none",
+                            stroke: color, "stroke-width": 2}),
+      make_svg("polyline", {points: points(benchmark.median), fill: "none",
+                            stroke: color, "stroke-dasharray": "4 3"}));
+    benchmark.x.forEach((x, j) => svg.append(
+      make_svg("circle", {cx: to_x(x), cy: to_y(benchmark.average[j]), r: 3,
+                          fill: color})));
+
+    const entry = document.createElement("span");
+    const swatch = document.createElement("i");
+    swatch.style.background = color;
+    entry.append(swatch, benchmark.name);
+    legend.append(entry);
+  });
+
+  const note = document.createElement("p");
+  note.textContent = "Average (solid) with standard deviation, and median " +
+    "(dashed).";
+  return [svg, legend, note];
+}
+
+async function show_key(key) {
+  selected_key = key;
+  const plot = document.getElementById("plot");
+  const title = document.createElement("h2");
+  title.textContent = key[0];
+  plot.replaceChildren(title, "Loading...");
+
+  try {
+    const curves = await load_chunk(key[3]);
+    if (selected_key === key) {
+      plot.replaceChildren(title, ...draw_curves(curves[key[4]]));
+    }
+  } catch (error) {
+    plot.replaceChildren(title, error.message);
+  }
+}
+
+document.title = report.title;
+for (const header of document.querySelectorAll("th")) {
+  header.onclick = () => {
+    const column = Number(header.dataset.column);
+    sort_descending = column === sort_column ? !sort_descending : column !== 0;
+    sort_column = column;
+    render_rows();
+  };
+}
+document.getElementById("filter").oninput = render_rows;
+render_rows();
+</script>
+</body>
+</html>
+)html";
+
+/// Rounds a value for display, keeping data files small.
+double round_value(double value) { return std::round(value * 1000.) / 1000.; }
+
+/// Returns the sum of the values of a key.
+double get_total(curve_aggregate_t const &curve_aggregate) {
+  double total = 0;
+  for (auto const &[bench_name, benchmark_curve] : curve_aggregate) {
+    for (auto const &[size, point_aggregate] : benchmark_curve) {
+      total += point_aggregate.sum();
+    }
+  }
+  return total;
+}
+
+/// Converts the curves of a key to JSON for data files.
+grapher::json_t to_json(curve_aggregate_t const &curve_aggregate) {
+  grapher::json_t res = grapher::json_t::array();
+  for (auto const &[bench_name, benchmark_curve] : curve_aggregate) {
+    grapher::json_t x = grapher::json_t::array();
+    grapher::json_t average = grapher::json_t::array();
+    grapher::json_t stddev = grapher::json_t::array();
+    grapher::json_t median = grapher::json_t::array();
+
+    for (auto const &[size, point_aggregate] : benchmark_curve) {
+      if (point_aggregate.empty()) {
+        continue;
+      }
+      x.push_back(size);
+      average.push_back(round_value(point_aggregate.average()));
+      stddev.push_back(round_value(point_aggregate.stddev()));
+      median.push_back(round_value(point_aggregate.median()));
+    }
+
+    res.push_back({{"name", bench_name},
+                   {"x", std::move(x)},
+                   {"average", std::move(average)},
+                   {"stddev", std::move(stddev)},
+                   {"median", std::move(median)}});
+  }
+  return res;
+}
+
+/// Writes a file, warning if it could not be written.
+void write_file(std::filesystem::path const &path, std::string_view data) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(data.data(), std::streamsize(data.size()));
+  check(file.good(), fmt::format("Could not write {}.", path.string()),
+        warning_v);
+}
+
+} // namespace
+
+std::string to_base64(std::string_view data) {
+  constexpr std::string_view alphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  std::string res;
+  res.reserve((data.size() + 2) / 3 * 4);
+  for (std::size_t i = 0; i < data.size(); i += 3) {
+    std::size_t const count = std::min<std::size_t>(3, data.size() - i);
+    std::uint32_t bytes = 0;
+    for (std::size_t j = 0; j < 3; j++) {
+      bytes = bytes << 8 | (j < count ? std::uint8_t(data[i + j]) : 0);
+    }
+    for (std::size_t j = 0; j < 4; j++) {
+      res += j <= count ? alphabet[(bytes >> (18 - 6 * j)) & 0x3F] : '=';
+    }
+  }
+  return res;
+}
+
+std::optional<double>
+get_growth_rate(curve_aggregate_t const &curve_aggregate) {
+  std::optional<double> res;
+  for (auto const &[bench_name, benchmark_curve] : curve_aggregate) {
+    std::vector<std::pair<double, double>> points;
+    for (auto const &[size, point_aggregate] : benchmark_curve) {
+      if (size > 0 && !point_aggregate.empty() &&
+          point_aggregate.average() > 0) {
+        points.emplace_back(std::log(double(size)),
+                            std::log(point_aggregate.average()));
+      }
+    }
+    if (points.size() < 2) {
+      continue;
+    }
+
+    double const n = double(points.size());
+    double x_mean = 0;
+    double y_mean = 0;
+    for (auto const &[x, y] : points) {
+      x_mean += x / n;
+      y_mean += y / n;
+    }
+    double covariance = 0;
+    double variance = 0;
+    for (auto const &[x, y] : points) {
+      covariance += (x - x_mean) * (y - y_mean);
+      variance += (x - x_mean) * (x - x_mean);
+    }
+
+    double const rate = covariance / variance;
+    res = res ? std::max(*res, rate) : rate;
+  }
+  return res;
+}
+
+std::string escape_script_data(std::string data) {
+  for (std::size_t position = data.find("</"); position != std::string::npos;
+       position = data.find("</", position + 3)) {
+    data.replace(position, 2, "<\\/");
+  }
+  return data;
+}
+
+grapher::json_t plotter_html_t::get_default_config() const {
+  grapher::json_t res = plotter_compare_by_t{}.get_default_config();
+
+  for (std::string_view const plot_parameter :
+       {"width", "height", "legend_title", "plot_file_extensions",
+        "plot_backend", "draw_average", "average_error_bars", "draw_points",
+        "draw_median"}) {
+    res.erase(std::string(plot_parameter));
+  }
+
+  res["plotter"] = "html";
+  res["keys_per_chunk"] = default_keys_per_chunk;
+  res["title"] = "ctbench report";
+
+  return res;
+}
+
+trace_projection_t
+plotter_html_t::get_trace_projection(grapher::json_t const &config) const {
+  // Same events as compare_by
+  return plotter_compare_by_t{}.get_trace_projection(config);
+}
+
+void plotter_html_t::plot(benchmark_set_t const &bset,
+                          std::filesystem::path const &dest,
+                          grapher::json_t const &config) const {
+  ZoneScoped;
+  namespace fs = std::filesystem;
+
+  // Config reading
+  std::size_t const keys_per_chunk = std::max<std::size_t>(
+      config.value("keys_per_chunk", default_keys_per_chunk), 1);
+
+  std::vector<predicate_t> filters;
+  std::ranges::transform(get_filters(config), std::back_inserter(filters),
+                         &get_predicate);
+
+  // Samples are not kept, curves only need the statistics of the points
+  curve_aggregate_map_t const curve_aggregate_map = get_bench_curves(
+      bset, get_key_pointers(config),
+      json_t::json_pointer(config.value("value_ptr", "/dur")),
+      std::move(filters), false, nullptr, nullptr,
+      get_key_pruning_parameters(config));
+
+  demangle_cache_t demangle_cache;
+  if (config.value("demangle", true)) {
+    std::vector<grapher::symbol_t> key_parts;
+    for (auto const &[key, curve_aggregate] : curve_aggregate_map) {
+      key_parts.insert(key_parts.end(), key.begin(), key.end());
+    }
+    demangle_cache.insert(key_parts);
+  }
+
+  // Keys are listed by name, and stored in chunks in the same order
+  struct entry_t {
+    std::string name;
+    curve_aggregate_t const *curve_aggregate;
+  };
+  std::vector<entry_t> entries;
+  for (auto const &[key, curve_aggregate] : curve_aggregate_map) {
+    entries.push_back(
+        {.name = to_string(key, config.value("demangle", true)
+                                    ? &demangle_cache
+                                    : nullptr),
+         .curve_aggregate = &curve_aggregate});
+  }
+  std::ranges::sort(entries, {}, &entry_t::name);
+
+  // Chunks of a previous report with more keys would be left behind
+  fs::create_directories(dest / "data");
+  for (fs::directory_entry const &entry :
+       fs::directory_iterator(dest / "data")) {
+    std::string const file_name = entry.path().filename().string();
+    if (file_name.starts_with("chunk_") && file_name.ends_with(".js")) {
+      fs::remove(entry.path());
+    }
+  }
+
+  // Data files are independent, and compressed concurrently
+  std::size_t const chunk_count =
+      (entries.size() + keys_per_chunk - 1) / keys_per_chunk;
+  parallel_for(chunk_count, [&](std::size_t chunk_id) {
+    std::size_t const begin = chunk_id * keys_per_chunk;
+    std::size_t const end = std::min(begin + keys_per_chunk, entries.size());
+
+    grapher::json_t chunk = grapher::json_t::array();
+    for (std::size_t i = begin; i < end; i++) {
+      chunk.push_back(to_json(*entries[i].curve_aggregate));
+    }
+
+    write_file(dest / "data" / fmt::format("chunk_{}.js", chunk_id),
+               fmt::format("ctbench_chunk({}, \"{}\");\n", chunk_id,
+                           to_base64(gzip(chunk.dump()))));
+  });
+
+  // Index page
+  grapher::json_t keys = grapher::json_t::array();
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    std::optional<double> const growth_rate =
+        get_growth_rate(*entries[i].curve_aggregate);
+    keys.push_back({entries[i].name,
+                    round_value(get_total(*entries[i].curve_aggregate)),
+                    growth_rate ? grapher::json_t(round_value(*growth_rate))
+                                : grapher::json_t(nullptr),
+                    i / keys_per_chunk, i % keys_per_chunk});
+  }
+
+  grapher::json_t const report = {
+      {"title", config.value("title", "ctbench report")},
+      {"x_label", config.value("x_label", "Benchmark size factor")},
+      {"y_label", config.value("y_label", "Time (µs)")},
+      {"keys", std::move(keys)}};
+
+  // Report data must not close the script element it is embedded in
+  std::string page(page_header);
+  page += escape_script_data(report.dump());
+  page += page_footer;
+  write_file(dest / "index.html", page);
+}
+
+} // namespace grapher::plotters
@@ -6,14 +6,13 @@
 
 #include <fmt/core.h>
 
-#include <sciplot/Plot2D.hpp>
-#include <sciplot/sciplot.hpp>
-
 #include <grapher/core.hpp>
 #include <grapher/plotters/stack.hpp>
 #include <grapher/predicates.hpp>
 #include <grapher/utils/error.hpp>
 #include <grapher/utils/json.hpp>
+#include <grapher/utils/plot.hpp>
+#include <grapher/utils/render.hpp>
 
 namespace grapher::plotters {
 
@@ -28,6 +27,15 @@ grapher::json_t plotter_stack_t::get_default_config() const {
   return res;
 }
 
+trace_projection_t
+plotter_stack_t::get_trace_projection(grapher::json_t const &config) const {
+  return get_descriptors_projection(
+      read_descriptors(
+          get_as_ref<json_t::array_t const &>(config, "group_descriptors")),
+      grapher::json_t::json_pointer{
+          config.value("value_json_pointer", "/dur")});
+}
+
 void plotter_stack_t::plot(benchmark_set_t const &bset,
                            std::filesystem::path const &dest,
                            grapher::json_t const &config) const {
@@ -39,16 +47,19 @@ void plotter_stack_t::plot(benchmark_set_t const &bset,
   std::vector<group_descriptor_t> descriptors = read_descriptors(
       get_as_ref<json_t::array_t const &>(config, "group_descriptors"));
 
+  // Descriptors are evaluated in a single pass over the events
+  descriptor_dispatcher_t const dispatcher(descriptors);
+
   // Drawing
 
-  std::vector<sciplot::Plot2D> plots;
+  std::vector<plot_t> plots;
 
   // Storing max y value for normalization
   grapher::value_t max_y_val = 0.;
 
   /// Draws a stacked curve graph for a given benchmark
-  auto draw_plot = [&](benchmark_case_t const &bench) -> sciplot::Plot2D {
-    sciplot::Plot2D plot;
+  auto draw_plot = [&](benchmark_case_t const &bench) -> plot_t {
+    plot_t plot;
     apply_config(plot, config);
 
     // x axis
@@ -64,20 +75,30 @@ void plotter_stack_t::plot(benchmark_set_t const &bset,
     // High y axis
     std::vector<grapher::value_t> y_high(x_axis.size());
 
-    for (group_descriptor_t const &descriptor : descriptors) {
+    // Sums of all the descriptors, indexed by instance, descriptor and
+    // repetition
+    std::vector<std::vector<std::vector<grapher::value_t>>> values_sums;
+    std::transform(bench.instances.begin(), bench.instances.end(),
+                   std::back_inserter(values_sums),
+                   [&](benchmark_instance_t const &instance) {
+                     return filtered_values_sums(instance, dispatcher,
+                                                 feature_value_jptr);
+                   });
+
+    for (std::size_t descriptor_id = 0; descriptor_id < descriptors.size();
+         descriptor_id++) {
+      group_descriptor_t const &descriptor = descriptors[descriptor_id];
+
       // Storing previous value as we iterate
       std::string curve_name = descriptor.name;
 
-      std::vector<predicate_t> extracted_predicates =
-          get_predicates(descriptor);
-
       for (std::size_t i = 0; i < bench.instances.size(); i++) {
         benchmark_instance_t const &instance = bench.instances[i];
-        std::vector<grapher::value_t> const values = filtered_values_sums(
-            instance, extracted_predicates, feature_value_jptr);
+        std::vector<grapher::value_t> const &values =
+            values_sums[i][descriptor_id];
 
-        check(values.empty(),
-              fmt::format("No event matching descriptor {} in benchmark {} "
+        check(!values.empty(),
+              fmt::format("No repetition for descriptor {} in benchmark {} "
                           "with instance size {}.\n",
                           descriptor.name, bench.name, instance.size));
 
@@ -92,13 +113,16 @@ void plotter_stack_t::plot(benchmark_set_t const &bset,
         max_y_val = std::max(max_y_val, y_val);
       }
 
-      plot.drawCurvesFilled(x_axis, y_low, y_high).label(std::move(curve_name));
+      plot.draw_curves_filled({x_axis.begin(), x_axis.end()},
+                              {y_low.begin(), y_low.end()},
+                              {y_high.begin(), y_high.end()},
+                              std::move(curve_name));
 
       // Swapping
       std::swap(y_low, y_high);
     }
 
-    plot.legend().displayStartFromLast();
+    plot.legend_from_last = true;
     return plot;
   };
 
@@ -108,10 +132,12 @@ void plotter_stack_t::plot(benchmark_set_t const &bset,
 
   // Normalize & save
   std::filesystem::create_directories(dest);
-  for (std::size_t i = 0; i < bset.size(); i++) {
-    plots[i].yrange(0., double(max_y_val));
-    save_plot(plots[i], dest / bset[i].name, config);
+  for (plot_t &plot : plots) {
+    plot.y_range = {0., double(max_y_val)};
   }
+  render_parallel(plots.size(), [&](std::size_t i) {
+    save_plot(plots[i], dest / bset[i].name, config);
+  });
 }
 
 } // namespace grapher::plotters
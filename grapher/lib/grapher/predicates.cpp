@@ -1,5 +1,19 @@
-#include <regex>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -10,10 +24,112 @@
 #include <grapher/core.hpp>
 #include <grapher/predicates.hpp>
 #include <grapher/utils/error.hpp>
+#include <grapher/utils/intern.hpp>
 #include <grapher/utils/json.hpp>
+#include <grapher/utils/simd.hpp>
 
 namespace grapher::predicates {
 
+/// \ingroup predicates
+/// Predicate expression tree. Predicates are built as expression trees, which
+/// are optimized and then compiled into flat programs.
+struct expression_t {
+  predicate_opcode_t opcode;
+
+  /// Event field read by leaf expressions
+  event_field_t field = {};
+
+  /// Symbol compared by streq_op_v
+  symbol_t symbol = no_symbol_v;
+
+  /// Constant value of constant_op_v
+  bool constant = false;
+
+  /// Pattern of regex_op_v, or value compared by equals_op_v
+  grapher::json_t value = {};
+
+  /// Strings and ids of in_set_op_v
+  std::vector<event_value_t> elements = {};
+
+  /// Bounds of range_op_v
+  predicate_range_t range = {.min = 0, .max = 0};
+
+  /// Sub-expressions of all_op_v and any_op_v
+  std::vector<expression_t> operands = {};
+};
+
+/// Builds an expression from its JSON description.
+expression_t get_expression(grapher::json_t const &constraint);
+
+inline expression_t make_constant(bool constant) {
+  return {.opcode = constant_op_v,
+          .field = {},
+          .symbol = no_symbol_v,
+          .constant = constant,
+          .value = {},
+          .elements = {},
+          .range = {.min = 0, .max = 0},
+          .operands = {}};
+}
+
+inline expression_t make_leaf(predicate_opcode_t opcode, event_field_t field,
+                              symbol_t symbol, grapher::json_t value = {}) {
+  return {.opcode = opcode,
+          .field = field,
+          .symbol = symbol,
+          .constant = false,
+          .value = std::move(value),
+          .elements = {},
+          .range = {.min = 0, .max = 0},
+          .operands = {}};
+}
+
+inline expression_t make_operation(predicate_opcode_t opcode,
+                                   std::vector<expression_t> operands) {
+  return {.opcode = opcode,
+          .field = {},
+          .symbol = no_symbol_v,
+          .constant = false,
+          .value = {},
+          .elements = {},
+          .range = {.min = 0, .max = 0},
+          .operands = std::move(operands)};
+}
+
+inline expression_t make_set_leaf(event_field_t field,
+                                  std::vector<event_value_t> elements) {
+  return {.opcode = in_set_op_v,
+          .field = field,
+          .symbol = no_symbol_v,
+          .constant = false,
+          .value = {},
+          .elements = std::move(elements),
+          .range = {.min = 0, .max = 0},
+          .operands = {}};
+}
+
+inline expression_t make_range_leaf(event_field_t field,
+                                    predicate_range_t range) {
+  return {.opcode = range_op_v,
+          .field = field,
+          .symbol = no_symbol_v,
+          .constant = false,
+          .value = {},
+          .elements = {},
+          .range = range,
+          .operands = {}};
+}
+
+/// Builds a regex leaf. Literal patterns are compared by symbol instead.
+inline expression_t make_pattern_leaf(event_field_t field,
+                                      grapher::json_t const &pattern) {
+  if (std::optional<std::string> const literal = get_pattern_literal(
+          pattern.get_ref<json_t::string_t const &>())) {
+    return make_leaf(streq_op_v, field, intern(*literal));
+  }
+  return make_leaf(regex_op_v, field, no_symbol_v, pattern);
+}
+
 /// \ingroup predicates
 /// Generates a regex predicate from constraint.
 ///
@@ -25,20 +141,14 @@ namespace grapher::predicates {
 ///   "regex": "Total*"
 /// }
 /// ```
-inline auto regex(grapher::json_t const &constraint) {
-  // Validating pointer parameter
-  return [pointer =
-              grapher::json_t::json_pointer{
-                  get_as_ref<json_t::string_t const &>(constraint, "pointer")},
-          regex = std::regex(get_as_ref<json_t::string_t const &>(
-              constraint, "regex"))](grapher::json_t const &value) -> bool {
-    if (!value.contains(pointer) || !value[pointer].is_string()) {
-      return false;
-    }
+inline expression_t regex(grapher::json_t const &constraint) {
+  // Validating regex parameter
+  get_as_ref<json_t::string_t const &>(constraint, "regex");
 
-    return std::regex_match(
-        get_as_ref<json_t::string_t const &>(value, pointer), regex);
-  };
+  return make_pattern_leaf(event_field_t::resolve(
+                               get_as_ref<json_t::string_t const &>(
+                                   constraint, "pointer")),
+                           get_as_json(constraint, "regex"));
 }
 
 /// \ingroup predicates
@@ -81,40 +191,31 @@ inline auto regex(grapher::json_t const &constraint) {
 ///   }
 /// }
 /// ```
-inline auto match(grapher::json_t const &constraint) {
-  return [matcher_flat = get_as_json(constraint, "matcher").flatten(),
-          regex_match_opt = constraint.value("regex", false)](
-             grapher::json_t const &value) -> bool {
-    auto items_instance_proxy = matcher_flat.items();
-    return std::all_of(items_instance_proxy.begin(), items_instance_proxy.end(),
-                       [&](auto const &matcher_item_kv) -> bool {
-                         // Pointer to the value we should observe
-                         grapher::json_t::json_pointer const ptr(
-                             matcher_item_kv.key());
-
-                         // Checking for existence of matching value
-                         if (!value.contains(ptr)) {
-                           return false;
-                         }
-
-                         // Regex match
-                         if (regex_match_opt) {
-                           grapher::json_t const &val = value[ptr];
-
-                           // Fallback to non regex if the value isn't a string
-                           if (!val.is_string()) {
-                             return val == matcher_item_kv.value();
-                           }
-
-                           return std::regex_match(
-                               val.get_ref<grapher::json_t::string_t const &>(),
-                               std::regex(matcher_item_kv.value()));
-                         }
-
-                         // Regular match
-                         return value[ptr] == matcher_item_kv.value();
-                       });
-  };
+inline expression_t match(grapher::json_t const &constraint) {
+  bool const regex_match_opt = constraint.value("regex", false);
+  grapher::json_t const matcher_flat =
+      get_as_json(constraint, "matcher").flatten();
+
+  // One operand per matcher field. String fields only match string values,
+  // other values are compared as JSON.
+  std::vector<expression_t> operands;
+  for (auto const &matcher_item_kv : matcher_flat.items()) {
+    event_field_t const field = event_field_t::resolve(matcher_item_kv.key());
+    grapher::json_t const &expected = matcher_item_kv.value();
+
+    if (!expected.is_string()) {
+      operands.push_back(
+          make_leaf(equals_op_v, field, no_symbol_v, expected));
+    } else if (regex_match_opt) {
+      operands.push_back(make_pattern_leaf(field, expected));
+    } else {
+      operands.push_back(make_leaf(
+          streq_op_v, field,
+          intern(expected.get_ref<json_t::string_t const &>())));
+    }
+  }
+
+  return make_operation(all_op_v, std::move(operands));
 }
 
 /// \ingroup predicates
@@ -128,18 +229,84 @@ inline auto match(grapher::json_t const &constraint) {
 ///   "string": "Total Source"
 /// }
 /// ```
-inline auto streq(grapher::json_t const &constraint) {
-  return [pointer =
-              grapher::json_t::json_pointer{
-                  get_as_ref<json_t::string_t const &>(constraint, "pointer")},
-          str = get_as_ref<json_t::string_t const &>(constraint, "string")](
-             grapher::json_t const &value) -> bool {
-    if (!value.contains(pointer) || !value[pointer].is_string()) {
-      return false;
+inline expression_t streq(grapher::json_t const &constraint) {
+  // Strings are compared by symbol
+  return make_leaf(
+      streq_op_v,
+      event_field_t::resolve(
+          get_as_ref<json_t::string_t const &>(constraint, "pointer")),
+      intern(get_as_ref<json_t::string_t const &>(constraint, "string")));
+}
+
+/// \ingroup predicates
+/// Generates an in_set predicate from constraint. The field must be one of the
+/// strings, or one of the unsigned integers (ie. process or thread ids) of the
+/// set. Lookups are done in constant time regardless of the size of the set.
+///
+/// Example:
+/// ```json
+/// {
+///   "type": "in_set",
+///   "pointer": "/name",
+///   "values": ["Source", "ParseClass", "InstantiateFunction"]
+/// }
+/// ```
+inline expression_t in_set(grapher::json_t const &constraint) {
+  std::vector<event_value_t> elements;
+  for (grapher::json_t const &element :
+       get_as_ref<json_t::array_t const &>(constraint, "values")) {
+    if (element.is_string()) {
+      elements.push_back(event_value_t::from_json(element));
+      continue;
     }
+    check(element.is_number_unsigned() ||
+              (element.is_number_integer() &&
+               element.get<json_t::number_integer_t>() >= 0),
+          fmt::format("Predicate error, in_set values must be strings or "
+                      "unsigned integers:\n{}",
+                      constraint.dump(2)));
+    elements.push_back({.kind = unsigned_kind_v,
+                        .bits = element.get<json_t::number_unsigned_t>()});
+  }
 
-    return value[pointer].get_ref<grapher::json_t::string_t const &>() == str;
-  };
+  return make_set_leaf(
+      event_field_t::resolve(
+          get_as_ref<json_t::string_t const &>(constraint, "pointer")),
+      std::move(elements));
+}
+
+/// \ingroup predicates
+/// Generates a range predicate from constraint. The field must be a number
+/// between min and max, both inclusive. Either bound can be omitted.
+///
+/// Example:
+/// ```json
+/// {
+///   "type": "range",
+///   "pointer": "/dur",
+///   "min": 1000,
+///   "max": 50000
+/// }
+/// ```
+inline expression_t range(grapher::json_t const &constraint) {
+  predicate_range_t bounds = {
+      .min = -std::numeric_limits<double>::infinity(),
+      .max = std::numeric_limits<double>::infinity()};
+
+  for (auto const &[name, bound] :
+       {std::pair{"min", &bounds.min}, std::pair{"max", &bounds.max}}) {
+    if (constraint.contains(name)) {
+      check(constraint[name].is_number(),
+            fmt::format("Predicate error, range {} must be a number:\n{}",
+                        name, constraint.dump(2)));
+      *bound = constraint[name].get<double>();
+    }
+  }
+
+  return make_range_leaf(
+      event_field_t::resolve(
+          get_as_ref<json_t::string_t const &>(constraint, "pointer")),
+      bounds);
 }
 
 /// \ingroup predicates
@@ -164,12 +331,11 @@ inline auto streq(grapher::json_t const &constraint) {
 ///   }
 /// }
 /// ```
-inline auto op_or(grapher::json_t const &constraint) {
-  return [first = get_predicate(get_as_json(constraint, "first")),
-          second = get_predicate(get_as_json(constraint, "second"))](
-             grapher::json_t const &value) -> bool {
-    return first(value) || second(value);
-  };
+inline expression_t op_or(grapher::json_t const &constraint) {
+  std::vector<expression_t> operands;
+  operands.push_back(get_expression(get_as_json(constraint, "first")));
+  operands.push_back(get_expression(get_as_json(constraint, "second")));
+  return make_operation(any_op_v, std::move(operands));
 }
 
 /// \ingroup predicates
@@ -193,12 +359,11 @@ inline auto op_or(grapher::json_t const &constraint) {
 ///   }
 /// }
 /// ```
-inline auto op_and(grapher::json_t const &constraint) {
-  return [first = get_predicate(get_as_json(constraint, "first")),
-          second = get_predicate(get_as_json(constraint, "second"))](
-             grapher::json_t const &value) -> bool {
-    return first(value) && second(value);
-  };
+inline expression_t op_and(grapher::json_t const &constraint) {
+  std::vector<expression_t> operands;
+  operands.push_back(get_expression(get_as_json(constraint, "first")));
+  operands.push_back(get_expression(get_as_json(constraint, "second")));
+  return make_operation(all_op_v, std::move(operands));
 }
 
 /// \ingroup predicates
@@ -210,8 +375,8 @@ inline auto op_and(grapher::json_t const &constraint) {
 ///   "type": "val_true",
 /// }
 /// ```
-inline auto val_true(grapher::json_t const & /* unused */) {
-  return [](grapher::json_t const &) -> bool { return true; };
+inline expression_t val_true(grapher::json_t const & /* unused */) {
+  return make_constant(true);
 }
 
 /// \ingroup predicates
@@ -223,17 +388,11 @@ inline auto val_true(grapher::json_t const & /* unused */) {
 ///   "type": "val_false",
 /// }
 /// ```
-inline auto val_false(grapher::json_t const & /* unused */) {
-  return [](grapher::json_t const &) -> bool { return false; };
+inline expression_t val_false(grapher::json_t const & /* unused */) {
+  return make_constant(false);
 }
 
-} // namespace grapher::predicates
-
-namespace grapher {
-
-/// \ingroup predicates
-/// Builds predicate and stores it in an std::function object.
-predicate_t get_predicate(grapher::json_t const &constraint) {
+expression_t get_expression(grapher::json_t const &constraint) {
   std::string constraint_type =
       get_as_ref<json_t::string_t const &>(constraint, "type");
 
@@ -245,6 +404,8 @@ predicate_t get_predicate(grapher::json_t const &constraint) {
   REGISTER_PREDICATE(regex);
   REGISTER_PREDICATE(match);
   REGISTER_PREDICATE(streq);
+  REGISTER_PREDICATE(in_set);
+  REGISTER_PREDICATE(range);
   REGISTER_PREDICATE(op_or);
   REGISTER_PREDICATE(op_and);
   REGISTER_PREDICATE(val_true);
@@ -252,6 +413,706 @@ predicate_t get_predicate(grapher::json_t const &constraint) {
 
 #undef REGISTER_PREDICATE
 
+  check(false,
+        fmt::format("Predicate error, invalid type:\n{}", constraint.dump(2)));
+  return make_constant(false);
+}
+
+// =============================================================================
+// Optimization
+
+/// Estimated evaluation cost of an expression, and estimated probability that
+/// it is satisfied.
+struct estimate_t {
+  double cost;
+  double probability;
+};
+
+/// Static estimates of leaf expressions. Exact string and value comparisons
+/// rarely match, regexes are more expensive and are often written to match
+/// broadly.
+inline constexpr estimate_t streq_estimate = {.cost = 1, .probability = .1};
+inline constexpr estimate_t equals_estimate = {.cost = 4, .probability = .1};
+inline constexpr estimate_t regex_estimate = {.cost = 32, .probability = .5};
+inline constexpr estimate_t in_set_estimate = {.cost = 2, .probability = .25};
+inline constexpr estimate_t range_estimate = {.cost = 1, .probability = .5};
+
+estimate_t get_estimate(expression_t const &expression) {
+  switch (expression.opcode) {
+  case constant_op_v:
+    return {.cost = 0, .probability = expression.constant ? 1. : 0.};
+  case streq_op_v:
+    return streq_estimate;
+  case regex_op_v:
+    return regex_estimate;
+  case equals_op_v:
+    return equals_estimate;
+  case in_set_op_v:
+    return in_set_estimate;
+  case range_op_v:
+    return range_estimate;
+  case all_op_v:
+  case any_op_v:
+    break;
+  }
+
+  // Operands are only evaluated until the result is known
+  bool const is_all = expression.opcode == all_op_v;
+  double cost = 0;
+  double undecided_probability = 1;
+  for (expression_t const &operand : expression.operands) {
+    estimate_t const operand_estimate = get_estimate(operand);
+    cost += undecided_probability * operand_estimate.cost;
+    undecided_probability *= is_all ? operand_estimate.probability
+                                    : 1 - operand_estimate.probability;
+  }
+
+  return {.cost = cost,
+          .probability =
+              is_all ? undecided_probability : 1 - undecided_probability};
+}
+
+/// Disjunctions of at least this many string comparisons on the same field
+/// are rewritten into a set lookup.
+inline constexpr std::size_t min_in_set_size = 4;
+
+/// Merges the streq and in_set operands of a disjunction that read the same
+/// field into a single in_set operand, when there are enough of them.
+void merge_string_comparisons(std::vector<expression_t> &operands) {
+  // Counting string comparisons per field, in order of appearance
+  std::vector<std::pair<event_field_t, std::size_t>> comparison_counts;
+  for (expression_t const &operand : operands) {
+    if (operand.opcode != streq_op_v && operand.opcode != in_set_op_v) {
+      continue;
+    }
+    auto it = std::ranges::find(comparison_counts, operand.field,
+                                &std::pair<event_field_t, std::size_t>::first);
+    if (it == comparison_counts.end()) {
+      comparison_counts.emplace_back(operand.field, 0);
+      it = std::prev(comparison_counts.end());
+    }
+    it->second += operand.opcode == streq_op_v ? 1 : operand.elements.size();
+  }
+
+  std::vector<expression_t> merged_operands;
+  std::vector<std::pair<event_field_t, std::size_t>> set_ids;
+  for (expression_t &operand : operands) {
+    bool const is_mergeable =
+        (operand.opcode == streq_op_v || operand.opcode == in_set_op_v) &&
+        std::ranges::find(comparison_counts, operand.field,
+                          &std::pair<event_field_t, std::size_t>::first)
+                ->second >= min_in_set_size;
+    if (!is_mergeable) {
+      merged_operands.push_back(std::move(operand));
+      continue;
+    }
+
+    // The set of a field replaces its first comparison
+    auto set_it = std::ranges::find(
+        set_ids, operand.field, &std::pair<event_field_t, std::size_t>::first);
+    if (set_it == set_ids.end()) {
+      set_ids.emplace_back(operand.field, merged_operands.size());
+      set_it = std::prev(set_ids.end());
+      merged_operands.push_back(make_set_leaf(operand.field, {}));
+    }
+
+    std::vector<event_value_t> &elements =
+        merged_operands[set_it->second].elements;
+    if (operand.opcode == streq_op_v) {
+      elements.push_back({.kind = string_kind_v, .bits = operand.symbol});
+    } else {
+      std::ranges::move(operand.elements, std::back_inserter(elements));
+    }
+  }
+
+  operands = std::move(merged_operands);
+}
+
+/// Merges nested conjunctions and disjunctions, folds constants, rewrites long
+/// disjunctions of string comparisons into set lookups, and orders operands by
+/// increasing cost per decisive evaluation.
+expression_t optimize(expression_t expression) {
+  if (expression.opcode != all_op_v && expression.opcode != any_op_v) {
+    return expression;
+  }
+
+  bool const is_all = expression.opcode == all_op_v;
+
+  std::vector<expression_t> operands;
+  for (expression_t &operand : expression.operands) {
+    expression_t optimized_operand = optimize(std::move(operand));
+
+    if (optimized_operand.opcode == constant_op_v) {
+      // Absorbing element
+      if (optimized_operand.constant != is_all) {
+        return make_constant(!is_all);
+      }
+      // Neutral element
+      continue;
+    }
+
+    if (optimized_operand.opcode == expression.opcode) {
+      std::ranges::move(optimized_operand.operands,
+                        std::back_inserter(operands));
+      continue;
+    }
+
+    operands.push_back(std::move(optimized_operand));
+  }
+
+  if (!is_all) {
+    merge_string_comparisons(operands);
+  }
+
+  if (operands.empty()) {
+    return make_constant(is_all);
+  }
+  if (operands.size() == 1) {
+    return std::move(operands.front());
+  }
+
+  // An operand is decisive when it is false in a conjunction or true in a
+  // disjunction
+  std::vector<std::pair<double, expression_t>> ranked_operands;
+  ranked_operands.reserve(operands.size());
+  for (expression_t &operand : operands) {
+    estimate_t const operand_estimate = get_estimate(operand);
+    double const decisive_probability = is_all
+                                            ? 1 - operand_estimate.probability
+                                            : operand_estimate.probability;
+    ranked_operands.emplace_back(operand_estimate.cost / decisive_probability,
+                                 std::move(operand));
+  }
+  std::ranges::stable_sort(ranked_operands, {},
+                           &std::pair<double, expression_t>::first);
+
+  expression.operands.clear();
+  for (auto &[rank, operand] : ranked_operands) {
+    expression.operands.push_back(std::move(operand));
+  }
+  return expression;
+}
+
+/// Appends the instructions of an expression to a program. Identical patterns
+/// are compiled once.
+void emit(expression_t const &expression, predicate_t::program_t &program,
+          std::map<std::string, std::uint32_t> &pattern_ids) {
+  std::size_t const instruction_id = program.instructions.size();
+  program.instructions.push_back({.opcode = expression.opcode,
+                                  .field = expression.field,
+                                  .symbol = expression.symbol,
+                                  .operand = 0,
+                                  .size = 1});
+
+  switch (expression.opcode) {
+  case constant_op_v:
+    program.instructions[instruction_id].operand = expression.constant;
+    break;
+  case regex_op_v: {
+    std::string const &pattern =
+        expression.value.get_ref<json_t::string_t const &>();
+    auto const [pattern_it, inserted] = pattern_ids.try_emplace(
+        pattern, std::uint32_t(program.patterns.size()));
+    if (inserted) {
+      program.patterns.emplace_back(pattern);
+    }
+    program.instructions[instruction_id].operand = pattern_it->second;
+    break;
+  }
+  case equals_op_v:
+    program.instructions[instruction_id].operand =
+        std::uint32_t(program.values.size());
+    program.values.push_back(expression.value);
+    break;
+  case in_set_op_v: {
+    program.instructions[instruction_id].operand =
+        std::uint32_t(program.sets.size());
+    predicate_set_t &set = program.sets.emplace_back();
+    for (event_value_t const &element : expression.elements) {
+      if (element.is_string()) {
+        set.symbols.insert(element.get_symbol());
+      } else {
+        set.ids.insert(element.bits);
+      }
+    }
+    if (!set.symbols.empty()) {
+      set.symbol_bitmap.resize(std::ranges::max(set.symbols) / 32 + 1, 0);
+      for (symbol_t const symbol : set.symbols) {
+        set.symbol_bitmap[symbol / 32] |= std::uint32_t{1} << (symbol % 32);
+      }
+    }
+    break;
+  }
+  case range_op_v:
+    program.instructions[instruction_id].operand =
+        std::uint32_t(program.ranges.size());
+    program.ranges.push_back(expression.range);
+    break;
+  case streq_op_v:
+  case all_op_v:
+  case any_op_v:
+    break;
+  }
+
+  for (expression_t const &operand : expression.operands) {
+    emit(operand, program, pattern_ids);
+  }
+
+  program.instructions[instruction_id].size =
+      std::uint32_t(program.instructions.size() - instruction_id);
+}
+
+} // namespace grapher::predicates
+
+namespace grapher {
+
+/// Maximum number of fields keying memoized results.
+inline constexpr std::size_t max_memo_fields = 4;
+
+/// Values of the fields read by a predicate, unused fields are absent.
+using memo_key_t = std::array<event_value_t, max_memo_fields>;
+
+struct memo_key_hash_t {
+  std::size_t operator()(memo_key_t const &key) const {
+    std::size_t res = 0;
+    for (event_value_t const &value : key) {
+      std::size_t const value_hash = std::hash<std::uint64_t>{}(
+          value.bits ^ (std::uint64_t(value.kind) << 56));
+      res ^= value_hash + 0x9e3779b97f4a7c15 + (res << 6) + (res >> 2);
+    }
+    return res;
+  }
+};
+
+/// Predicate results memoized by the values of the fields read by the
+/// predicate. Results are split into independently locked shards to limit
+/// contention between threads.
+struct predicate_memo_t {
+  static constexpr std::size_t shard_count = 16;
+
+  /// Results are no longer memoized once a shard is full, so fields with many
+  /// distinct values don't grow the cache without bound
+  static constexpr std::size_t max_shard_size = std::size_t{1} << 16;
+
+  struct shard_t {
+    std::shared_mutex mutex;
+    std::unordered_map<memo_key_t, bool, memo_key_hash_t> results;
+  };
+
+  /// Fields read by the predicate
+  std::vector<event_field_t> fields;
+
+  std::array<shard_t, shard_count> shards;
+};
+
+namespace predicates {
+
+/// Returns a memo for a program, or nullptr if its results can't be keyed by
+/// a few field values.
+std::shared_ptr<predicate_memo_t>
+make_memo(predicate_t::program_t const &program) {
+  auto memo = std::make_shared<predicate_memo_t>();
+
+  for (predicate_instruction_t const &instruction : program.instructions) {
+    switch (instruction.opcode) {
+    case constant_op_v:
+    case all_op_v:
+    case any_op_v:
+      continue;
+
+    // Numbers rarely repeat
+    case range_op_v:
+      warn("Predicate memoization disabled for range predicates.");
+      return nullptr;
+
+    case streq_op_v:
+    case regex_op_v:
+    case equals_op_v:
+    case in_set_op_v:
+      break;
+    }
+
+    if (std::ranges::find(memo->fields, instruction.field) ==
+        memo->fields.end()) {
+      memo->fields.push_back(instruction.field);
+    }
+  }
+
+  if (memo->fields.empty()) {
+    return nullptr;
+  }
+  if (memo->fields.size() > max_memo_fields) {
+    warn(fmt::format("Predicate memoization disabled, predicates reading more "
+                     "than {} fields can't be memoized.",
+                     max_memo_fields));
+    return nullptr;
+  }
+  return memo;
+}
+
+} // namespace predicates
+
+namespace {
+
+/// Converts a number value to double, keeping the sign of integers.
+double get_number(event_value_t const &value) {
+  switch (value.kind) {
+  case integer_kind_v:
+    return double(std::bit_cast<std::int64_t>(value.bits));
+  case float_kind_v:
+    return std::bit_cast<double>(value.bits);
+  default:
+    return double(value.bits);
+  }
+}
+
+/// Returns the bounds of the unsigned integers within a range, or std::nullopt
+/// if there is none. Like the row by row comparisons, bounds are exact for
+/// values up to 2^53.
+std::optional<std::pair<std::uint64_t, std::uint64_t>>
+get_unsigned_bounds(predicate_range_t const &range) {
+  constexpr double unsigned_limit = 18446744073709551616.; // 2^64
+  if (!(range.min <= range.max) || range.max < 0 ||
+      range.min >= unsigned_limit) {
+    return std::nullopt;
+  }
+
+  std::uint64_t const min =
+      range.min <= 0 ? 0 : std::uint64_t(std::ceil(range.min));
+  std::uint64_t const max = range.max >= unsigned_limit
+                                ? std::numeric_limits<std::uint64_t>::max()
+                                : std::uint64_t(std::floor(range.max));
+  if (min > max) {
+    return std::nullopt;
+  }
+  return std::pair{min, max};
+}
+
+} // namespace
+
+bool predicate_t::operator()(grapher::json_t const &event) const {
+  event_table_t table;
+  table.push_event(event);
+  return (*this)(table, 0);
+}
+
+bool predicate_t::evaluate(std::size_t instruction_id,
+                           grapher::event_table_t const &table,
+                           std::size_t row) const {
+  predicate_instruction_t const &instruction =
+      program_->instructions[instruction_id];
+
+  switch (instruction.opcode) {
+  case constant_op_v:
+    return instruction.operand != 0;
+
+  case streq_op_v: {
+    event_value_t const value = table.get(row, instruction.field);
+    return value.is_string() && value.get_symbol() == instruction.symbol;
+  }
+
+  case regex_op_v: {
+    event_value_t const value = table.get(row, instruction.field);
+    return value.is_string() && program_->patterns[instruction.operand](
+                                    get_symbol_string(value.get_symbol()));
+  }
+
+  case equals_op_v: {
+    event_value_t const value = table.get(row, instruction.field);
+    return value.is_present() &&
+           value.to_json() == program_->values[instruction.operand];
+  }
+
+  case in_set_op_v:
+    return program_->sets[instruction.operand].contains(
+        table.get(row, instruction.field));
+
+  case range_op_v: {
+    event_value_t const value = table.get(row, instruction.field);
+    return value.is_number() &&
+           program_->ranges[instruction.operand].contains(get_number(value));
+  }
+
+  case all_op_v:
+  case any_op_v: {
+    // Short-circuit evaluation of the operands
+    bool const is_all = instruction.opcode == all_op_v;
+    std::size_t const end = instruction_id + instruction.size;
+    for (std::size_t operand_id = instruction_id + 1; operand_id < end;
+         operand_id += program_->instructions[operand_id].size) {
+      if (evaluate(operand_id, table, row) != is_all) {
+        return !is_all;
+      }
+    }
+    return is_all;
+  }
+  }
+
+  return false;
+}
+
+bool predicate_t::evaluate_memoized(grapher::event_table_t const &table,
+                                    std::size_t row) const {
+  predicate_memo_t &memo = *program_->memo;
+
+  memo_key_t key = {};
+  for (std::size_t field_id = 0; field_id < memo.fields.size(); field_id++) {
+    key[field_id] = table.get(row, memo.fields[field_id]);
+  }
+
+  predicate_memo_t::shard_t &shard =
+      memo.shards[memo_key_hash_t{}(key) % predicate_memo_t::shard_count];
+  {
+    std::shared_lock const lock(shard.mutex);
+    if (auto const it = shard.results.find(key); it != shard.results.end()) {
+      return it->second;
+    }
+  }
+
+  bool const res = evaluate(0, table, row);
+
+  std::unique_lock const lock(shard.mutex);
+  if (shard.results.size() < predicate_memo_t::max_shard_size) {
+    shard.results.emplace(key, res);
+  }
+  return res;
+}
+
+void predicate_t::evaluate_memoized(grapher::event_table_t const &table,
+                                    std::size_t begin, std::size_t count,
+                                    std::span<std::uint64_t> mask) const {
+  std::size_t const word_count = simd::get_mask_word_count(count);
+  for (std::size_t word_id = 0; word_id < word_count; word_id++) {
+    for (std::uint64_t word = mask[word_id]; word != 0; word &= word - 1) {
+      std::size_t const bit = std::size_t(std::countr_zero(word));
+      if (!evaluate_memoized(table,
+                             begin + word_id * simd::mask_word_bits + bit)) {
+        mask[word_id] &= ~(std::uint64_t{1} << bit);
+      }
+    }
+  }
+}
+
+void predicate_t::evaluate_batch(std::size_t instruction_id,
+                                 grapher::event_table_t const &table,
+                                 std::size_t begin, std::size_t count,
+                                 std::span<std::uint64_t> mask) const {
+  predicate_instruction_t const &instruction =
+      program_->instructions[instruction_id];
+  std::size_t const word_count = simd::get_mask_word_count(count);
+
+  switch (instruction.opcode) {
+  case constant_op_v:
+    if (instruction.operand == 0) {
+      std::fill(mask.begin(), mask.begin() + word_count, std::uint64_t{0});
+    }
+    return;
+
+  case streq_op_v:
+    // Names and details are never stored in the args table, so comparing the
+    // symbols of their columns is enough
+    if ((instruction.field.column == name_column_v ||
+         instruction.field.column == detail_column_v) &&
+        instruction.symbol != no_symbol_v) {
+      std::span<symbol_t const> const column =
+          instruction.field.column == name_column_v ? table.names()
+                                                    : table.details();
+      std::array<std::uint64_t, batch_words> matches;
+      simd::mask_equal(column.subspan(begin, count), instruction.symbol,
+                       matches);
+      for (std::size_t word_id = 0; word_id < word_count; word_id++) {
+        mask[word_id] &= matches[word_id];
+      }
+      return;
+    }
+    break;
+
+  case all_op_v: {
+    // Each operand narrows down the rows evaluated by the next ones
+    std::size_t const end = instruction_id + instruction.size;
+    for (std::size_t operand_id = instruction_id + 1; operand_id < end;
+         operand_id += program_->instructions[operand_id].size) {
+      if (simd::is_empty(mask.first(word_count))) {
+        return;
+      }
+      evaluate_batch(operand_id, table, begin, count, mask);
+    }
+    return;
+  }
+
+  case any_op_v: {
+    // Rows are evaluated by the next operands until one is satisfied
+    std::array<std::uint64_t, batch_words> remaining;
+    std::array<std::uint64_t, batch_words> operand_mask;
+    std::copy(mask.begin(), mask.begin() + word_count, remaining.begin());
+    std::fill(mask.begin(), mask.begin() + word_count, std::uint64_t{0});
+
+    std::size_t const end = instruction_id + instruction.size;
+    for (std::size_t operand_id = instruction_id + 1; operand_id < end;
+         operand_id += program_->instructions[operand_id].size) {
+      if (simd::is_empty(std::span(remaining).first(word_count))) {
+        return;
+      }
+      std::copy(remaining.begin(), remaining.begin() + word_count,
+                operand_mask.begin());
+      evaluate_batch(operand_id, table, begin, count, operand_mask);
+      for (std::size_t word_id = 0; word_id < word_count; word_id++) {
+        mask[word_id] |= operand_mask[word_id];
+        remaining[word_id] &= ~operand_mask[word_id];
+      }
+    }
+    return;
+  }
+
+  case range_op_v:
+    // Rows whose field is stored in a numeric column are compared in bulk,
+    // the others are evaluated row by row below
+    if (instruction.field.column >= ts_column_v &&
+        instruction.field.column < args_column_v) {
+      static_assert(sizeof(value_t) == sizeof(std::uint64_t));
+      std::span<value_t const> const column =
+          table.column(instruction.field.column).subspan(begin, count);
+
+      std::array<std::uint64_t, batch_words> present;
+      simd::mask_any_bits(
+          table.column_masks().subspan(begin, count),
+          event_table_t::get_column_bit(instruction.field.column), present);
+
+      std::array<std::uint64_t, batch_words> in_range = {};
+      if (std::optional<std::pair<std::uint64_t, std::uint64_t>> const bounds =
+              get_unsigned_bounds(program_->ranges[instruction.operand])) {
+        simd::mask_in_range(
+            {reinterpret_cast<std::uint64_t const *>(column.data()),
+             column.size()},
+            bounds->first, bounds->second, in_range);
+      }
+
+      for (std::size_t word_id = 0; word_id < word_count; word_id++) {
+        std::uint64_t const absent = mask[word_id] & ~present[word_id];
+        mask[word_id] &= present[word_id] & in_range[word_id];
+        for (std::uint64_t word = absent; word != 0; word &= word - 1) {
+          std::size_t const bit = std::size_t(std::countr_zero(word));
+          if (evaluate(instruction_id, table,
+                       begin + word_id * simd::mask_word_bits + bit)) {
+            mask[word_id] |= std::uint64_t{1} << bit;
+          }
+        }
+      }
+      return;
+    }
+    break;
+
+  case in_set_op_v:
+    // Strings of names and details are looked up in the set bitmap, rows
+    // without a string may still hold an id in the args table and are
+    // evaluated row by row below
+    if (instruction.field.column == name_column_v ||
+        instruction.field.column == detail_column_v) {
+      predicate_set_t const &set = program_->sets[instruction.operand];
+      std::span<symbol_t const> const column =
+          (instruction.field.column == name_column_v ? table.names()
+                                                     : table.details())
+              .subspan(begin, count);
+
+      std::array<std::uint64_t, batch_words> matches;
+      simd::mask_in_bitmap(column, set.symbol_bitmap, matches);
+
+      std::array<std::uint64_t, batch_words> no_string = {};
+      if (!set.ids.empty()) {
+        simd::mask_equal(column, no_symbol_v, no_string);
+      }
+
+      for (std::size_t word_id = 0; word_id < word_count; word_id++) {
+        std::uint64_t const unknown = mask[word_id] & no_string[word_id];
+        mask[word_id] &= matches[word_id];
+        for (std::uint64_t word = unknown; word != 0; word &= word - 1) {
+          std::size_t const bit = std::size_t(std::countr_zero(word));
+          if (evaluate(instruction_id, table,
+                       begin + word_id * simd::mask_word_bits + bit)) {
+            mask[word_id] |= std::uint64_t{1} << bit;
+          }
+        }
+      }
+      return;
+    }
+    break;
+
+  case regex_op_v:
+  case equals_op_v:
+    break;
+  }
+
+  // Other expressions are evaluated row by row
+  for (std::size_t word_id = 0; word_id < word_count; word_id++) {
+    for (std::uint64_t word = mask[word_id]; word != 0; word &= word - 1) {
+      std::size_t const bit = std::size_t(std::countr_zero(word));
+      if (!evaluate(instruction_id, table,
+                    begin + word_id * simd::mask_word_bits + bit)) {
+        mask[word_id] &= ~(std::uint64_t{1} << bit);
+      }
+    }
+  }
+}
+
+/// \ingroup predicates
+/// Compiles a predicate from its JSON description.
+///
+/// Results of predicates with `"memoize": true` are cached by the values of
+/// the fields they read, so expensive regex and match predicates are only
+/// evaluated once per distinct name or detail:
+/// ```json
+/// {
+///   "type": "regex",
+///   "pointer": "/args/detail",
+///   "regex": ".*boost.*\\.hpp",
+///   "memoize": true
+/// }
+/// ```
+predicate_t get_predicate(grapher::json_t const &constraint) {
+  predicate_t::program_t program;
+  std::map<std::string, std::uint32_t> pattern_ids;
+  predicates::emit(predicates::optimize(predicates::get_expression(constraint)),
+                   program, pattern_ids);
+
+  if (constraint.value("memoize", false)) {
+    program.memo = predicates::make_memo(program);
+  }
+  return predicate_t(std::move(program));
+}
+
+std::vector<grapher::json_t::json_pointer>
+get_predicate_pointers(grapher::json_t const &constraint) {
+  std::string constraint_type =
+      get_as_ref<json_t::string_t const &>(constraint, "type");
+
+  if (constraint_type == "regex" || constraint_type == "streq" ||
+      constraint_type == "in_set" || constraint_type == "range") {
+    return {grapher::json_t::json_pointer{
+        get_as_ref<json_t::string_t const &>(constraint, "pointer")}};
+  }
+
+  if (constraint_type == "match") {
+    std::vector<grapher::json_t::json_pointer> res;
+    grapher::json_t const matcher_flat =
+        get_as_json(constraint, "matcher").flatten();
+    for (auto const &matcher_item_kv : matcher_flat.items()) {
+      res.emplace_back(matcher_item_kv.key());
+    }
+    return res;
+  }
+
+  if (constraint_type == "op_or" || constraint_type == "op_and") {
+    std::vector<grapher::json_t::json_pointer> res =
+        get_predicate_pointers(get_as_json(constraint, "first"));
+    std::ranges::move(get_predicate_pointers(get_as_json(constraint, "second")),
+                      std::back_inserter(res));
+    return res;
+  }
+
+  if (constraint_type == "val_true" || constraint_type == "val_false") {
+    return {};
+  }
+
   check(false,
         fmt::format("Predicate error, invalid type:\n{}", constraint.dump(2)));
   return {};
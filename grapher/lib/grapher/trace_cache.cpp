@@ -0,0 +1,521 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+#include <fmt/core.h>
+
+#include <grapher/trace_cache.hpp>
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/fingerprint.hpp>
+#include <grapher/utils/intern.hpp>
+#include <grapher/utils/mmap.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// Magic number at the beginning of trace cache files
+constexpr std::array<char, 4> cache_magic = {'C', 'T', 'B', 'C'};
+
+/// Trace cache format version, to be bumped on every format change
+constexpr std::uint32_t cache_version = 2;
+
+/// Trace cache file header. All sections that follow the header are aligned
+/// on 8 bytes.
+struct cache_header_t {
+  std::array<char, 4> magic;
+  std::uint32_t version;
+
+  // Source file fingerprint
+  std::uint64_t source_size;
+  std::int64_t source_mtime;
+  std::uint64_t source_hash;
+
+  // Section sizes
+  std::uint64_t event_count;
+  std::uint64_t string_count;
+  std::uint64_t string_data_size;
+  std::uint64_t arg_count;
+};
+
+/// Args table entry. Keys are the JSON pointers of the fields in the event,
+/// kinds are event_value_kind_t values, and string values are string ids.
+struct cache_arg_t {
+  std::uint32_t key;
+  std::uint32_t kind;
+  std::uint64_t value;
+};
+
+/// String id for absent names and details
+constexpr std::uint32_t no_string = ~std::uint32_t{0};
+
+/// Byte offsets of the sections of a trace cache file.
+struct cache_layout_t {
+  std::size_t string_offsets;
+  std::size_t string_data;
+  std::size_t names;
+  std::size_t details;
+  std::size_t column_masks;
+  std::array<std::size_t, 4> numeric_columns;
+  std::size_t arg_offsets;
+  std::size_t args;
+  std::size_t total_size;
+};
+
+constexpr std::size_t align_section(std::size_t size) {
+  constexpr std::size_t section_alignment = 8;
+  return (size + section_alignment - 1) & ~(section_alignment - 1);
+}
+
+cache_layout_t get_layout(cache_header_t const &header) {
+  std::size_t const event_count = header.event_count;
+  cache_layout_t layout{};
+
+  std::size_t offset = align_section(sizeof(cache_header_t));
+  auto next_section = [&](std::size_t section_size) {
+    std::size_t const section_offset = offset;
+    offset += align_section(section_size);
+    return section_offset;
+  };
+
+  layout.string_offsets =
+      next_section((header.string_count + 1) * sizeof(std::uint64_t));
+  layout.string_data = next_section(header.string_data_size);
+  layout.names = next_section(event_count * sizeof(std::uint32_t));
+  layout.details = next_section(event_count * sizeof(std::uint32_t));
+  layout.column_masks = next_section(event_count * sizeof(std::uint8_t));
+  for (std::size_t &numeric_column : layout.numeric_columns) {
+    numeric_column = next_section(event_count * sizeof(std::uint64_t));
+  }
+  layout.arg_offsets =
+      next_section((event_count + 1) * sizeof(std::uint64_t));
+  layout.args = next_section(header.arg_count * sizeof(cache_arg_t));
+  layout.total_size = offset;
+
+  return layout;
+}
+
+/// Returns a typed view on a section of a mapped cache file.
+template <typename T>
+std::span<T const> get_section(std::string_view data, std::size_t offset,
+                               std::size_t count) {
+  return {reinterpret_cast<T const *>(data.data() + offset), count};
+}
+
+/// Appends a section to a cache file, padding it to the section alignment.
+template <typename T>
+void write_section(std::ofstream &output, std::span<T const> section) {
+  std::size_t const byte_size = section.size_bytes();
+  output.write(reinterpret_cast<char const *>(section.data()),
+               static_cast<std::streamsize>(byte_size));
+
+  constexpr std::array<char, 8> padding{};
+  output.write(padding.data(), static_cast<std::streamsize>(
+                                   align_section(byte_size) - byte_size));
+}
+
+/// String table of a cache file being written. Maps symbols to string ids.
+struct string_table_t {
+  std::vector<std::string_view> strings;
+  std::unordered_map<symbol_t, std::uint32_t> ids;
+
+  std::uint32_t get_id(symbol_t symbol) {
+    if (symbol == no_symbol_v) {
+      return no_string;
+    }
+
+    auto const [it, inserted] =
+        ids.try_emplace(symbol, static_cast<std::uint32_t>(strings.size()));
+    if (inserted) {
+      strings.push_back(get_symbol_string(symbol));
+    }
+    return it->second;
+  }
+};
+
+/// Numeric columns in file order
+constexpr std::array<event_column_t, 4> numeric_columns = {
+    ts_column_v, dur_column_v, pid_column_v, tid_column_v};
+
+/// Typed views on the sections of a mapped cache file.
+struct cache_sections_t {
+  std::span<std::uint64_t const> string_offsets;
+  std::span<char const> string_data;
+  std::span<std::uint32_t const> names;
+  std::span<std::uint32_t const> details;
+  std::span<std::uint8_t const> column_masks;
+  std::array<std::span<std::uint64_t const>, numeric_columns.size()>
+      numeric_values;
+  std::span<std::uint64_t const> arg_offsets;
+  std::span<cache_arg_t const> args;
+};
+
+cache_sections_t get_sections(std::string_view data,
+                              cache_header_t const &header,
+                              cache_layout_t const &layout) {
+  std::size_t const event_count = header.event_count;
+
+  cache_sections_t res{
+      .string_offsets = get_section<std::uint64_t>(
+          data, layout.string_offsets, header.string_count + 1),
+      .string_data =
+          get_section<char>(data, layout.string_data, header.string_data_size),
+      .names = get_section<std::uint32_t>(data, layout.names, event_count),
+      .details = get_section<std::uint32_t>(data, layout.details, event_count),
+      .column_masks =
+          get_section<std::uint8_t>(data, layout.column_masks, event_count),
+      .numeric_values = {},
+      .arg_offsets = get_section<std::uint64_t>(data, layout.arg_offsets,
+                                                event_count + 1),
+      .args = get_section<cache_arg_t>(data, layout.args, header.arg_count)};
+
+  for (std::size_t i = 0; i < numeric_columns.size(); i++) {
+    res.numeric_values[i] = get_section<std::uint64_t>(
+        data, layout.numeric_columns[i], event_count);
+  }
+
+  return res;
+}
+
+/// Returns true if offsets start at 0, never decrease, and end at size.
+bool is_valid_offsets(std::span<std::uint64_t const> offsets,
+                      std::uint64_t size) {
+  return offsets.front() == 0 && offsets.back() == size &&
+         std::ranges::is_sorted(offsets);
+}
+
+/// Checks that all string ids and offsets of a cache file are in bounds, so
+/// corrupt files are treated as cache misses.
+bool is_valid(cache_sections_t const &sections, cache_header_t const &header) {
+  if (!is_valid_offsets(sections.string_offsets, header.string_data_size) ||
+      !is_valid_offsets(sections.arg_offsets, header.arg_count)) {
+    return false;
+  }
+
+  auto is_string_id = [&](std::uint64_t string_id) {
+    return string_id < header.string_count;
+  };
+  auto is_optional_string_id = [&](std::uint32_t string_id) {
+    return string_id == no_string || is_string_id(string_id);
+  };
+
+  return std::ranges::all_of(sections.names, is_optional_string_id) &&
+         std::ranges::all_of(sections.details, is_optional_string_id) &&
+         std::ranges::all_of(sections.args, [&](cache_arg_t const &arg) {
+           return is_string_id(arg.key) && arg.kind != absent_kind_v &&
+                  arg.kind <= string_kind_v &&
+                  (arg.kind != string_kind_v || is_string_id(arg.value));
+         });
+}
+
+/// Overwrites the source modification time in the header of the cache file
+/// of a time-trace file. Readers either see the previous or the new time, and
+/// hash the source file again if it doesn't match.
+bool write_source_mtime(std::filesystem::path const &path,
+                        std::int64_t source_mtime) {
+  std::fstream output(get_trace_cache_path(path),
+                      std::ios::binary | std::ios::in | std::ios::out);
+  output.seekp(offsetof(cache_header_t, source_mtime));
+  output.write(reinterpret_cast<char const *>(&source_mtime),
+               sizeof(source_mtime));
+  return output.good();
+}
+
+} // namespace
+
+std::filesystem::path get_trace_cache_path(std::filesystem::path const &path) {
+  std::filesystem::path res = path;
+  res += trace_cache_extension;
+  return res;
+}
+
+bool is_trace_cache_path(std::filesystem::path const &path) {
+  return path.extension() == trace_cache_extension;
+}
+
+bool write_trace_cache(std::filesystem::path const &path,
+                       event_table_t const &events) {
+  ZoneScoped;
+
+  std::optional<file_stamp_t> const stamp = get_file_stamp(path);
+  if (!stamp) {
+    return false;
+  }
+
+  std::optional<std::uint64_t> const source_hash = hash_file(path);
+  if (!source_hash) {
+    return false;
+  }
+
+  // Building columns with string ids instead of symbols
+
+  string_table_t string_table;
+
+  std::vector<std::uint32_t> names;
+  std::vector<std::uint32_t> details;
+  std::vector<std::uint8_t> column_masks;
+  std::array<std::vector<std::uint64_t>, numeric_columns.size()>
+      numeric_values;
+  std::vector<std::uint64_t> arg_offsets{0};
+  std::vector<cache_arg_t> args;
+
+  std::size_t const event_count = events.size();
+  names.reserve(event_count);
+  details.reserve(event_count);
+  column_masks.reserve(event_count);
+
+  for (std::size_t row = 0; row < event_count; row++) {
+    names.push_back(string_table.get_id(events.names()[row]));
+    details.push_back(string_table.get_id(events.details()[row]));
+
+    std::uint8_t column_mask = 0;
+    for (std::size_t i = 0; i < numeric_columns.size(); i++) {
+      event_value_t const value =
+          events.get(row, {.column = numeric_columns[i], .key = no_symbol_v});
+      column_mask |= value.is_present()
+                         ? event_table_t::get_column_bit(numeric_columns[i])
+                         : 0;
+      numeric_values[i].push_back(value.bits);
+    }
+    column_masks.push_back(column_mask);
+
+    for (event_arg_t const &arg : events.get_args(row)) {
+      args.push_back({.key = string_table.get_id(arg.key),
+                      .kind = arg.value.kind,
+                      .value = arg.value.is_string()
+                                   ? string_table.get_id(arg.value.get_symbol())
+                                   : arg.value.bits});
+    }
+    arg_offsets.push_back(args.size());
+  }
+
+  // String table serialization
+  std::vector<std::uint64_t> string_offsets{0};
+  std::string string_data;
+  for (std::string_view const str : string_table.strings) {
+    string_data += str;
+    string_offsets.push_back(string_data.size());
+  }
+
+  cache_header_t const header{.magic = cache_magic,
+                              .version = cache_version,
+                              .source_size = stamp->size,
+                              .source_mtime = stamp->mtime,
+                              .source_hash = *source_hash,
+                              .event_count = names.size(),
+                              .string_count = string_table.strings.size(),
+                              .string_data_size = string_data.size(),
+                              .arg_count = args.size()};
+
+  // Writing to a temporary file first so concurrent readers never see a
+  // partially written cache file
+  std::filesystem::path const cache_path = get_trace_cache_path(path);
+  std::filesystem::path temporary_path = cache_path;
+  temporary_path += fmt::format(".{}.tmp", ::getpid());
+
+  {
+    std::ofstream output(temporary_path, std::ios::binary);
+    if (!output) {
+      return false;
+    }
+
+    write_section(output, std::span<cache_header_t const>(&header, 1));
+    write_section(output, std::span<std::uint64_t const>(string_offsets));
+    write_section(output, std::span<char const>(string_data));
+    write_section(output, std::span<std::uint32_t const>(names));
+    write_section(output, std::span<std::uint32_t const>(details));
+    write_section(output, std::span<std::uint8_t const>(column_masks));
+    for (std::vector<std::uint64_t> const &column : numeric_values) {
+      write_section(output, std::span<std::uint64_t const>(column));
+    }
+    write_section(output, std::span<std::uint64_t const>(arg_offsets));
+    write_section(output, std::span<cache_arg_t const>(args));
+
+    if (!output) {
+      std::filesystem::remove(temporary_path);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, cache_path, error);
+  return !error;
+}
+
+std::optional<event_table_t>
+read_trace_cache(std::filesystem::path const &path,
+                 trace_projection_t const &projection) {
+  ZoneScoped;
+
+  mapped_file_t const cache_file(get_trace_cache_path(path));
+  std::string_view const data = cache_file.data();
+
+  if (!cache_file.is_open() || data.size() < sizeof(cache_header_t)) {
+    return std::nullopt;
+  }
+
+  cache_header_t header;
+  std::memcpy(&header, data.data(), sizeof(cache_header_t));
+
+  // Every element takes at least a byte, larger counts are corrupt and could
+  // overflow section sizes
+  if (header.event_count > data.size() || header.string_count > data.size() ||
+      header.string_data_size > data.size() ||
+      header.arg_count > data.size()) {
+    return std::nullopt;
+  }
+
+  cache_layout_t const layout = get_layout(header);
+  if (header.magic != cache_magic || header.version != cache_version ||
+      layout.total_size != data.size()) {
+    return std::nullopt;
+  }
+
+  // Source file validation: size must match, and content must match if the
+  // modification time changed
+  {
+    std::optional<file_stamp_t> const stamp = get_file_stamp(path);
+    if (!stamp || stamp->size != header.source_size) {
+      return std::nullopt;
+    }
+
+    if (stamp->mtime != header.source_mtime) {
+      if (hash_file(path) != header.source_hash) {
+        return std::nullopt;
+      }
+
+      // Refreshing the stamp avoids hashing the file again on the next run
+      check(write_source_mtime(path, stamp->mtime),
+            fmt::format("Could not update trace cache file for {}.",
+                        path.string()),
+            info_v);
+    }
+  }
+
+  // Section views, validated once so rows can be read without bounds checks
+
+  std::size_t const event_count = header.event_count;
+  cache_sections_t const sections = get_sections(data, header, layout);
+  if (!is_valid(sections, header)) {
+    return std::nullopt;
+  }
+
+  auto const &string_offsets = sections.string_offsets;
+  auto const &string_data = sections.string_data;
+  auto const &names = sections.names;
+  auto const &details = sections.details;
+  auto const &column_masks = sections.column_masks;
+  auto const &numeric_values = sections.numeric_values;
+  auto const &arg_offsets = sections.arg_offsets;
+  auto const &args = sections.args;
+
+  // String ids are interned on first use
+  std::vector<symbol_t> symbols(header.string_count, no_symbol_v);
+  auto get_symbol = [&](std::uint64_t string_id) -> symbol_t {
+    if (symbols[string_id] == no_symbol_v) {
+      symbols[string_id] = intern(
+          {string_data.data() + string_offsets[string_id],
+           string_offsets[string_id + 1] - string_offsets[string_id]});
+    }
+    return symbols[string_id];
+  };
+
+  // Projection, evaluated once per column and per args key
+
+  std::array<std::optional<event_field_t>, args_column_v> column_fields;
+  for (std::size_t column_id = 0; column_id < column_fields.size();
+       column_id++) {
+    if (is_projected(event_column_pointers[column_id], projection)) {
+      column_fields[column_id] =
+          event_field_t::resolve(event_column_pointers[column_id]);
+    }
+  }
+
+  std::vector<std::optional<event_field_t>> arg_fields(header.string_count);
+  std::vector<bool> arg_field_resolved(header.string_count, false);
+
+  auto get_arg_field =
+      [&](std::uint32_t key) -> std::optional<event_field_t> const & {
+    if (!arg_field_resolved[key]) {
+      std::string const &key_string = get_symbol_string(get_symbol(key));
+      if (is_projected(key_string, projection)) {
+        arg_fields[key] = event_field_t::resolve(key_string);
+      }
+      arg_field_resolved[key] = true;
+    }
+    return arg_fields[key];
+  };
+
+  // Event table building
+
+  event_table_t events;
+  for (std::size_t row = 0; row < event_count; row++) {
+    events.push_row();
+
+    if (column_fields[name_column_v] && names[row] != no_string) {
+      events.set(*column_fields[name_column_v],
+                 {.kind = string_kind_v, .bits = get_symbol(names[row])});
+    }
+
+    if (column_fields[detail_column_v] && details[row] != no_string) {
+      events.set(*column_fields[detail_column_v],
+                 {.kind = string_kind_v, .bits = get_symbol(details[row])});
+    }
+
+    for (std::size_t i = 0; i < numeric_columns.size(); i++) {
+      if (column_fields[numeric_columns[i]] &&
+          (column_masks[row] &
+           event_table_t::get_column_bit(numeric_columns[i])) != 0) {
+        events.set(*column_fields[numeric_columns[i]],
+                   {.kind = unsigned_kind_v, .bits = numeric_values[i][row]});
+      }
+    }
+
+    for (cache_arg_t const &arg : args.subspan(
+             arg_offsets[row], arg_offsets[row + 1] - arg_offsets[row])) {
+      if (std::optional<event_field_t> const &field = get_arg_field(arg.key)) {
+        event_value_kind_t const kind =
+            static_cast<event_value_kind_t>(arg.kind);
+        events.set(*field,
+                   {.kind = kind,
+                    .bits = kind == string_kind_v ? get_symbol(arg.value)
+                                                  : arg.value});
+      }
+    }
+
+    if (!is_selected(events, events.size() - 1, projection)) {
+      events.pop_row();
+    }
+  }
+
+  return events;
+}
+
+event_table_t read_cached_trace_events(std::filesystem::path const &path,
+                                       trace_projection_t const &projection) {
+  if (std::optional<event_table_t> cached_events =
+          read_trace_cache(path, projection)) {
+    return std::move(*cached_events);
+  }
+
+  // Cache files store whole events so they can be reused by any plotter
+  event_table_t events = read_trace_events(path);
+  check(write_trace_cache(path, events),
+        fmt::format("Could not write trace cache file for {}.", path.string()),
+        info_v);
+
+  return project_events(events, projection);
+}
+
+} // namespace grapher
@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include <nlohmann/json.hpp>
+
+#include <grapher/trace_reader.hpp>
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/intern.hpp>
+#include <grapher/utils/mmap.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// SAX handler that extracts the projection of the events contained in the
+/// traceEvents array of a time-trace document. Everything else is skipped.
+class trace_events_sax_t {
+public:
+  trace_events_sax_t(trace_projection_t const &projection,
+                     event_table_t &output)
+      : projection_(projection), output_(output) {
+    // Fields are kept if their path is projected, and objects are traversed
+    // if their path is a prefix of a projected path.
+    for (grapher::json_t::json_pointer const &pointer : projection.pointers) {
+      std::string const path = pointer.to_string();
+      kept_paths_.insert(path);
+      for (std::size_t slash_position = path.find('/', 1);
+           slash_position != std::string::npos;
+           slash_position = path.find('/', slash_position + 1)) {
+        traversed_paths_.insert(path.substr(0, slash_position));
+      }
+    }
+  }
+
+  // Scalar values
+
+  bool null() { return value(nullptr); }
+  bool boolean(bool val) { return value(val); }
+  bool number_integer(grapher::json_t::number_integer_t val) {
+    return value(val);
+  }
+  bool number_unsigned(grapher::json_t::number_unsigned_t val) {
+    return value(val);
+  }
+  bool number_float(grapher::json_t::number_float_t val,
+                    grapher::json_t::string_t const & /* unused */) {
+    return value(val);
+  }
+  bool string(grapher::json_t::string_t &val) { return value(std::move(val)); }
+  bool binary(grapher::json_t::binary_t &val) { return value(std::move(val)); }
+
+  // Structure
+
+  bool start_object(std::size_t /* unused */) {
+    if (!event_levels_.empty()) {
+      return start_container(grapher::json_t::object());
+    }
+
+    // New event in the traceEvents array
+    if (document_depth_ == events_array_depth && in_events_array_) {
+      current_event_ = grapher::json_t::object();
+      event_levels_.push_back({.container = &current_event_,
+                               .state = projection_.keep_all_fields
+                                            ? field_state_t::keep
+                                            : field_state_t::traverse});
+      return true;
+    }
+
+    document_depth_++;
+    return true;
+  }
+
+  bool key(grapher::json_t::string_t &val) {
+    if (event_levels_.empty()) {
+      // Looking for the traceEvents array in the root object
+      next_is_events_array_ =
+          document_depth_ == root_depth && val == "traceEvents";
+      return true;
+    }
+
+    level_t &level = event_levels_.back();
+    switch (level.state) {
+    case field_state_t::skip:
+      break;
+    case field_state_t::keep:
+      level.key_state = field_state_t::keep;
+      break;
+    case field_state_t::traverse:
+      level.key_path = level.path;
+      append_reference_token(level.key_path, val);
+      level.key_state = kept_paths_.contains(level.key_path)
+                            ? field_state_t::keep
+                        : traversed_paths_.contains(level.key_path)
+                            ? field_state_t::traverse
+                            : field_state_t::skip;
+      break;
+    }
+    level.key = std::move(val);
+    return true;
+  }
+
+  bool end_object() {
+    if (event_levels_.empty()) {
+      document_depth_--;
+      return true;
+    }
+
+    event_levels_.pop_back();
+    if (event_levels_.empty()) {
+      end_event();
+    }
+    return true;
+  }
+
+  bool start_array(std::size_t /* unused */) {
+    if (!event_levels_.empty()) {
+      return start_container(grapher::json_t::array());
+    }
+
+    document_depth_++;
+    if (document_depth_ == events_array_depth && next_is_events_array_) {
+      in_events_array_ = true;
+      found_events_array_ = true;
+    }
+    return true;
+  }
+
+  bool end_array() {
+    if (event_levels_.empty()) {
+      if (document_depth_ == events_array_depth) {
+        in_events_array_ = false;
+      }
+      document_depth_--;
+      return true;
+    }
+
+    event_levels_.pop_back();
+    return true;
+  }
+
+  bool parse_error(std::size_t position, std::string const &last_token,
+                   grapher::json_t::exception const & /* unused */) {
+    error_message_ =
+        fmt::format("syntax error at byte {} near '{}'", position, last_token);
+    return false;
+  }
+
+  std::string const &error_message() const { return error_message_; }
+
+  /// Returns true if the traceEvents array was found in the document.
+  bool found_events_array() const { return found_events_array_; }
+
+private:
+  /// Root object depth in the document
+  static constexpr unsigned root_depth = 1;
+
+  /// traceEvents array depth in the document
+  static constexpr unsigned events_array_depth = 2;
+
+  /// Projection state of a field or object.
+  enum struct field_state_t : std::uint8_t {
+    /// Field is not projected
+    skip,
+    /// Field is projected along with all of its children
+    keep,
+    /// Object is on the path to a projected field
+    traverse,
+  };
+
+  /// Container being parsed within an event.
+  struct level_t {
+    /// Materialized container, nullptr if skipped
+    grapher::json_t *container = nullptr;
+    /// Projection state of the container
+    field_state_t state = field_state_t::skip;
+    /// JSON pointer of the container (only for traversed objects)
+    std::string path = {};
+    /// Last key read in an object
+    std::string key = {};
+    /// JSON pointer of the last key (only for traversed objects)
+    std::string key_path = {};
+    /// Projection state of the last key read in an object
+    field_state_t key_state = field_state_t::skip;
+  };
+
+  /// Returns the state of the next value at the current level.
+  field_state_t next_value_state() const {
+    level_t const &level = event_levels_.back();
+    if (level.container == nullptr) {
+      return field_state_t::skip;
+    }
+    return level.container->is_object() ? level.key_state : level.state;
+  }
+
+  /// Inserts a value at the current level, returns a pointer to it.
+  grapher::json_t *insert(grapher::json_t &&val) {
+    level_t &level = event_levels_.back();
+    if (level.container->is_object()) {
+      return &((*level.container)[level.key] = std::move(val));
+    }
+    level.container->push_back(std::move(val));
+    return &level.container->back();
+  }
+
+  template <typename ValueType> bool value(ValueType &&val) {
+    // Only kept values are materialized. Scalar values that are reached
+    // through a traversed path do not match the projection.
+    if (!event_levels_.empty() &&
+        next_value_state() == field_state_t::keep) {
+      insert(grapher::json_t(std::forward<ValueType>(val)));
+    }
+    return true;
+  }
+
+  bool start_container(grapher::json_t &&container) {
+    field_state_t state = next_value_state();
+
+    // Array elements are kept whole to preserve their indices
+    if (state == field_state_t::traverse && container.is_array()) {
+      state = field_state_t::keep;
+    }
+
+    if (state == field_state_t::skip) {
+      event_levels_.push_back({});
+      return true;
+    }
+
+    std::string path =
+        state == field_state_t::traverse ? event_levels_.back().key_path : "";
+    event_levels_.push_back({.container = insert(std::move(container)),
+                             .state = state,
+                             .path = std::move(path)});
+    return true;
+  }
+
+  /// Called when the current event is complete, stores it in the output table
+  /// if it is selected.
+  void end_event() {
+    output_.push_event(current_event_);
+    if (!is_selected(output_, output_.size() - 1, projection_)) {
+      output_.pop_row();
+    }
+    current_event_ = nullptr;
+  }
+
+  trace_projection_t const &projection_;
+  event_table_t &output_;
+
+  std::unordered_set<std::string> kept_paths_;
+  std::unordered_set<std::string> traversed_paths_;
+
+  unsigned document_depth_ = 0;
+  bool next_is_events_array_ = false;
+  bool in_events_array_ = false;
+  bool found_events_array_ = false;
+
+  grapher::json_t current_event_;
+  std::vector<level_t> event_levels_;
+
+  std::string error_message_;
+};
+
+} // namespace
+
+bool is_selected(event_table_t const &events, std::size_t row,
+                 trace_projection_t const &projection) {
+  return projection.filters.empty() ||
+         std::ranges::any_of(projection.filters,
+                             [&](std::vector<predicate_t> const &filter) {
+                               return std::ranges::all_of(
+                                   filter, [&](predicate_t const &predicate) {
+                                     return predicate(events, row);
+                                   });
+                             });
+}
+
+bool is_projected(std::string_view pointer,
+                  trace_projection_t const &projection) {
+  return projection.keep_all_fields ||
+         std::ranges::any_of(
+             projection.pointers,
+             [&](grapher::json_t::json_pointer const &projected_pointer) {
+               std::string const projected = projected_pointer.to_string();
+               return pointer.starts_with(projected) &&
+                      (pointer.size() == projected.size() ||
+                       pointer[projected.size()] == '/');
+             });
+}
+
+event_table_t project_events(event_table_t const &events,
+                             trace_projection_t const &projection) {
+  ZoneScoped;
+
+  // Column fields and their projection
+  std::vector<event_field_t> projected_columns;
+  for (std::string_view const pointer : event_column_pointers) {
+    if (is_projected(pointer, projection)) {
+      projected_columns.push_back(event_field_t::resolve(pointer));
+    }
+  }
+
+  // Projection of args keys, evaluated once per key
+  std::unordered_map<symbol_t, bool> projected_args;
+
+  event_table_t res;
+  for (std::size_t row = 0; row < events.size(); row++) {
+    if (!is_selected(events, row, projection)) {
+      continue;
+    }
+
+    if (projection.keep_all_fields) {
+      res.push_event(events, row);
+      continue;
+    }
+
+    res.push_row();
+    for (event_field_t const &field : projected_columns) {
+      // Fields that don't fit their column are read from the args below
+      if (event_value_t const value =
+              events.get(row, {.column = field.column, .key = no_symbol_v});
+          value.is_present()) {
+        res.set(field, value);
+      }
+    }
+
+    for (event_arg_t const &arg : events.get_args(row)) {
+      auto [it, inserted] = projected_args.try_emplace(arg.key, false);
+      if (inserted) {
+        it->second = is_projected(get_symbol_string(arg.key), projection);
+      }
+      if (it->second) {
+        res.set(event_field_t::resolve(get_symbol_string(arg.key)), arg.value);
+      }
+    }
+  }
+
+  return res;
+}
+
+event_table_t read_trace_events(std::filesystem::path const &path,
+                                trace_projection_t const &projection,
+                                trace_input_t input) {
+  ZoneScoped;
+
+  event_table_t events;
+  trace_events_sax_t sax(projection, events);
+  bool parsed;
+
+  if (mapped_file_t const mapped_file =
+          input == mapped_input_v ? mapped_file_t(path) : mapped_file_t();
+      mapped_file.is_open()) {
+    // Parsing straight from the mapped pages, which are read only once
+    mapped_file.advise_sequential();
+    std::string_view const data = mapped_file.data();
+    parsed = grapher::json_t::sax_parse(data.begin(), data.end(), &sax);
+  } else {
+    std::ifstream repetition_ifstream(path);
+    check(bool(repetition_ifstream),
+          fmt::format("Can't open time-trace file: {}", path.string()));
+    parsed = grapher::json_t::sax_parse(repetition_ifstream, &sax);
+  }
+
+  check(parsed, fmt::format("Invalid time-trace file {}: {}", path.string(),
+                            sax.error_message()));
+
+  // Truncated or foreign JSON files would otherwise yield empty plots
+  check(sax.found_events_array(),
+        fmt::format("No traceEvents array in time-trace file {}.",
+                    path.string()),
+        warning_v);
+
+  return events;
+}
+
+} // namespace grapher
@@ -1,26 +1,178 @@
 #include <algorithm>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <optional>
+#include <unordered_map>
 
 #include <llvm/Support/raw_ostream.h>
 
 #include <fmt/core.h>
 
+#include <grapher/event_store.hpp>
+#include <grapher/trace_cache.hpp>
 #include <grapher/utils/cli.hpp>
 #include <grapher/utils/error.hpp>
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/tracy.hpp>
 
 namespace grapher {
 
+namespace {
+
+namespace fs = std::filesystem;
+
+/// Instance directory of a benchmark, scanned for repetition files.
+struct instance_directory_t {
+  std::size_t bench_id;
+  std::size_t instance_id;
+  fs::path path;
+
+  /// Warnings raised while scanning, reported once scanning is over
+  std::vector<std::string> warnings;
+};
+
+/// Reads a benchmark size from an instance directory name.
+std::optional<unsigned> parse_size(fs::path const &instance_path) {
+  std::string const name = instance_path.filename().stem();
+
+  unsigned size;
+  auto const [end, error] =
+      std::from_chars(name.data(), name.data() + name.size(), size);
+  if (error != std::errc{}) {
+    return std::nullopt;
+  }
+  return size;
+}
+
+/// Reads the instances of a benchmark from its index. Returns std::nullopt if
+/// there is no valid index, or if it lists missing files.
+std::optional<std::vector<benchmark_instance_t>>
+read_benchmark_index(fs::path const &bench_path) {
+  ZoneScoped;
+
+  fs::path const index_path = bench_path / benchmark_index_filename;
+  std::ifstream index_file(index_path);
+  if (!index_file) {
+    return std::nullopt;
+  }
+
+  grapher::json_t const index = grapher::json_t::parse(index_file, nullptr,
+                                                        false);
+  if (index.is_discarded() || !index.is_object() ||
+      !index.contains("repetitions") || !index["repetitions"].is_array()) {
+    warn(fmt::format("Invalid benchmark index: {}.", index_path.string()));
+    return std::nullopt;
+  }
+
+  std::vector<benchmark_instance_t> instances;
+  std::unordered_map<unsigned, std::size_t> instance_ids;
+
+  for (grapher::json_t const &repetition : index["repetitions"]) {
+    if (!repetition.is_object() || !repetition.contains("size") ||
+        !repetition["size"].is_number_unsigned() ||
+        !repetition.contains("path") || !repetition["path"].is_string()) {
+      warn(fmt::format("Invalid benchmark index entry in {}: {}.",
+                       index_path.string(), repetition.dump()));
+      return std::nullopt;
+    }
+
+    unsigned const size = repetition["size"].get<unsigned>();
+    auto const [instance_it, inserted] =
+        instance_ids.try_emplace(size, instances.size());
+    if (inserted) {
+      instances.push_back({.size = size, .repetitions = {}, .events = {}});
+    }
+
+    instances[instance_it->second].repetitions.push_back(
+        bench_path /
+        repetition["path"].get_ref<grapher::json_t::string_t const &>());
+  }
+
+  // An index listing missing files is out of date, the directory is scanned
+  // instead of failing later when reading the files
+  std::vector<fs::path const *> repetition_paths;
+  for (benchmark_instance_t const &instance : instances) {
+    for (fs::path const &repetition_path : instance.repetitions) {
+      repetition_paths.push_back(&repetition_path);
+    }
+  }
+
+  std::vector<char> is_found(repetition_paths.size(), false);
+  parallel_for(repetition_paths.size(), [&](std::size_t i) {
+    std::error_code error;
+    is_found[i] = fs::is_regular_file(*repetition_paths[i], error);
+  });
+
+  if (auto const missing_it = std::ranges::find(is_found, false);
+      missing_it != is_found.end()) {
+    fs::path const &missing_path =
+        *repetition_paths[std::size_t(missing_it - is_found.begin())];
+    warn(fmt::format("Benchmark index {} lists a missing repetition file: {}. "
+                     "Scanning the benchmark directory instead.",
+                     index_path.string(), missing_path.string()));
+    return std::nullopt;
+  }
+
+  return instances;
+}
+
+/// Lists the repetition files of an instance directory. Entry types are read
+/// from the directory listing when possible instead of calling stat.
+void scan_instance_directory(instance_directory_t &instance_directory,
+                             benchmark_instance_t &instance) {
+  std::error_code error;
+  for (fs::recursive_directory_iterator
+           it(instance_directory.path, error),
+       end;
+       !error && it != end; it.increment(error)) {
+    fs::directory_entry const &entry = *it;
+
+    // Basic property check
+    if (entry.is_directory(error)) {
+      continue;
+    }
+    if (!entry.is_regular_file(error)) {
+      instance_directory.warnings.push_back(fmt::format(
+          "Invalid repetition file (not a regular file): {} (current path: "
+          "{}).",
+          entry.path().string(), fs::current_path().string()));
+      continue;
+    }
+
+    // Trace cache files live next to the files they cache
+    if (is_trace_cache_path(entry.path())) {
+      continue;
+    }
+
+    // Adding path
+    instance.repetitions.push_back(entry.path());
+  }
+
+  if (error) {
+    instance_directory.warnings.push_back(
+        fmt::format("Could not scan {}: {}.", instance_directory.path.string(),
+                    error.message()));
+  }
+}
+
+} // namespace
+
 grapher::benchmark_set_t
-build_category(llvm::cl::list<std::string> const &benchmark_path_list) {
-  namespace fs = std::filesystem;
+build_category(std::vector<fs::path> const &benchmark_paths,
+               trace_projection_t projection, bool use_trace_cache) {
+  ZoneScoped;
 
-  // Filling in benchmark set
+  // Shared by all the event stores
+  auto const projection_ptr =
+      std::make_shared<trace_projection_t const>(std::move(projection));
+
+  // Filling in benchmark set. Instance directories of benchmarks without an
+  // index are listed first, and scanned in parallel afterwards.
   grapher::benchmark_set_t bset;
-  for (auto const &bench_path_str : benchmark_path_list) {
-    fs::path bench_path(bench_path_str.data());
+  std::vector<instance_directory_t> instance_directories;
 
+  for (fs::path const &bench_path : benchmark_paths) {
     if (!fs::is_directory(bench_path)) {
       warn(fmt::format("Not a directory: {} (current path: {}).",
                        bench_path.string(), fs::current_path().string()));
@@ -32,49 +184,78 @@ build_category(llvm::cl::list<std::string> const &benchmark_path_list) {
     // Reading benchmark name from benchmark directory path
     bench.name = bench_path.filename();
 
+    if (std::optional<std::vector<benchmark_instance_t>> instances =
+            read_benchmark_index(bench_path)) {
+      bench.instances = std::move(*instances);
+      bset.push_back(std::move(bench));
+      continue;
+    }
+
     // Adding entries
-    for (auto const &entry_dir : fs::directory_iterator(bench_path)) {
-      grapher::benchmark_instance_t instance;
+    for (fs::directory_entry const &entry_dir :
+         fs::directory_iterator(bench_path)) {
+      if (entry_dir.path().filename() == benchmark_index_filename) {
+        continue;
+      }
 
       // Entry directory name check and reading to entry size
-      {
-        std::istringstream iss(entry_dir.path().filename().stem());
-        if (!(iss >> instance.size)) {
-          warn(fmt::format(
-              "Entry directory name is not a size: {} (current path: {}).",
-              entry_dir.path().string(), fs::current_path().string()));
-          continue;
-        }
+      std::optional<unsigned> const size = parse_size(entry_dir.path());
+      if (!size) {
+        warn(fmt::format(
+            "Entry directory name is not a size: {} (current path: {}).",
+            entry_dir.path().string(), fs::current_path().string()));
+        continue;
       }
 
-      // Aggregating paths to repetition data files
-      for (fs::directory_entry const &repetition_directory_entry :
-           fs::recursive_directory_iterator(entry_dir)) {
-
-        // Basic property check
-        if (!std::filesystem::is_regular_file(repetition_directory_entry)) {
-          warn(fmt::format("Invalid repetition file (not a regular file): {} "
-                           "(current path: {}).",
-                           repetition_directory_entry.path().string(),
-                           fs::current_path().string()));
-          continue;
-        }
-
-        // Adding path
-        instance.repetitions.push_back(repetition_directory_entry);
-      }
-      bench.instances.push_back(instance);
+      instance_directories.push_back({.bench_id = bset.size(),
+                                      .instance_id = bench.instances.size(),
+                                      .path = entry_dir.path(),
+                                      .warnings = {}});
+      bench.instances.push_back(
+          {.size = *size, .repetitions = {}, .events = {}});
     }
 
+    bset.push_back(std::move(bench));
+  }
+
+  // Aggregating paths to repetition data files
+  parallel_for(instance_directories.size(), [&](std::size_t i) {
+    instance_directory_t &instance_directory = instance_directories[i];
+    scan_instance_directory(
+        instance_directory, bset[instance_directory.bench_id]
+                                .instances[instance_directory.instance_id]);
+  });
+
+  for (instance_directory_t const &instance_directory : instance_directories) {
+    for (std::string const &warning : instance_directory.warnings) {
+      warn(warning);
+    }
+  }
+
+  for (benchmark_case_t &bench : bset) {
     // Sorting by entry size
     std::sort(bench.instances.begin(), bench.instances.end(),
               [](benchmark_instance_t const &a, benchmark_instance_t const &b) {
                 return a.size < b.size;
               });
 
-    bset.push_back(std::move(bench));
+    // Event stores are attached once repetitions are known. Their files are
+    // parsed on first access only.
+    for (benchmark_instance_t &instance : bench.instances) {
+      instance.events = std::make_shared<event_store_t const>(
+          instance.repetitions, projection_ptr, use_trace_cache);
+    }
   }
+
   return bset;
 }
 
+grapher::benchmark_set_t
+build_category(llvm::cl::list<std::string> const &benchmark_path_list,
+               trace_projection_t projection, bool use_trace_cache) {
+  return build_category(std::vector<fs::path>(benchmark_path_list.begin(),
+                                              benchmark_path_list.end()),
+                        std::move(projection), use_trace_cache);
+}
+
 } // namespace grapher
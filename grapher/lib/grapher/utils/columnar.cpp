@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <grapher/utils/columnar.hpp>
+#include <grapher/utils/intern.hpp>
+#include <grapher/utils/mmap.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// Magic number at the beginning and at the end of columnar files
+constexpr std::array<char, 4> columnar_magic = {'C', 'T', 'C', 'L'};
+
+/// Columnar format version, to be bumped on every format change
+constexpr std::uint32_t columnar_version = 1;
+
+/// Columnar file header, followed by the column types.
+struct columnar_header_t {
+  std::array<char, 4> magic;
+  std::uint32_t version;
+  std::uint64_t column_count;
+};
+
+/// Columnar file footer, at the end of the file. Offsets are in bytes from
+/// the beginning of the file.
+struct columnar_footer_t {
+  std::uint64_t row_count;
+  std::uint64_t block_count;
+  std::uint64_t string_count;
+  std::uint64_t string_data_size;
+  std::uint64_t column_names_offset;
+  std::uint64_t string_offsets_offset;
+  std::uint64_t string_data_offset;
+  std::uint64_t block_offsets_offset;
+  std::array<char, 4> magic;
+  std::uint32_t version;
+};
+
+constexpr std::size_t align_section(std::size_t size) {
+  constexpr std::size_t section_alignment = 8;
+  return (size + section_alignment - 1) & ~(section_alignment - 1);
+}
+
+/// Returns the size of a column of a block.
+constexpr std::size_t get_column_size(std::uint32_t type,
+                                      std::size_t row_count) {
+  return align_section(row_count * (type == string_column_v
+                                        ? sizeof(std::uint32_t)
+                                        : sizeof(std::uint64_t)));
+}
+
+/// Appends a section to a columnar file, padding it to the section alignment.
+template <typename T>
+void write_section(std::ofstream &output, std::span<T const> section) {
+  std::size_t const byte_size = section.size_bytes();
+  output.write(reinterpret_cast<char const *>(section.data()),
+               static_cast<std::streamsize>(byte_size));
+
+  constexpr std::array<char, 8> padding{};
+  output.write(padding.data(), static_cast<std::streamsize>(
+                                   align_section(byte_size) - byte_size));
+}
+
+/// Returns a typed view on a section of a mapped columnar file.
+template <typename T>
+std::span<T const> get_section(std::string_view data, std::size_t offset,
+                               std::size_t count) {
+  return {reinterpret_cast<T const *>(data.data() + offset), count};
+}
+
+/// Returns true if count elements of type T starting at offset are within
+/// size bytes.
+template <typename T>
+bool is_in_bounds(std::uint64_t offset, std::uint64_t count,
+                  std::size_t size) {
+  return offset <= size && count <= (size - offset) / sizeof(T);
+}
+
+} // namespace
+
+// =============================================================================
+// Writer
+
+columnar_writer_t::columnar_writer_t(std::filesystem::path const &path,
+                                     std::vector<column_schema_t> schema,
+                                     std::size_t block_size)
+    : output_(path, std::ios::binary), schema_(std::move(schema)),
+      block_size_(std::max<std::size_t>(block_size, 1)),
+      columns_(schema_.size()) {
+  for (std::vector<std::uint64_t> &column : columns_) {
+    column.reserve(block_size_);
+  }
+
+  columnar_header_t const header{.magic = columnar_magic,
+                                 .version = columnar_version,
+                                 .column_count = schema_.size()};
+  std::vector<std::uint32_t> column_types;
+  std::ranges::transform(schema_, std::back_inserter(column_types),
+                         &column_schema_t::type);
+
+  write_section(output_, std::span<columnar_header_t const>(&header, 1));
+  write_section(output_, std::span<std::uint32_t const>(column_types));
+}
+
+columnar_writer_t::~columnar_writer_t() {
+  if (is_open()) {
+    close();
+  }
+}
+
+void columnar_writer_t::append_row(std::span<std::uint64_t const> values) {
+  for (std::size_t column_id = 0; column_id < columns_.size(); column_id++) {
+    std::uint64_t const value = values[column_id];
+    columns_[column_id].push_back(
+        schema_[column_id].type == string_column_v
+            ? get_string_id(static_cast<symbol_t>(value))
+            : value);
+  }
+
+  if (columns_.empty() || columns_.front().size() == block_size_) {
+    write_block();
+  }
+  row_count_++;
+}
+
+void columnar_writer_t::write_block() {
+  std::uint64_t const block_row_count =
+      columns_.empty() ? 0 : columns_.front().size();
+  if (block_row_count == 0) {
+    return;
+  }
+
+  block_offsets_.push_back(std::uint64_t(output_.tellp()));
+  write_section(output_, std::span<std::uint64_t const>(&block_row_count, 1));
+
+  std::vector<std::uint32_t> ids;
+  for (std::size_t column_id = 0; column_id < columns_.size(); column_id++) {
+    std::vector<std::uint64_t> &column = columns_[column_id];
+    if (schema_[column_id].type == string_column_v) {
+      ids.assign(column.begin(), column.end());
+      write_section(output_, std::span<std::uint32_t const>(ids));
+    } else {
+      write_section(output_, std::span<std::uint64_t const>(column));
+    }
+    column.clear();
+  }
+}
+
+std::uint32_t columnar_writer_t::get_string_id(symbol_t symbol) {
+  if (symbol == no_symbol_v) {
+    return no_string_id_v;
+  }
+
+  auto const [it, inserted] = string_ids_.try_emplace(
+      symbol, static_cast<std::uint32_t>(strings_.size()));
+  if (inserted) {
+    strings_.push_back(get_symbol_string(symbol));
+  }
+  return it->second;
+}
+
+bool columnar_writer_t::close() {
+  ZoneScoped;
+  write_block();
+
+  std::vector<std::uint32_t> column_names;
+  for (column_schema_t const &column : schema_) {
+    column_names.push_back(get_string_id(intern(column.name)));
+  }
+
+  std::vector<std::uint64_t> string_offsets{0};
+  std::string string_data;
+  for (std::string_view const str : strings_) {
+    string_data += str;
+    string_offsets.push_back(string_data.size());
+  }
+
+  columnar_footer_t footer{.row_count = row_count_,
+                           .block_count = block_offsets_.size(),
+                           .string_count = strings_.size(),
+                           .string_data_size = string_data.size(),
+                           .column_names_offset = 0,
+                           .string_offsets_offset = 0,
+                           .string_data_offset = 0,
+                           .block_offsets_offset = 0,
+                           .magic = columnar_magic,
+                           .version = columnar_version};
+
+  footer.column_names_offset = std::uint64_t(output_.tellp());
+  write_section(output_, std::span<std::uint32_t const>(column_names));
+  footer.string_offsets_offset = std::uint64_t(output_.tellp());
+  write_section(output_, std::span<std::uint64_t const>(string_offsets));
+  footer.string_data_offset = std::uint64_t(output_.tellp());
+  write_section(output_, std::span<char const>(string_data));
+  footer.block_offsets_offset = std::uint64_t(output_.tellp());
+  write_section(output_, std::span<std::uint64_t const>(block_offsets_));
+  write_section(output_, std::span<columnar_footer_t const>(&footer, 1));
+
+  bool const is_written = output_.good();
+  output_.close();
+  return is_written;
+}
+
+// =============================================================================
+// Reader
+
+columnar_reader_t::columnar_reader_t(std::filesystem::path const &path)
+    : file_(path) {
+  std::string_view const data = file_.data();
+  if (!file_.is_open() ||
+      data.size() < sizeof(columnar_header_t) + sizeof(columnar_footer_t)) {
+    return;
+  }
+
+  columnar_header_t header;
+  std::memcpy(&header, data.data(), sizeof(columnar_header_t));
+  columnar_footer_t footer;
+  std::memcpy(&footer, data.data() + data.size() - sizeof(columnar_footer_t),
+              sizeof(columnar_footer_t));
+
+  std::size_t const size = data.size() - sizeof(columnar_footer_t);
+  if (header.magic != columnar_magic || header.version != columnar_version ||
+      footer.magic != columnar_magic || footer.version != columnar_version ||
+      !is_in_bounds<std::uint32_t>(sizeof(columnar_header_t),
+                                   header.column_count, size) ||
+      !is_in_bounds<std::uint32_t>(footer.column_names_offset,
+                                   header.column_count, size) ||
+      !is_in_bounds<std::uint64_t>(footer.string_offsets_offset,
+                                   footer.string_count + 1, size) ||
+      !is_in_bounds<char>(footer.string_data_offset, footer.string_data_size,
+                          size) ||
+      !is_in_bounds<std::uint64_t>(footer.block_offsets_offset,
+                                   footer.block_count, size)) {
+    return;
+  }
+
+  column_types_ = get_section<std::uint32_t>(data, sizeof(columnar_header_t),
+                                             header.column_count);
+  column_names_ = get_section<std::uint32_t>(data, footer.column_names_offset,
+                                             header.column_count);
+  string_offsets_ = get_section<std::uint64_t>(
+      data, footer.string_offsets_offset, footer.string_count + 1);
+  string_data_ = data.substr(footer.string_data_offset,
+                             footer.string_data_size);
+  block_offsets_ = get_section<std::uint64_t>(
+      data, footer.block_offsets_offset, footer.block_count);
+
+  // Strings and blocks must lie within their sections
+  if (std::ranges::any_of(column_types_, [](std::uint32_t type) {
+        return type != string_column_v && type != unsigned_column_v;
+      }) ||
+      string_offsets_.empty() || !std::ranges::is_sorted(string_offsets_) ||
+      string_offsets_.back() > string_data_.size() ||
+      std::ranges::any_of(column_names_, [&](std::uint32_t id) {
+        return id >= footer.string_count;
+      })) {
+    return;
+  }
+
+  std::uint64_t row_count = 0;
+  for (std::size_t block_id = 0; block_id < block_offsets_.size();
+       block_id++) {
+    std::uint64_t const offset = block_offsets_[block_id];
+    if (!is_in_bounds<std::uint64_t>(offset, 1, footer.column_names_offset)) {
+      return;
+    }
+    std::uint64_t const block_row_count = get_block_row_count(block_id);
+    if (block_row_count > footer.column_names_offset) {
+      return;
+    }
+    std::uint64_t block_size = sizeof(std::uint64_t);
+    for (std::uint32_t const type : column_types_) {
+      block_size += get_column_size(type, block_row_count);
+    }
+    if (!is_in_bounds<char>(offset, block_size, footer.column_names_offset)) {
+      return;
+    }
+    row_count += block_row_count;
+  }
+
+  row_count_ = row_count;
+  is_valid_ = row_count == footer.row_count;
+}
+
+std::string_view
+columnar_reader_t::get_column_name(std::size_t column_id) const {
+  return get_string(column_names_[column_id]);
+}
+
+std::size_t columnar_reader_t::find_column(std::string_view name) const {
+  for (std::size_t column_id = 0; column_id < get_column_count();
+       column_id++) {
+    if (get_column_name(column_id) == name) {
+      return column_id;
+    }
+  }
+  return get_column_count();
+}
+
+std::size_t columnar_reader_t::get_block_row_count(std::size_t block_id) const {
+  std::uint64_t res;
+  std::memcpy(&res, file_.data().data() + block_offsets_[block_id],
+              sizeof(res));
+  return res;
+}
+
+std::size_t columnar_reader_t::get_column_offset(std::size_t block_id,
+                                                 std::size_t column_id) const {
+  std::size_t const row_count = get_block_row_count(block_id);
+  std::size_t res = block_offsets_[block_id] + sizeof(std::uint64_t);
+  for (std::size_t i = 0; i < column_id; i++) {
+    res += get_column_size(column_types_[i], row_count);
+  }
+  return res;
+}
+
+std::span<std::uint32_t const>
+columnar_reader_t::get_string_column(std::size_t block_id,
+                                     std::size_t column_id) const {
+  return get_section<std::uint32_t>(file_.data(),
+                                    get_column_offset(block_id, column_id),
+                                    get_block_row_count(block_id));
+}
+
+std::span<std::uint64_t const>
+columnar_reader_t::get_unsigned_column(std::size_t block_id,
+                                       std::size_t column_id) const {
+  return get_section<std::uint64_t>(file_.data(),
+                                    get_column_offset(block_id, column_id),
+                                    get_block_row_count(block_id));
+}
+
+std::string_view columnar_reader_t::get_string(std::uint32_t string_id) const {
+  if (string_id >= string_offsets_.size() - 1) {
+    return {};
+  }
+  std::size_t const begin = string_offsets_[string_id];
+  return string_data_.substr(begin, string_offsets_[string_id + 1] - begin);
+}
+
+} // namespace grapher
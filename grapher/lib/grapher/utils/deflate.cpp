@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <grapher/utils/deflate.hpp>
+
+namespace grapher {
+
+namespace {
+
+constexpr std::array<std::uint32_t, 256> make_crc_table() {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t n = 0; n < 256; n++) {
+    std::uint32_t c = n;
+    for (int k = 0; k < 8; k++) {
+      c = (c & 1) != 0 ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+    }
+    table[n] = c;
+  }
+  return table;
+}
+
+constexpr std::array<std::uint32_t, 256> crc_table = make_crc_table();
+
+/// Writes deflate bits, least significant bit first.
+class bit_writer_t {
+public:
+  void write(std::uint32_t bits, unsigned count) {
+    buffer_ |= std::uint64_t(bits) << buffer_size_;
+    buffer_size_ += count;
+    while (buffer_size_ >= 8) {
+      bytes_.push_back(std::uint8_t(buffer_));
+      buffer_ >>= 8;
+      buffer_size_ -= 8;
+    }
+  }
+
+  /// Writes a Huffman code, which is stored most significant bit first.
+  void write_code(std::uint32_t code, unsigned length) {
+    std::uint32_t reversed = 0;
+    for (unsigned i = 0; i < length; i++) {
+      reversed |= ((code >> i) & 1) << (length - 1 - i);
+    }
+    write(reversed, length);
+  }
+
+  std::vector<std::uint8_t> finish() {
+    if (buffer_size_ > 0) {
+      bytes_.push_back(std::uint8_t(buffer_));
+    }
+    buffer_ = 0;
+    buffer_size_ = 0;
+    return std::move(bytes_);
+  }
+
+private:
+  std::vector<std::uint8_t> bytes_;
+  std::uint64_t buffer_ = 0;
+  unsigned buffer_size_ = 0;
+};
+
+/// Writes a literal or length symbol with the fixed Huffman codes.
+void write_fixed_symbol(bit_writer_t &writer, unsigned symbol) {
+  if (symbol < 144) {
+    writer.write_code(0x30 + symbol, 8);
+  } else if (symbol < 256) {
+    writer.write_code(0x190 + symbol - 144, 9);
+  } else if (symbol < 280) {
+    writer.write_code(symbol - 256, 7);
+  } else {
+    writer.write_code(0xC0 + symbol - 280, 8);
+  }
+}
+
+constexpr std::array<unsigned, 29> length_bases = {
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<unsigned, 29> length_extra_bits = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+constexpr std::array<unsigned, 30> distance_bases = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577};
+constexpr std::array<unsigned, 30> distance_extra_bits = {
+    0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+constexpr std::size_t min_match_length = 3;
+constexpr std::size_t max_match_length = 258;
+constexpr std::size_t max_distance = 32768;
+
+/// Length of the longest matches whose positions are all inserted in the
+/// match finder.
+constexpr std::size_t max_insert_length = 32;
+
+void write_match(bit_writer_t &writer, std::size_t length,
+                 std::size_t distance) {
+  std::size_t code = length_bases.size() - 1;
+  while (length_bases[code] > length) {
+    code--;
+  }
+  write_fixed_symbol(writer, unsigned(257 + code));
+  writer.write(unsigned(length - length_bases[code]), length_extra_bits[code]);
+
+  code = distance_bases.size() - 1;
+  while (distance_bases[code] > distance) {
+    code--;
+  }
+  writer.write_code(unsigned(code), 5);
+  writer.write(unsigned(distance - distance_bases[code]),
+               distance_extra_bits[code]);
+}
+
+/// Match candidates: positions of the window indexed by the hash of their
+/// first min_match_length bytes, each position linking to the previous one
+/// with the same hash.
+class match_finder_t {
+public:
+  explicit match_finder_t(std::span<std::uint8_t const> data)
+      : data_(data), heads_(std::size_t{1} << hash_bits, no_position),
+        previous_(max_distance, no_position) {}
+
+  /// Makes a position available as a match candidate for later positions.
+  void insert(std::size_t position) {
+    if (position + min_match_length > data_.size()) {
+      return;
+    }
+    std::uint32_t &head = heads_[get_hash(position)];
+    previous_[position % max_distance] = head;
+    head = std::uint32_t(position);
+  }
+
+  /// Returns the length and distance of the longest match found for a
+  /// position, with a length of 0 if there is none.
+  std::pair<std::size_t, std::size_t> find(std::size_t position) const {
+    if (position + min_match_length > data_.size()) {
+      return {0, 0};
+    }
+
+    std::size_t const max_length =
+        std::min(max_match_length, data_.size() - position);
+    std::size_t best_length = 0;
+    std::size_t best_distance = 0;
+
+    std::uint32_t candidate = heads_[get_hash(position)];
+    for (std::size_t i = 0; i < max_chain_length && candidate != no_position;
+         i++) {
+      std::size_t const distance = position - candidate;
+      if (distance > max_distance) {
+        break;
+      }
+
+      // A candidate can only be longer than the best match if it matches at
+      // the best match's end, which rejects most of them in one comparison
+      if (data_[candidate + best_length] == data_[position + best_length]) {
+        std::size_t const length =
+            get_match_length(candidate, position, max_length);
+        if (length > best_length) {
+          best_length = length;
+          best_distance = distance;
+          if (length >= std::min(nice_match_length, max_length)) {
+            break;
+          }
+        }
+      }
+      candidate = previous_[candidate % max_distance];
+    }
+    return {best_length, best_distance};
+  }
+
+private:
+  static constexpr unsigned hash_bits = 15;
+
+  /// Number of candidates compared per position, bounding the time spent on
+  /// repetitive data
+  static constexpr std::size_t max_chain_length = 64;
+
+  /// Match length after which candidates aren't searched for a longer one
+  static constexpr std::size_t nice_match_length = 128;
+
+  static constexpr std::uint32_t no_position = ~std::uint32_t{0};
+
+  /// Returns the number of equal bytes at candidate and position, up to
+  /// max_length. Bytes are compared 8 at a time.
+  std::size_t get_match_length(std::size_t candidate, std::size_t position,
+                               std::size_t max_length) const {
+    std::size_t length = 0;
+    while (length + sizeof(std::uint64_t) <= max_length) {
+      std::uint64_t candidate_bytes;
+      std::uint64_t position_bytes;
+      std::memcpy(&candidate_bytes, &data_[candidate + length],
+                  sizeof(std::uint64_t));
+      std::memcpy(&position_bytes, &data_[position + length],
+                  sizeof(std::uint64_t));
+      if (candidate_bytes != position_bytes) {
+        break;
+      }
+      length += sizeof(std::uint64_t);
+    }
+    while (length < max_length &&
+           data_[candidate + length] == data_[position + length]) {
+      length++;
+    }
+    return length;
+  }
+
+  std::uint32_t get_hash(std::size_t position) const {
+    std::uint32_t const bytes = std::uint32_t(data_[position]) << 16 |
+                                std::uint32_t(data_[position + 1]) << 8 |
+                                std::uint32_t(data_[position + 2]);
+    return (bytes * 2654435761U) >> (32 - hash_bits);
+  }
+
+  std::span<std::uint8_t const> data_;
+  std::vector<std::uint32_t> heads_;
+  std::vector<std::uint32_t> previous_;
+};
+
+void append_u32_le(std::string &out, std::uint32_t value) {
+  out += char(value);
+  out += char(value >> 8);
+  out += char(value >> 16);
+  out += char(value >> 24);
+}
+
+} // namespace
+
+std::vector<std::uint8_t> deflate(std::span<std::uint8_t const> data) {
+  bit_writer_t writer;
+  writer.write(1, 1); // Final block
+  writer.write(1, 2); // Fixed Huffman codes
+
+  match_finder_t finder(data);
+  std::size_t position = 0;
+  while (position < data.size()) {
+    auto const [length, distance] = finder.find(position);
+
+    if (length >= min_match_length) {
+      write_match(writer, length, distance);
+      // Like zlib's fast levels, only the start of long matches is inserted:
+      // they mostly cover background pixels, which are found from the
+      // positions already inserted
+      std::size_t const end = position + length;
+      std::size_t const insert_end =
+          length > max_insert_length ? position + 1 : end;
+      for (; position < insert_end; position++) {
+        finder.insert(position);
+      }
+      position = end;
+    } else {
+      write_fixed_symbol(writer, data[position]);
+      finder.insert(position);
+      position++;
+    }
+  }
+
+  write_fixed_symbol(writer, 256); // End of block
+  return writer.finish();
+}
+
+std::uint32_t get_crc32(std::string_view data) {
+  std::uint32_t c = 0xFFFFFFFFU;
+  for (char byte : data) {
+    c = crc_table[(c ^ std::uint8_t(byte)) & 0xFF] ^ (c >> 8);
+  }
+  return c ^ 0xFFFFFFFFU;
+}
+
+std::uint32_t get_adler32(std::span<std::uint8_t const> data) {
+  constexpr std::uint32_t modulo = 65521;
+  // Largest number of bytes summed before b may overflow
+  constexpr std::size_t max_run = 5552;
+
+  std::uint32_t a = 1;
+  std::uint32_t b = 0;
+  while (!data.empty()) {
+    std::size_t const run = std::min(data.size(), max_run);
+    for (std::uint8_t byte : data.first(run)) {
+      a += byte;
+      b += a;
+    }
+    a %= modulo;
+    b %= modulo;
+    data = data.subspan(run);
+  }
+  return (b << 16) | a;
+}
+
+std::string gzip(std::string_view data) {
+  // Header: magic, deflate method, no flags, no time, unknown OS
+  std::string res("\x1F\x8B\x08\0\0\0\0\0\0\xFF", 10);
+
+  std::vector<std::uint8_t> const compressed =
+      deflate({reinterpret_cast<std::uint8_t const *>(data.data()),
+               data.size()});
+  res.append(compressed.begin(), compressed.end());
+
+  append_u32_le(res, get_crc32(data));
+  append_u32_le(res, std::uint32_t(data.size()));
+  return res;
+}
+
+} // namespace grapher
@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <vector>
+
+#include <boost/core/demangle.hpp>
+
+#include <fmt/core.h>
+
+#include <grapher/utils/demangle.hpp>
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/intern.hpp>
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher {
+
+std::string demangle(std::string const &name) {
+  boost::core::scoped_demangled_name const demangled_name(name.c_str());
+
+  // Demangling fails for strings that aren't mangled names
+  if (demangled_name.get() == nullptr) {
+    return name;
+  }
+  return demangled_name.get();
+}
+
+void demangle_cache_t::insert(std::span<symbol_t const> symbols) {
+  ZoneScoped;
+
+  // Unique symbols that weren't demangled yet
+  std::vector<symbol_t> new_symbols;
+  std::ranges::copy_if(symbols, std::back_inserter(new_symbols),
+                       [&](symbol_t symbol) {
+                         return !demangled_names_.contains(symbol);
+                       });
+  std::ranges::sort(new_symbols);
+  new_symbols.erase(std::ranges::unique(new_symbols).begin(),
+                    new_symbols.end());
+
+  std::vector<std::string> new_demangled_names(new_symbols.size());
+  parallel_for(new_symbols.size(), [&](std::size_t i) {
+    new_demangled_names[i] = demangle(get_symbol_string(new_symbols[i]));
+  });
+
+  demangled_names_.reserve(demangled_names_.size() + new_symbols.size());
+  for (std::size_t i = 0; i < new_symbols.size(); i++) {
+    demangled_names_.emplace(new_symbols[i], std::move(new_demangled_names[i]));
+  }
+}
+
+std::string const &demangle_cache_t::get(symbol_t symbol) const {
+  auto const it = demangled_names_.find(symbol);
+  check(it != demangled_names_.end(),
+        fmt::format("Symbol not in demangle cache: {}.",
+                    get_symbol_string(symbol)));
+  return it->second;
+}
+
+} // namespace grapher
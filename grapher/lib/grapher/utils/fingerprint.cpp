@@ -0,0 +1,38 @@
+#include <grapher/utils/fingerprint.hpp>
+#include <grapher/utils/mmap.hpp>
+
+namespace grapher {
+
+std::optional<file_stamp_t> get_file_stamp(std::filesystem::path const &path) {
+  std::error_code error;
+  std::uintmax_t const size = std::filesystem::file_size(path, error);
+  if (error) {
+    return std::nullopt;
+  }
+  auto const mtime = std::filesystem::last_write_time(path, error);
+  if (error) {
+    return std::nullopt;
+  }
+  return file_stamp_t{.size = size,
+                      .mtime = mtime.time_since_epoch().count()};
+}
+
+std::uint64_t hash_bytes(std::string_view data) {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (char const byte : data) {
+    hash ^= static_cast<unsigned char>(byte);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+std::optional<std::uint64_t> hash_file(std::filesystem::path const &path) {
+  mapped_file_t const file(path);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  file.advise_sequential();
+  return hash_bytes(file.data());
+}
+
+} // namespace grapher
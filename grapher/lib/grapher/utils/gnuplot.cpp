@@ -0,0 +1,133 @@
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+#include <pthread.h>
+#include <sys/wait.h>
+
+#include <fmt/core.h>
+
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/gnuplot.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// Calls write with SIGPIPE blocked on the calling thread, so writing to a
+/// pipe whose reader exited fails with EPIPE instead of killing the process.
+/// SIGPIPE raised by write is discarded before restoring the signal mask,
+/// and the signal disposition of the process is left untouched.
+template <typename WriteFunction>
+auto write_without_sigpipe(WriteFunction write) {
+  sigset_t sigpipe_set;
+  sigemptyset(&sigpipe_set);
+  sigaddset(&sigpipe_set, SIGPIPE);
+
+  sigset_t previous_set;
+  pthread_sigmask(SIG_BLOCK, &sigpipe_set, &previous_set);
+  sigset_t pending_set;
+  sigpending(&pending_set);
+  bool const was_pending = sigismember(&pending_set, SIGPIPE) == 1;
+
+  auto const res = write();
+
+  // SIGPIPE raised by write is directed at this thread
+  sigpending(&pending_set);
+  if (!was_pending && sigismember(&pending_set, SIGPIPE) == 1) {
+    timespec const no_wait{};
+    sigtimedwait(&sigpipe_set, nullptr, &no_wait);
+  }
+  pthread_sigmask(SIG_SETMASK, &previous_set, nullptr);
+
+  return res;
+}
+
+} // namespace
+
+gnuplot_session_t::gnuplot_session_t(std::string command)
+    : command_(std::move(command)) {
+  pipe_ = popen(command_.c_str(), "w");
+  if (pipe_ == nullptr) {
+    failed_ = true;
+    warn(fmt::format("Could not start gnuplot session: {}", command_));
+  }
+}
+
+gnuplot_session_t::~gnuplot_session_t() { close(); }
+
+bool gnuplot_session_t::send(std::string_view commands,
+                             std::string_view destination) {
+  if (pipe_ == nullptr) {
+    return false;
+  }
+  last_destination_ = destination;
+  if (!write_without_sigpipe([&]() {
+        return std::fwrite(commands.data(), 1, commands.size(), pipe_) ==
+                   commands.size() &&
+               std::fflush(pipe_) == 0;
+      })) {
+    failed_ = true;
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool gnuplot_session_t::close() {
+  if (pipe_ != nullptr) {
+    // Closing the pipe flushes it
+    int const status = write_without_sigpipe([&]() { return pclose(pipe_); });
+    pipe_ = nullptr;
+    if (status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      failed_ = true;
+    }
+  }
+  return !failed_;
+}
+
+std::string get_gnuplot_terminal(std::string_view extension, std::size_t width,
+                                 std::size_t height) {
+  // Vector formats measured in inches
+  constexpr double points_per_inch = 72.;
+  if (extension == ".pdf" || extension == ".eps") {
+    return fmt::format("{}cairo enhanced size {}in,{}in",
+                       extension.substr(1), double(width) / points_per_inch,
+                       double(height) / points_per_inch);
+  }
+
+  if (extension == ".png") {
+    return fmt::format("pngcairo enhanced size {},{}", width, height);
+  }
+  if (extension == ".jpg" || extension == ".jpeg") {
+    return fmt::format("jpeg enhanced size {},{}", width, height);
+  }
+  if (extension == ".gif") {
+    return fmt::format("gif enhanced size {},{}", width, height);
+  }
+  if (extension == ".tex") {
+    return fmt::format("cairolatex size {}in,{}in",
+                       double(width) / points_per_inch,
+                       double(height) / points_per_inch);
+  }
+
+  // SVG is also the fallback for unknown extensions
+  return fmt::format("svg enhanced size {},{}", width, height);
+}
+
+std::string quote_gnuplot_string(std::string_view str) {
+  // Single quotes are doubled in single-quoted gnuplot strings
+  std::string res = "'";
+  for (char const c : str) {
+    res += c;
+    if (c == '\'') {
+      res += '\'';
+    }
+  }
+  res += '\'';
+  return res;
+}
+
+} // namespace grapher
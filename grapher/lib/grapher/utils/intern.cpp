@@ -0,0 +1,113 @@
+#include <array>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <fmt/core.h>
+
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/intern.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// The interning table is split into independently locked shards to limit
+/// contention between ingestion threads.
+constexpr std::size_t shard_count = 16;
+
+struct shard_t {
+  std::shared_mutex mutex;
+
+  /// String storage. Deque elements are never moved, so the string views
+  /// used as symbol map keys remain valid.
+  std::deque<std::string> strings;
+
+  std::unordered_map<std::string_view, symbol_t> symbols;
+};
+
+/// Interning table. Symbols encode their shard and their index in the shard,
+/// offset by one so no_symbol_v is never used.
+class interning_table_t {
+public:
+  symbol_t intern(std::string_view str) {
+    std::size_t const shard_id = get_shard_id(str);
+    shard_t &shard = shards_[shard_id];
+
+    {
+      std::shared_lock const lock(shard.mutex);
+      if (auto const it = shard.symbols.find(str); it != shard.symbols.end()) {
+        return it->second;
+      }
+    }
+
+    std::unique_lock const lock(shard.mutex);
+
+    // Another thread may have interned the string in the meantime
+    if (auto const it = shard.symbols.find(str); it != shard.symbols.end()) {
+      return it->second;
+    }
+
+    std::size_t const index = shard.strings.size();
+    check(index <= (std::numeric_limits<symbol_t>::max() - 1 - shard_id) /
+                       shard_count,
+          "Interning table is full.");
+
+    symbol_t const symbol =
+        static_cast<symbol_t>(index * shard_count + shard_id + 1);
+    shard.symbols.emplace(shard.strings.emplace_back(str), symbol);
+    return symbol;
+  }
+
+  symbol_t find(std::string_view str) {
+    shard_t &shard = shards_[get_shard_id(str)];
+
+    std::shared_lock const lock(shard.mutex);
+    auto const it = shard.symbols.find(str);
+    return it == shard.symbols.end() ? no_symbol_v : it->second;
+  }
+
+  std::string const &get_string(symbol_t symbol) {
+    check(symbol != no_symbol_v, "Absent symbol has no string.");
+
+    std::size_t const shard_id = (symbol - 1) % shard_count;
+    std::size_t const index = (symbol - 1) / shard_count;
+    shard_t &shard = shards_[shard_id];
+
+    std::shared_lock const lock(shard.mutex);
+    check(index < shard.strings.size(),
+          fmt::format("Invalid symbol: {}.", symbol));
+    return shard.strings[index];
+  }
+
+private:
+  static std::size_t get_shard_id(std::string_view str) {
+    return std::hash<std::string_view>{}(str) % shard_count;
+  }
+
+  std::array<shard_t, shard_count> shards_;
+};
+
+interning_table_t &get_interning_table() {
+  static interning_table_t table;
+  return table;
+}
+
+} // namespace
+
+symbol_t intern(std::string_view str) {
+  return get_interning_table().intern(str);
+}
+
+symbol_t find_symbol(std::string_view str) {
+  return get_interning_table().find(str);
+}
+
+std::string const &get_symbol_string(symbol_t symbol) {
+  return get_interning_table().get_string(symbol);
+}
+
+} // namespace grapher
@@ -1,17 +1,103 @@
 #include <algorithm>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <span>
 
 #include <nlohmann/json.hpp>
 #include <sciplot/Canvas.hpp>
 #include <sciplot/Figure.hpp>
 
 #include <grapher/core.hpp>
+#include <grapher/event_store.hpp>
 #include <grapher/predicates.hpp>
+#include <grapher/utils/gnuplot.hpp>
 #include <grapher/utils/json.hpp>
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/plot.hpp>
+#include <grapher/utils/render.hpp>
 #include <grapher/utils/tracy.hpp>
 
 namespace grapher {
 
+namespace {
+
+/// Field of an event and strings it must hold to satisfy a predicate.
+struct required_strings_t {
+  event_field_t field;
+  std::vector<symbol_t> symbols;
+};
+
+/// Returns the strings required by the predicate expression starting at a
+/// given instruction, if it requires any.
+std::optional<required_strings_t>
+get_required_strings(predicate_t const &predicate, std::size_t instruction_id) {
+  std::span<predicate_instruction_t const> const instructions =
+      predicate.get_instructions();
+  predicate_instruction_t const &instruction = instructions[instruction_id];
+  std::size_t const end = instruction_id + instruction.size;
+
+  switch (instruction.opcode) {
+  case streq_op_v:
+    return required_strings_t{.field = instruction.field,
+                              .symbols = {instruction.symbol}};
+
+  // Sets holding ids also match numbers
+  case in_set_op_v: {
+    predicate_set_t const &set = predicate.get_sets()[instruction.operand];
+    if (!set.ids.empty()) {
+      return std::nullopt;
+    }
+    return required_strings_t{
+        .field = instruction.field,
+        .symbols = {set.symbols.begin(), set.symbols.end()}};
+  }
+
+  // Any operand of a conjunction is required
+  case all_op_v:
+    for (std::size_t operand_id = instruction_id + 1; operand_id < end;
+         operand_id += instructions[operand_id].size) {
+      if (std::optional<required_strings_t> required_strings =
+              get_required_strings(predicate, operand_id)) {
+        return required_strings;
+      }
+    }
+    return std::nullopt;
+
+  // All the operands of a disjunction must require strings of the same field
+  case any_op_v: {
+    std::optional<required_strings_t> res;
+    for (std::size_t operand_id = instruction_id + 1; operand_id < end;
+         operand_id += instructions[operand_id].size) {
+      std::optional<required_strings_t> required_strings =
+          get_required_strings(predicate, operand_id);
+      if (!required_strings ||
+          (res && required_strings->field != res->field)) {
+        return std::nullopt;
+      }
+      if (!res) {
+        res = std::move(required_strings);
+      } else {
+        std::ranges::copy(required_strings->symbols,
+                          std::back_inserter(res->symbols));
+      }
+    }
+    return res;
+  }
+
+  case constant_op_v:
+  case regex_op_v:
+  case equals_op_v:
+  case range_op_v:
+    break;
+  }
+
+  return std::nullopt;
+}
+
+} // namespace
+
 /// Default group descriptor values:
 ///
 /// \code{.js}
@@ -99,44 +185,194 @@ read_descriptors(grapher::json_t::array_t const &list) {
   return res;
 }
 
+trace_projection_t
+get_descriptors_projection(std::vector<group_descriptor_t> const &descriptors,
+                           grapher::json_t::json_pointer value_json_pointer) {
+  trace_projection_t res{.keep_all_fields = false,
+                         .pointers = {std::move(value_json_pointer)}};
+
+  for (group_descriptor_t const &descriptor : descriptors) {
+    for (grapher::json_t const &constraint : descriptor.predicates) {
+      std::ranges::move(get_predicate_pointers(constraint),
+                        std::back_inserter(res.pointers));
+    }
+    res.filters.push_back(get_predicates(descriptor));
+  }
+
+  return res;
+}
+
 std::vector<grapher::value_t>
 filtered_values_sums(benchmark_instance_t const &instance,
                      std::vector<predicate_t> const &predicates,
                      grapher::json_t::json_pointer value_json_pointer) {
-  std::vector<grapher::value_t> res(instance.repetitions.size());
+  check(instance.events != nullptr,
+        fmt::format("No event store for instance of size {}.", instance.size));
 
-  auto get_val =
-      [&](std::filesystem::path const &repetition_path) -> grapher::value_t {
-    // Extract events
-    grapher::json_t repetition_data;
-    {
-      std::ifstream repetition_ifstream(repetition_path);
-      repetition_ifstream >> repetition_data;
-    }
-    grapher::json_t::array_t const &events =
-        get_as_ref<grapher::json_t::array_t const &>(repetition_data,
-                                                     "traceEvents");
+  event_store_t const &store = *instance.events;
+  std::vector<grapher::value_t> res(store.size());
+
+  event_field_t const value_field = event_field_t::resolve(value_json_pointer);
+
+  // Repetitions are parsed and filtered concurrently
+  parallel_for(store.size(), [&](std::size_t repetition_id) {
+    event_table_t const &events = store.get(repetition_id);
 
     // Accumulate the sum of values matched by all the predicates
     grapher::value_t val = 0;
-    for (grapher::json_t const &event : events) {
+    for (std::size_t row = 0; row < events.size(); row++) {
       if (std::all_of(predicates.begin(), predicates.end(),
                       [&](predicate_t const &predicate) -> bool {
-                        return predicate(event);
+                        return predicate(events, row);
                       })) {
-        val += get_as_ref<json_t::number_unsigned_t const &>(
-            event, value_json_pointer);
+        event_value_t const value = events.get(row, value_field);
+        if (value.kind != unsigned_kind_v) {
+          check(false,
+                fmt::format("Invalid field {}, expected unsigned number:\n{}",
+                            value_json_pointer.to_string(),
+                            events.get_event(row).dump(2)));
+        }
+        val += value.get_value();
       }
     }
-    return val;
-  };
+    res[repetition_id] = val;
+  });
 
-  std::transform(instance.repetitions.begin(), instance.repetitions.end(),
-                 res.begin(), get_val);
+  return res;
+}
+
+descriptor_dispatcher_t::descriptor_dispatcher_t(
+    std::vector<group_descriptor_t> const &descriptors) {
+  for (group_descriptor_t const &descriptor : descriptors) {
+    std::size_t const descriptor_id = predicates_.size();
+    predicates_.push_back(get_predicates(descriptor));
+
+    // Looking for a predicate that requires strings
+    std::optional<required_strings_t> required_strings;
+    for (predicate_t const &predicate : predicates_.back()) {
+      if (!predicate.get_instructions().empty()) {
+        required_strings = get_required_strings(predicate, 0);
+      }
+      if (required_strings) {
+        break;
+      }
+    }
+
+    if (!required_strings) {
+      unindexed_descriptor_ids_.push_back(descriptor_id);
+      continue;
+    }
+
+    // Each descriptor must be found at most once per event
+    std::vector<symbol_t> &symbols = required_strings->symbols;
+    std::ranges::sort(symbols);
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+    auto index_it =
+        std::ranges::find(indexes_, required_strings->field, &index_t::field);
+    if (index_it == indexes_.end()) {
+      index_it = indexes_.insert(
+          indexes_.end(),
+          index_t{.field = required_strings->field, .descriptor_ids = {}});
+    }
+
+    for (symbol_t const symbol : symbols) {
+      index_it->descriptor_ids[symbol].push_back(descriptor_id);
+    }
+  }
+}
+
+std::vector<std::vector<grapher::value_t>>
+filtered_values_sums(benchmark_instance_t const &instance,
+                     descriptor_dispatcher_t const &dispatcher,
+                     grapher::json_t::json_pointer value_json_pointer) {
+  check(instance.events != nullptr,
+        fmt::format("No event store for instance of size {}.", instance.size));
+
+  event_store_t const &store = *instance.events;
+  std::vector<std::vector<grapher::value_t>> res(
+      dispatcher.size(), std::vector<grapher::value_t>(store.size(), 0));
+
+  event_field_t const value_field = event_field_t::resolve(value_json_pointer);
+
+  // Repetitions are parsed and filtered concurrently
+  parallel_for(store.size(), [&](std::size_t repetition_id) {
+    event_table_t const &events = store.get(repetition_id);
+
+    // Accumulate the sums of values matched by each descriptor
+    for (std::size_t row = 0; row < events.size(); row++) {
+      dispatcher.for_each_match(events, row, [&](std::size_t descriptor_id) {
+        event_value_t const value = events.get(row, value_field);
+        if (value.kind != unsigned_kind_v) {
+          check(false,
+                fmt::format("Invalid field {}, expected unsigned number:\n{}",
+                            value_json_pointer.to_string(),
+                            events.get_event(row).dump(2)));
+        }
+        res[descriptor_id][repetition_id] += value.get_value();
+      });
+    }
+  });
 
   return res;
 }
 
+namespace {
+
+constexpr std::size_t default_width = 640;
+constexpr std::size_t default_height = 480;
+
+/// Saves a plot in all the formats with a gnuplot session. The plot and its
+/// data are sent once, other formats are rendered by switching the terminal
+/// and replotting.
+void save_plot_with_session(sciplot::Plot2D const &plot,
+                            std::string const &dest,
+                            std::vector<std::string> const &extensions,
+                            grapher::json_t const &config) {
+  ZoneScoped;
+  namespace fs = std::filesystem;
+
+  std::size_t const width = config.value("width", default_width);
+  std::size_t const height = config.value("height", default_height);
+
+  std::string commands;
+  for (std::size_t i = 0; i < extensions.size(); i++) {
+    std::string const file_dest = dest + extensions[i];
+    fs::create_directories(fs::path(file_dest).parent_path());
+
+    commands += fmt::format(
+        "set terminal {}\nset output {}\n",
+        get_gnuplot_terminal(extensions[i], width, height),
+        quote_gnuplot_string(file_dest));
+    commands += i == 0 ? plot.repr() : "replot\n";
+    commands += "unset output\n";
+  }
+
+  // Sessions outside of render_parallel only live for this plot
+  std::optional<gnuplot_session_t> local_session;
+  auto get_session = [&]() -> gnuplot_session_t & {
+    if (gnuplot_session_t *session = get_render_session()) {
+      return *session;
+    }
+    if (!local_session || !local_session->is_open()) {
+      local_session.emplace();
+    }
+    return *local_session;
+  };
+
+  // A session may have exited after an error in a previous plot, so sending
+  // is retried once with a new session
+  bool const is_sent =
+      get_session().send(commands, dest) || get_session().send(commands, dest);
+  bool const is_closed = !local_session || local_session->close();
+
+  check(is_sent && is_closed,
+        fmt::format("Could not render plot {} with gnuplot.", dest),
+        warning_v);
+}
+
+} // namespace
+
 void save_plot(sciplot::Plot2D plot, std::string const &dest,
                grapher::json_t const &config) {
   ZoneScoped;
@@ -148,8 +384,24 @@ void save_plot(sciplot::Plot2D plot, std::string const &dest,
   std::vector<std::string> plot_file_extensions = config.value(
       "plot_file_extensions", grapher::json_t::array({".svg", ".png"}));
 
-  sciplot::Figure figure{{plot}};
-  sciplot::Canvas canvas{{figure}};
+  std::string const backend = config.value("plot_backend", "sciplot");
+  if (backend == "gnuplot_session") {
+    save_plot_with_session(plot, dest, plot_file_extensions, config);
+    return;
+  }
+  if (backend == "native") {
+    static std::once_flag warning_flag;
+    std::call_once(warning_flag, []() {
+      warn("The native plot backend does not support this plotter, falling "
+           "back to gnuplot.");
+    });
+  }
+
+  sciplot::Canvas canvas = [&]() {
+    std::scoped_lock const lock(get_sciplot_mutex());
+    sciplot::Figure figure{{plot}};
+    return sciplot::Canvas{{figure}};
+  }();
 
   // Saving file for all extensions
   for (std::string const &extension : plot_file_extensions) {
@@ -175,6 +427,125 @@ void save_plot(sciplot::Plot2D plot, std::string const &dest,
   }
 }
 
+void save_plot(plot_t plot, std::string const &dest,
+               grapher::json_t const &config) {
+  ZoneScoped;
+  namespace fs = std::filesystem;
+
+  if (config.value("plot_backend", "sciplot") != "native") {
+    save_plot(to_sciplot(plot), dest, config);
+    return;
+  }
+
+  apply_config(plot, config);
+
+  std::vector<std::string> const plot_file_extensions = config.value(
+      "plot_file_extensions", grapher::json_t::array({".svg", ".png"}));
+  std::size_t const width = config.value("width", default_width);
+  std::size_t const height = config.value("height", default_height);
+
+  // The plot is laid out once, then converted to each format. Formats other
+  // than SVG and PNG are left to gnuplot.
+  plot_scene_t const scene = layout_plot(plot, width, height);
+  grapher::json_t::array_t other_extensions;
+
+  for (std::string const &extension : plot_file_extensions) {
+    std::string data;
+    if (extension == ".svg") {
+      data = to_svg(scene);
+    } else if (extension == ".png") {
+      data = to_png(scene);
+    } else {
+      other_extensions.push_back(extension);
+      continue;
+    }
+
+    fs::path const file_dest = dest + extension;
+    fs::create_directories(file_dest.parent_path());
+    std::ofstream file(file_dest, std::ios::binary);
+    file.write(data.data(), std::streamsize(data.size()));
+    check(file.good(), fmt::format("Could not write {}.", file_dest.string()),
+          warning_v);
+  }
+
+  if (!other_extensions.empty()) {
+    static std::once_flag warning_flag;
+    std::call_once(warning_flag, [&]() {
+      warn(fmt::format("The native plot backend only renders .svg and .png "
+                       "files, falling back to gnuplot for {}.",
+                       grapher::json_t(other_extensions).dump()));
+    });
+    grapher::json_t fallback_config = config;
+    fallback_config["plot_file_extensions"] = std::move(other_extensions);
+    fallback_config["plot_backend"] = "sciplot";
+    save_plot(to_sciplot(plot), dest, fallback_config);
+  }
+}
+
+sciplot::Plot2D to_sciplot(plot_t const &plot) {
+  sciplot::Plot2D res = []() {
+    std::scoped_lock const lock(get_sciplot_mutex());
+    return sciplot::Plot2D{};
+  }();
+
+  for (plot_series_t const &series : plot.series) {
+    switch (series.kind) {
+    case curve_series_v:
+      res.drawCurve(series.x, series.y).label(series.label);
+      break;
+    case points_series_v:
+      res.drawPoints(series.x, series.y).label(series.label);
+      break;
+    case error_bars_series_v:
+      res.drawCurveWithErrorBarsY(series.x, series.y, series.y_delta)
+          .label(series.label);
+      break;
+    case filled_series_v:
+      res.drawCurvesFilled(series.x, series.y_low, series.y)
+          .label(series.label);
+      break;
+    }
+  }
+
+  if (!plot.x_label.empty()) {
+    res.xlabel(plot.x_label);
+  }
+  if (!plot.y_label.empty()) {
+    res.ylabel(plot.y_label);
+  }
+  if (plot.legend_position == legend_bottom_v) {
+    res.legend().atBottom();
+  }
+  if (!plot.legend_title.empty()) {
+    res.legend().title(plot.legend_title);
+  }
+  if (plot.legend_from_last) {
+    res.legend().displayStartFromLast();
+  }
+  if (plot.y_range) {
+    res.yrange(plot.y_range->first, plot.y_range->second);
+  }
+
+  return res;
+}
+
+plot_t &apply_config(plot_t &plot, grapher::json_t const &config) {
+  if (config.contains("legend_title")) {
+    plot.legend_position = legend_right_v;
+    plot.legend_title = config["legend_title"];
+  }
+
+  if (config.contains("x_label")) {
+    plot.x_label = config["x_label"];
+  }
+
+  if (config.contains("y_label")) {
+    plot.y_label = config["y_label"];
+  }
+
+  return plot;
+}
+
 sciplot::Plot &apply_config(sciplot::Plot &plot,
                             grapher::json_t const &config) {
   // Dimensions
@@ -205,6 +576,7 @@ grapher::json_t const default_config = {
     {"x_label", "Benchmark size factor"},
     {"y_label", "Time (µs)"},
     {"plot_file_extensions", grapher::json_t::array({".svg", ".png"})},
+    {"plot_backend", "sciplot"},
 };
 
 /// Common plot JSON parameters:
@@ -214,6 +586,11 @@ grapher::json_t const default_config = {
 /// - `x_label` (`string`): X axis label
 /// - `y_label` (`string`): Y axis label
 /// - `plot_file_extensions` (string array): List of extensions for the export
+/// - `plot_backend` (`string`): `sciplot` (default) runs gnuplot once per
+///   file, `gnuplot_session` renders all the files with long-lived gnuplot
+///   processes fed over a pipe, and `native` renders SVG and PNG files
+///   directly, falling back to gnuplot for other formats and plots that do
+///   not support it
 grapher::json_t base_default_config() { return default_config; }
 
 } // namespace grapher
@@ -0,0 +1,72 @@
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <grapher/utils/mmap.hpp>
+
+namespace grapher {
+
+mapped_file_t::mapped_file_t(std::filesystem::path const &path) {
+  int const file_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file_descriptor < 0) {
+    return;
+  }
+
+  struct stat file_stat {};
+  if (::fstat(file_descriptor, &file_stat) != 0) {
+    ::close(file_descriptor);
+    return;
+  }
+
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+
+  // Empty files can't be mapped, they're represented by an empty view
+  if (size_ == 0) {
+    ::close(file_descriptor);
+    is_open_ = true;
+    return;
+  }
+
+  void *const mapping =
+      ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+
+  // The mapping remains valid after the file descriptor is closed
+  ::close(file_descriptor);
+
+  if (mapping == MAP_FAILED) {
+    size_ = 0;
+    return;
+  }
+
+  data_ = static_cast<char const *>(mapping);
+  is_open_ = true;
+}
+
+mapped_file_t::mapped_file_t(mapped_file_t &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      is_open_(std::exchange(other.is_open_, false)) {}
+
+mapped_file_t &mapped_file_t::operator=(mapped_file_t &&other) noexcept {
+  std::swap(data_, other.data_);
+  std::swap(size_, other.size_);
+  std::swap(is_open_, other.is_open_);
+  return *this;
+}
+
+void mapped_file_t::advise_sequential() const {
+  if (data_ != nullptr) {
+    ::madvise(const_cast<char *>(data_), size_, MADV_SEQUENTIAL);
+  }
+}
+
+mapped_file_t::~mapped_file_t() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char *>(data_), size_);
+  }
+}
+
+} // namespace grapher
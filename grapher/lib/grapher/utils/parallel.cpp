@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// Job count set from the command line, 0 meaning hardware concurrency
+std::atomic<unsigned> job_count_setting = 0;
+
+/// Set for threads running a parallel_for loop to avoid nested spawning
+thread_local bool in_parallel_region = false;
+
+} // namespace
+
+void set_job_count(unsigned job_count) { job_count_setting = job_count; }
+
+unsigned get_job_count() {
+  if (unsigned const job_count = job_count_setting; job_count != 0) {
+    return job_count;
+  }
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void parallel_for(std::size_t count,
+                  std::function<void(std::size_t)> const &function) {
+  parallel_for(count, get_job_count(), function);
+}
+
+void parallel_for(std::size_t count, unsigned job_count,
+                  std::function<void(std::size_t)> const &function) {
+  ZoneScoped;
+
+  std::size_t const thread_count =
+      in_parallel_region ? 1 : std::min<std::size_t>(job_count, count);
+
+  if (thread_count <= 1) {
+    for (std::size_t i = 0; i < count; i++) {
+      function(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next_index = 0;
+
+  auto worker = [&]() {
+    in_parallel_region = true;
+    for (std::size_t i = next_index++; i < count; i = next_index++) {
+      function(i);
+    }
+    in_parallel_region = false;
+  };
+
+  {
+    // The calling thread takes part in the work, joining happens on scope exit
+    std::vector<std::jthread> threads;
+    threads.reserve(thread_count - 1);
+    for (std::size_t i = 1; i < thread_count; i++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+  }
+}
+
+} // namespace grapher
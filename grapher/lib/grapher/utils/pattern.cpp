@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <string_view>
+
+#include <grapher/utils/pattern.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// Characters with a special meaning in ECMAScript regexes.
+constexpr std::string_view syntax_characters = "^$\\.*+?()[]{}|";
+
+bool is_syntax_character(char character) {
+  return syntax_characters.find(character) != std::string_view::npos;
+}
+
+bool is_quantifier(char character) {
+  return character == '*' || character == '+' || character == '?' ||
+         character == '{';
+}
+
+/// Returns true if the value contains a character that `.` doesn't match.
+bool has_line_terminator(std::string_view value) {
+  return value.find_first_of("\n\r") != std::string_view::npos;
+}
+
+/// Pattern split into literals separated by `.*`.
+struct parsed_pattern_t {
+  pattern_shape_t shape;
+  std::vector<std::string> literals;
+  char repeated_character;
+};
+
+parsed_pattern_t parse_pattern(std::string const &pattern) {
+  // Splitting the pattern into literals separated by `.*`. Any other regex
+  // feature falls back to the regex engine.
+  parsed_pattern_t const regex_pattern{
+      .shape = regex_shape_v, .literals = {}, .repeated_character = '\0'};
+
+  parsed_pattern_t res = regex_pattern;
+  std::string literal;
+  bool is_repeat = false;
+
+  for (std::size_t i = 0; i < pattern.size();) {
+    char const character = pattern[i];
+
+    // Wildcard
+    if (character == '.') {
+      if (i + 1 < pattern.size() && pattern[i + 1] == '*' &&
+          (i + 2 == pattern.size() || !is_quantifier(pattern[i + 2]))) {
+        res.literals.push_back(std::move(literal));
+        literal.clear();
+        i += 2;
+        continue;
+      }
+      return regex_pattern;
+    }
+
+    // Literal character, escaped punctuation is matched literally
+    char literal_character;
+    if (character == '\\') {
+      if (i + 1 == pattern.size() ||
+          std::isalnum(static_cast<unsigned char>(pattern[i + 1])) != 0) {
+        return regex_pattern;
+      }
+      literal_character = pattern[i + 1];
+      i += 2;
+    } else if (is_syntax_character(character)) {
+      return regex_pattern;
+    } else {
+      literal_character = character;
+      i++;
+    }
+
+    // Quantified literal character, only supported at the end of a pattern
+    // without wildcards
+    if (i < pattern.size() && is_quantifier(pattern[i])) {
+      if (pattern[i] != '*' || i + 1 != pattern.size() ||
+          !res.literals.empty()) {
+        return regex_pattern;
+      }
+      res.repeated_character = literal_character;
+      is_repeat = true;
+      i++;
+      continue;
+    }
+
+    literal += literal_character;
+  }
+  res.literals.push_back(std::move(literal));
+
+  if (is_repeat) {
+    res.shape = repeat_shape_v;
+  } else if (res.literals.size() == 1) {
+    res.shape = literal_shape_v;
+  } else if (res.literals.size() == 2 && res.literals[1].empty()) {
+    res.shape = prefix_shape_v;
+  } else if (res.literals.size() == 2 && res.literals[0].empty()) {
+    res.shape = suffix_shape_v;
+  } else {
+    res.shape = glob_shape_v;
+  }
+  return res;
+}
+
+} // namespace
+
+std::optional<std::string> get_pattern_literal(std::string const &pattern) {
+  parsed_pattern_t parsed_pattern = parse_pattern(pattern);
+  if (parsed_pattern.shape != literal_shape_v) {
+    return std::nullopt;
+  }
+  return std::move(parsed_pattern.literals.front());
+}
+
+pattern_matcher_t::pattern_matcher_t(std::string const &pattern) {
+  parsed_pattern_t parsed_pattern = parse_pattern(pattern);
+  shape_ = parsed_pattern.shape;
+  literals_ = std::move(parsed_pattern.literals);
+  repeated_character_ = parsed_pattern.repeated_character;
+
+  // Patterns without wildcards never need the regex engine
+  if (shape_ != literal_shape_v && shape_ != repeat_shape_v) {
+    regex_ = std::regex(pattern, std::regex::ECMAScript | std::regex::optimize);
+  }
+}
+
+bool pattern_matcher_t::operator()(std::string_view value) const {
+  switch (shape_) {
+  case literal_shape_v:
+    return value == literals_.front();
+
+  case repeat_shape_v:
+    return value.starts_with(literals_.front()) &&
+           std::ranges::all_of(value.substr(literals_.front().size()),
+                               [&](char character) -> bool {
+                                 return character == repeated_character_;
+                               });
+
+  case prefix_shape_v:
+  case suffix_shape_v:
+  case glob_shape_v:
+    if (!has_line_terminator(value)) {
+      return match_glob(value);
+    }
+    break;
+
+  case regex_shape_v:
+    break;
+  }
+
+  return std::regex_match(value.begin(), value.end(), regex_);
+}
+
+bool pattern_matcher_t::match_glob(std::string_view value) const {
+  std::string_view const head = literals_.front();
+  std::string_view const tail = literals_.back();
+
+  if (value.size() < head.size() + tail.size() || !value.starts_with(head) ||
+      !value.ends_with(tail)) {
+    return false;
+  }
+
+  // Middle literals are searched from left to right between head and tail
+  std::string_view remainder =
+      value.substr(head.size(), value.size() - head.size() - tail.size());
+  for (std::size_t i = 1; i + 1 < literals_.size(); i++) {
+    std::size_t const position = remainder.find(literals_[i]);
+    if (position == std::string_view::npos) {
+      return false;
+    }
+    remainder.remove_prefix(position + literals_[i].size());
+  }
+  return true;
+}
+
+} // namespace grapher
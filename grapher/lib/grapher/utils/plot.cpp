@@ -0,0 +1,885 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <grapher/utils/plot.hpp>
+#include <grapher/utils/png.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher {
+
+plot_series_t &plot_t::draw_curve(std::vector<double> x, std::vector<double> y,
+                                  std::string label) {
+  return series.emplace_back(plot_series_t{.kind = curve_series_v,
+                                           .label = std::move(label),
+                                           .x = std::move(x),
+                                           .y = std::move(y)});
+}
+
+plot_series_t &plot_t::draw_points(std::vector<double> x,
+                                   std::vector<double> y, std::string label) {
+  return series.emplace_back(plot_series_t{.kind = points_series_v,
+                                           .label = std::move(label),
+                                           .x = std::move(x),
+                                           .y = std::move(y)});
+}
+
+plot_series_t &plot_t::draw_curve_with_error_bars_y(
+    std::vector<double> x, std::vector<double> y, std::vector<double> y_delta,
+    std::string label) {
+  return series.emplace_back(plot_series_t{.kind = error_bars_series_v,
+                                           .label = std::move(label),
+                                           .x = std::move(x),
+                                           .y = std::move(y),
+                                           .y_delta = std::move(y_delta)});
+}
+
+plot_series_t &plot_t::draw_curves_filled(std::vector<double> x,
+                                          std::vector<double> y_low,
+                                          std::vector<double> y_high,
+                                          std::string label) {
+  return series.emplace_back(plot_series_t{.kind = filled_series_v,
+                                           .label = std::move(label),
+                                           .x = std::move(x),
+                                           .y = std::move(y_high),
+                                           .y_low = std::move(y_low)});
+}
+
+namespace {
+
+// =============================================================================
+// Layout
+
+/// Palette indexes. Series colors follow the fixed ones.
+enum color_t : std::uint8_t {
+  background_color_v,
+  foreground_color_v,
+  grid_color_v,
+  first_series_color_v,
+};
+
+/// Fixed colors followed by the series colors (ColorBrewer's Dark2).
+constexpr std::array<rgb_t, 11> palette = {{
+    {0xFF, 0xFF, 0xFF},
+    {0x00, 0x00, 0x00},
+    {0xDD, 0xDD, 0xDD},
+    {0x1B, 0x9E, 0x77},
+    {0xD9, 0x5F, 0x02},
+    {0x75, 0x70, 0xB3},
+    {0xE7, 0x29, 0x8A},
+    {0x66, 0xA6, 0x1E},
+    {0xE6, 0xAB, 0x02},
+    {0xA6, 0x76, 0x1D},
+    {0x66, 0x66, 0x66},
+}};
+
+std::uint8_t get_series_color(std::size_t series_id) {
+  return std::uint8_t(first_series_color_v +
+                      series_id % (palette.size() - first_series_color_v));
+}
+
+using point_t = scene_point_t;
+
+/// Drawing primitives of an output format, see scene_shape_t.
+class painter_t {
+public:
+  virtual ~painter_t() = default;
+
+  virtual void draw_rectangle(point_t top_left, point_t bottom_right,
+                              std::uint8_t color) = 0;
+  virtual void draw_polyline(std::span<point_t const> points,
+                             std::uint8_t color, double line_width) = 0;
+  virtual void draw_polygon(std::span<point_t const> points,
+                            std::uint8_t color) = 0;
+  virtual void draw_marker(point_t position, std::uint8_t color) = 0;
+  virtual void draw_text(point_t position, std::string_view text,
+                         text_anchor_t anchor, bool is_vertical) = 0;
+};
+
+/// Draws the shapes of a scene with a painter.
+void draw_scene(plot_scene_t const &scene, painter_t &painter) {
+  for (scene_shape_t const &shape : scene.shapes) {
+    switch (shape.kind) {
+    case rectangle_shape_v:
+      painter.draw_rectangle(shape.points[0], shape.points[1], shape.color);
+      break;
+    case polyline_shape_v:
+      painter.draw_polyline(shape.points, shape.color, shape.line_width);
+      break;
+    case polygon_shape_v:
+      painter.draw_polygon(shape.points, shape.color);
+      break;
+    case marker_shape_v:
+      painter.draw_marker(shape.points[0], shape.color);
+      break;
+    case text_shape_v:
+      painter.draw_text(shape.points[0], shape.text, shape.anchor,
+                        shape.is_vertical);
+      break;
+    }
+  }
+}
+
+/// Text metrics shared by all the output formats, so a layout fits all of
+/// them: the raster font is 5x8 pixels with 1 pixel spacing, and the SVG
+/// font size matches the line height.
+constexpr double text_height = 10.;
+constexpr double character_advance = 6.;
+
+/// Returns the width of a line of text, counting UTF-8 characters.
+double get_text_width(std::string_view text) {
+  return double(std::ranges::count_if(text, [](char c) {
+           return (std::uint8_t(c) & 0xC0) != 0x80;
+         })) *
+         character_advance;
+}
+
+/// Appends shapes to a scene.
+class scene_builder_t {
+public:
+  explicit scene_builder_t(plot_scene_t &scene) : scene_(scene) {}
+
+  void draw_rectangle(double x, double y, double width, double height,
+                      std::uint8_t color) {
+    scene_.shapes.push_back({.kind = rectangle_shape_v,
+                             .color = color,
+                             .points = {{x, y}, {x + width, y + height}}});
+  }
+
+  void draw_polyline(std::span<point_t const> points, std::uint8_t color,
+                     double line_width) {
+    scene_.shapes.push_back({.kind = polyline_shape_v,
+                             .color = color,
+                             .points = {points.begin(), points.end()},
+                             .line_width = line_width});
+  }
+
+  void draw_polygon(std::vector<point_t> points, std::uint8_t color) {
+    scene_.shapes.push_back({.kind = polygon_shape_v,
+                             .color = color,
+                             .points = std::move(points)});
+  }
+
+  void draw_marker(point_t position, std::uint8_t color) {
+    scene_.shapes.push_back(
+        {.kind = marker_shape_v, .color = color, .points = {position}});
+  }
+
+  void draw_text(point_t position, std::string text, text_anchor_t anchor,
+                 bool is_vertical) {
+    scene_.shapes.push_back({.kind = text_shape_v,
+                             .color = foreground_color_v,
+                             .points = {position},
+                             .text = std::move(text),
+                             .anchor = anchor,
+                             .is_vertical = is_vertical});
+  }
+
+private:
+  plot_scene_t &scene_;
+};
+
+constexpr double series_line_width = 2.;
+constexpr double padding = 8.;
+constexpr double tick_size = 5.;
+constexpr double legend_sample_width = 24.;
+constexpr double legend_spacing = 4.;
+
+/// Returns a round step, 1, 2 or 5 times a power of 10, splitting [min, max]
+/// in about target_count intervals.
+double get_tick_step(double min, double max, std::size_t target_count) {
+  double const raw_step =
+      (max - min) / double(std::max<std::size_t>(target_count, 1));
+  double const magnitude = std::pow(10., std::floor(std::log10(raw_step)));
+  for (double const factor : {1., 2., 5.}) {
+    if (magnitude * factor >= raw_step) {
+      return magnitude * factor;
+    }
+  }
+  return magnitude * 10.;
+}
+
+/// Widens [min, max] to multiples of step.
+void round_bounds(double &min, double &max, double step) {
+  min = std::floor(min / step) * step;
+  max = std::ceil(max / step) * step;
+}
+
+/// Returns the multiples of step in [min, max].
+std::vector<double> make_ticks(double min, double max, double step) {
+  std::vector<double> res;
+  // Tolerance for rounding errors of the bounds
+  double const epsilon = step * 1e-9;
+  for (double tick = std::ceil(min / step - 1e-9) * step; tick <= max + epsilon;
+       tick += step) {
+    // Avoids printing rounding errors such as -0 or 1e-17
+    res.push_back(std::abs(tick) < epsilon ? 0. : tick);
+  }
+  return res;
+}
+
+std::string format_tick(double value) { return fmt::format("{:g}", value); }
+
+/// Widens empty or invalid axis bounds.
+void fix_bounds(double &min, double &max) {
+  if (!std::isfinite(min) || !std::isfinite(max)) {
+    min = 0.;
+    max = 1.;
+  } else if (min == max) {
+    double const margin = min == 0. ? 1. : std::abs(min) / 2.;
+    min -= margin;
+    max += margin;
+  }
+}
+
+/// Lays out a plot into a scene.
+void draw_plot(plot_t const &plot, double width, double height,
+               scene_builder_t &scene) {
+  double const line_height = text_height + legend_spacing;
+
+  // Data bounds
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+  double x_min = infinity;
+  double x_max = -infinity;
+  double y_min = infinity;
+  double y_max = -infinity;
+  for (plot_series_t const &series : plot.series) {
+    for (std::size_t i = 0; i < series.x.size() && i < series.y.size(); i++) {
+      x_min = std::min(x_min, series.x[i]);
+      x_max = std::max(x_max, series.x[i]);
+      double const delta = i < series.y_delta.size() ? series.y_delta[i] : 0.;
+      y_min = std::min(y_min, series.y[i] - delta);
+      y_max = std::max(y_max, series.y[i] + delta);
+      if (i < series.y_low.size()) {
+        y_min = std::min(y_min, series.y_low[i]);
+      }
+    }
+  }
+  if (plot.y_range) {
+    std::tie(y_min, y_max) = *plot.y_range;
+  }
+  fix_bounds(x_min, x_max);
+  fix_bounds(y_min, y_max);
+
+  // Legend entries
+  std::vector<std::size_t> legend_entries;
+  for (std::size_t i = 0; i < plot.series.size(); i++) {
+    if (!plot.series[i].label.empty()) {
+      legend_entries.push_back(i);
+    }
+  }
+  if (plot.legend_from_last) {
+    std::ranges::reverse(legend_entries);
+  }
+
+  double legend_entry_width = get_text_width(plot.legend_title);
+  for (std::size_t series_id : legend_entries) {
+    legend_entry_width = std::max(
+        legend_entry_width,
+        legend_sample_width + padding +
+            get_text_width(plot.series[series_id].label));
+  }
+  legend_entry_width += padding * 2.;
+
+  std::size_t const title_lines = plot.legend_title.empty() ? 0 : 1;
+
+  // Margins
+  double left = padding;
+  double right = width - padding;
+  double top = padding + text_height / 2.;
+  double bottom = height - padding;
+
+  std::size_t legend_columns = 1;
+  if (!legend_entries.empty() && plot.legend_position == legend_right_v) {
+    right -= legend_entry_width;
+  } else if (!legend_entries.empty()) {
+    legend_columns = std::max<std::size_t>(
+        1, std::size_t((width - padding * 2.) / legend_entry_width));
+    std::size_t const legend_rows =
+        (legend_entries.size() + legend_columns - 1) / legend_columns;
+    bottom -= double(legend_rows + title_lines) * line_height + padding;
+  }
+
+  if (!plot.x_label.empty()) {
+    bottom -= line_height;
+  }
+  bottom -= tick_size + line_height;
+
+  if (!plot.y_label.empty()) {
+    left += line_height;
+  }
+
+  // Ticks need the graph size, and the y tick labels take horizontal space.
+  // Bounds computed from the data are widened to round values.
+  std::size_t const y_tick_count =
+      std::size_t(std::max(bottom - top, 0.) / (text_height * 4.));
+  double const y_step = get_tick_step(y_min, y_max, y_tick_count);
+  if (!plot.y_range) {
+    round_bounds(y_min, y_max, y_step);
+  }
+  std::vector<double> const y_ticks = make_ticks(y_min, y_max, y_step);
+
+  double y_tick_width = 0.;
+  for (double tick : y_ticks) {
+    y_tick_width = std::max(y_tick_width,
+                            get_text_width(format_tick(tick)));
+  }
+  left += y_tick_width + tick_size + padding / 2.;
+
+  constexpr double x_tick_spacing = 80.;
+  std::size_t const x_tick_count =
+      std::size_t(std::max(right - left, 0.) / x_tick_spacing);
+  double const x_step = get_tick_step(x_min, x_max, x_tick_count);
+  round_bounds(x_min, x_max, x_step);
+  std::vector<double> const x_ticks = make_ticks(x_min, x_max, x_step);
+
+  // Keep a usable graph area however small the image is
+  right = std::max(right, left + 1.);
+  bottom = std::max(bottom, top + 1.);
+
+  auto to_pixels = [&](double x, double y) {
+    double const px = left + (x - x_min) / (x_max - x_min) * (right - left);
+    double const py = bottom - (y - y_min) / (y_max - y_min) * (bottom - top);
+    return point_t{std::clamp(px, left, right), std::clamp(py, top, bottom)};
+  };
+
+  // Background, grid, and ticks
+  scene.draw_rectangle(0., 0., width, height, background_color_v);
+
+  for (double tick : y_ticks) {
+    double const y = to_pixels(x_min, tick).y;
+    std::array<point_t, 2> const grid = {{{left, y}, {right, y}}};
+    scene.draw_polyline(grid, grid_color_v, 1.);
+    std::array<point_t, 2> const mark = {{{left - tick_size, y}, {left, y}}};
+    scene.draw_polyline(mark, foreground_color_v, 1.);
+    scene.draw_text({left - tick_size - padding / 2., y}, format_tick(tick),
+                      anchor_end_v, false);
+  }
+
+  for (double tick : x_ticks) {
+    double const x = to_pixels(tick, y_min).x;
+    std::array<point_t, 2> const grid = {{{x, top}, {x, bottom}}};
+    scene.draw_polyline(grid, grid_color_v, 1.);
+    std::array<point_t, 2> const mark = {
+        {{x, bottom}, {x, bottom + tick_size}}};
+    scene.draw_polyline(mark, foreground_color_v, 1.);
+    scene.draw_text({x, bottom + tick_size + line_height / 2.},
+                      format_tick(tick), anchor_middle_v, false);
+  }
+
+  // Series
+  for (std::size_t series_id = 0; series_id < plot.series.size();
+       series_id++) {
+    plot_series_t const &series = plot.series[series_id];
+    std::uint8_t const color = get_series_color(series_id);
+    std::size_t const size = std::min(series.x.size(), series.y.size());
+
+    std::vector<point_t> points;
+    points.reserve(size * 2);
+    for (std::size_t i = 0; i < size; i++) {
+      points.push_back(to_pixels(series.x[i], series.y[i]));
+    }
+
+    switch (series.kind) {
+    case curve_series_v:
+      scene.draw_polyline(points, color, series_line_width);
+      break;
+
+    case points_series_v:
+      for (point_t const &point : points) {
+        scene.draw_marker(point, color);
+      }
+      break;
+
+    case error_bars_series_v:
+      scene.draw_polyline(points, color, series_line_width);
+      for (std::size_t i = 0; i < size && i < series.y_delta.size(); i++) {
+        std::array<point_t, 2> const bar = {
+            {to_pixels(series.x[i], series.y[i] - series.y_delta[i]),
+             to_pixels(series.x[i], series.y[i] + series.y_delta[i])}};
+        scene.draw_polyline(bar, color, 1.);
+      }
+      break;
+
+    case filled_series_v:
+      for (std::size_t i = std::min(size, series.y_low.size()); i-- > 0;) {
+        points.push_back(to_pixels(series.x[i], series.y_low[i]));
+      }
+      scene.draw_polygon(std::move(points), color);
+      break;
+    }
+  }
+
+  // Frame and axis labels
+  std::array<point_t, 5> const frame = {{{left, top},
+                                         {right, top},
+                                         {right, bottom},
+                                         {left, bottom},
+                                         {left, top}}};
+  scene.draw_polyline(frame, foreground_color_v, 1.);
+
+  double label_y = bottom + tick_size + line_height;
+  if (!plot.x_label.empty()) {
+    scene.draw_text({(left + right) / 2., label_y + line_height / 2.},
+                      plot.x_label, anchor_middle_v, false);
+    label_y += line_height;
+  }
+  if (!plot.y_label.empty()) {
+    scene.draw_text({padding + text_height / 2., (top + bottom) / 2.},
+                      plot.y_label, anchor_middle_v, true);
+  }
+
+  // Legend
+  if (legend_entries.empty()) {
+    return;
+  }
+
+  double legend_x = right + padding * 2.;
+  double legend_y = top + text_height / 2.;
+  if (plot.legend_position == legend_bottom_v) {
+    legend_x = padding;
+    legend_y = label_y + padding + line_height / 2.;
+  }
+
+  if (title_lines != 0) {
+    scene.draw_text({legend_x, legend_y}, plot.legend_title, anchor_start_v,
+                      false);
+    legend_y += line_height;
+  }
+
+  for (std::size_t i = 0; i < legend_entries.size(); i++) {
+    plot_series_t const &series = plot.series[legend_entries[i]];
+    std::uint8_t const color = get_series_color(legend_entries[i]);
+    double const x =
+        legend_x + double(i % legend_columns) * legend_entry_width;
+    double const y = legend_y + double(i / legend_columns) * line_height;
+
+    switch (series.kind) {
+    case points_series_v:
+      scene.draw_marker({x + legend_sample_width / 2., y}, color);
+      break;
+
+    case filled_series_v:
+      scene.draw_rectangle(x, y - text_height / 2., legend_sample_width,
+                             text_height, color);
+      break;
+
+    default: {
+      std::array<point_t, 2> const sample = {
+          {{x, y}, {x + legend_sample_width, y}}};
+      scene.draw_polyline(sample, color, series_line_width);
+    }
+    }
+
+    scene.draw_text({x + legend_sample_width + padding, y}, series.label,
+                      anchor_start_v, false);
+  }
+}
+
+// =============================================================================
+// SVG rendering
+
+std::string escape_xml(std::string_view text) {
+  std::string res;
+  res.reserve(text.size());
+  for (char c : text) {
+    switch (c) {
+    case '&':
+      res += "&amp;";
+      break;
+    case '<':
+      res += "&lt;";
+      break;
+    case '>':
+      res += "&gt;";
+      break;
+    case '"':
+      res += "&quot;";
+      break;
+    default:
+      res += c;
+    }
+  }
+  return res;
+}
+
+std::string to_svg_color(std::uint8_t color) {
+  rgb_t const &rgb = palette[color];
+  return fmt::format("#{:02X}{:02X}{:02X}", rgb.r, rgb.g, rgb.b);
+}
+
+class svg_painter_t final : public painter_t {
+public:
+  explicit svg_painter_t(std::string &out) : out_(out) {}
+
+  void draw_rectangle(point_t top_left, point_t bottom_right,
+                      std::uint8_t color) override {
+    fmt::format_to(
+        std::back_inserter(out_),
+        "<rect x=\"{:.1f}\" y=\"{:.1f}\" width=\"{:.1f}\" height=\"{:.1f}\" "
+        "fill=\"{}\"/>\n",
+        top_left.x, top_left.y, bottom_right.x - top_left.x,
+        bottom_right.y - top_left.y, to_svg_color(color));
+  }
+
+  void draw_polyline(std::span<point_t const> points, std::uint8_t color,
+                     double line_width) override {
+    if (points.empty()) {
+      return;
+    }
+    out_ += "<polyline points=\"";
+    append_points(points);
+    fmt::format_to(std::back_inserter(out_),
+                   "\" fill=\"none\" stroke=\"{}\" stroke-width=\"{}\"/>\n",
+                   to_svg_color(color), line_width);
+  }
+
+  void draw_polygon(std::span<point_t const> points,
+                    std::uint8_t color) override {
+    if (points.empty()) {
+      return;
+    }
+    out_ += "<polygon points=\"";
+    append_points(points);
+    fmt::format_to(std::back_inserter(out_), "\" fill=\"{}\"/>\n",
+                   to_svg_color(color));
+  }
+
+  void draw_marker(point_t position, std::uint8_t color) override {
+    fmt::format_to(
+        std::back_inserter(out_),
+        "<path d=\"M{:.1f} {:.1f}h6M{:.1f} {:.1f}v6\" stroke=\"{}\"/>\n",
+        position.x - 3., position.y, position.x, position.y - 3.,
+        to_svg_color(color));
+  }
+
+  void draw_text(point_t position, std::string_view text, text_anchor_t anchor,
+                 bool is_vertical) override {
+    constexpr std::array<std::string_view, 3> anchors = {"start", "middle",
+                                                         "end"};
+    fmt::format_to(std::back_inserter(out_),
+                   "<text x=\"{:.1f}\" y=\"{:.1f}\" text-anchor=\"{}\" "
+                   "dominant-baseline=\"middle\"",
+                   position.x, position.y, anchors[anchor]);
+    if (is_vertical) {
+      fmt::format_to(std::back_inserter(out_),
+                     " transform=\"rotate(-90 {:.1f} {:.1f})\"", position.x,
+                     position.y);
+    }
+    fmt::format_to(std::back_inserter(out_), ">{}</text>\n",
+                   escape_xml(text));
+  }
+
+private:
+  /// Appends a coordinate with one decimal, formatted as an integer number of
+  /// tenths which is much faster than fixed precision float formatting.
+  void append_coordinate(double value) {
+    long long const tenths = std::llround(value * 10.);
+    unsigned long long const magnitude =
+        tenths < 0 ? 0ULL - static_cast<unsigned long long>(tenths)
+                   : static_cast<unsigned long long>(tenths);
+    fmt::format_to(std::back_inserter(out_), "{}{}.{}", tenths < 0 ? "-" : "",
+                   magnitude / 10, magnitude % 10);
+  }
+
+  /// Points are formatted in place, without a temporary string per point.
+  void append_points(std::span<point_t const> points) {
+    for (point_t const &point : points) {
+      append_coordinate(point.x);
+      out_ += ',';
+      append_coordinate(point.y);
+      out_ += ' ';
+    }
+    out_.pop_back();
+  }
+
+  std::string &out_;
+};
+
+// =============================================================================
+// Raster rendering
+
+constexpr std::size_t glyph_width = 5;
+constexpr std::size_t glyph_height = 8;
+constexpr std::size_t glyph_advance = std::size_t(character_advance);
+
+/// 5x8 bitmap font for printable ASCII characters. Each byte is a column,
+/// with the top row in the least significant bit.
+constexpr std::array<std::array<std::uint8_t, glyph_width>, 95> font = {{
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00},
+    {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7F, 0x14, 0x7F, 0x14},
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x08, 0x07, 0x03, 0x00},
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1C, 0x00},
+    {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+    {0x00, 0x80, 0x70, 0x30, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08},
+    {0x00, 0x00, 0x60, 0x60, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02},
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33},
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39},
+    {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E},
+    {0x00, 0x00, 0x14, 0x00, 0x00}, {0x00, 0x40, 0x34, 0x00, 0x00},
+    {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x59, 0x09, 0x06},
+    {0x3E, 0x41, 0x5D, 0x59, 0x4E}, {0x7C, 0x12, 0x11, 0x12, 0x7C},
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x7F, 0x41, 0x41, 0x41, 0x3E}, {0x7F, 0x49, 0x49, 0x49, 0x41},
+    {0x7F, 0x09, 0x09, 0x09, 0x01}, {0x3E, 0x41, 0x41, 0x51, 0x73},
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41},
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, {0x7F, 0x02, 0x1C, 0x02, 0x7F},
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E},
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, {0x26, 0x49, 0x49, 0x49, 0x32},
+    {0x03, 0x01, 0x7F, 0x01, 0x03}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F},
+    {0x63, 0x14, 0x08, 0x14, 0x63}, {0x03, 0x04, 0x78, 0x04, 0x03},
+    {0x61, 0x59, 0x49, 0x4D, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x41},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x41, 0x7F},
+    {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40},
+    {0x00, 0x03, 0x07, 0x08, 0x00}, {0x20, 0x54, 0x54, 0x78, 0x40},
+    {0x7F, 0x28, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x28},
+    {0x38, 0x44, 0x44, 0x28, 0x7F}, {0x38, 0x54, 0x54, 0x54, 0x18},
+    {0x00, 0x08, 0x7E, 0x09, 0x02}, {0x18, 0xA4, 0xA4, 0x9C, 0x78},
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00},
+    {0x20, 0x40, 0x40, 0x3D, 0x00}, {0x7F, 0x10, 0x28, 0x44, 0x00},
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x78, 0x04, 0x78},
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38},
+    {0xFC, 0x18, 0x24, 0x24, 0x18}, {0x18, 0x24, 0x24, 0x18, 0xFC},
+    {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x24},
+    {0x04, 0x04, 0x3F, 0x44, 0x24}, {0x3C, 0x40, 0x40, 0x20, 0x7C},
+    {0x1C, 0x20, 0x40, 0x20, 0x1C}, {0x3C, 0x40, 0x30, 0x40, 0x3C},
+    {0x44, 0x28, 0x10, 0x28, 0x44}, {0x4C, 0x90, 0x90, 0x90, 0x7C},
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00},
+    {0x00, 0x00, 0x77, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00},
+    {0x02, 0x01, 0x02, 0x04, 0x02},
+}};
+
+/// Maps UTF-8 text to font characters: 'µ' becomes 'u', and other non-ASCII
+/// characters become '?'.
+std::string to_font_characters(std::string_view text) {
+  std::string res;
+  res.reserve(text.size());
+  for (std::size_t i = 0; i < text.size(); i++) {
+    auto const byte = std::uint8_t(text[i]);
+    if (byte < 0x80) {
+      res += byte >= 0x20 && byte < 0x7F ? char(byte) : '?';
+      continue;
+    }
+    if ((byte & 0xC0) == 0x80) {
+      continue;
+    }
+    bool const is_micro =
+        text.substr(i, 2) == "\xC2\xB5" || text.substr(i, 2) == "\xCE\xBC";
+    res += is_micro ? 'u' : '?';
+  }
+  return res;
+}
+
+class raster_painter_t final : public painter_t {
+public:
+  raster_painter_t(std::size_t width, std::size_t height)
+      : width_(width), height_(height),
+        pixels_(width * height, background_color_v) {}
+
+  std::span<std::uint8_t const> get_pixels() const { return pixels_; }
+
+  void draw_rectangle(point_t top_left, point_t bottom_right,
+                      std::uint8_t color) override {
+    auto const [x_begin, x_end] = to_range(top_left.x, bottom_right.x, width_);
+    auto const [y_begin, y_end] = to_range(top_left.y, bottom_right.y, height_);
+    for (std::size_t row = y_begin; row < y_end; row++) {
+      std::fill(pixels_.begin() + std::ptrdiff_t(row * width_ + x_begin),
+                pixels_.begin() + std::ptrdiff_t(row * width_ + x_end), color);
+    }
+  }
+
+  void draw_polyline(std::span<point_t const> points, std::uint8_t color,
+                     double line_width) override {
+    bool const is_thick = line_width > 1.;
+    for (std::size_t i = 1; i < points.size(); i++) {
+      draw_line(points[i - 1], points[i], color, is_thick);
+    }
+  }
+
+  /// Fills a polygon with the even-odd rule, sampling pixel centers.
+  void draw_polygon(std::span<point_t const> points,
+                    std::uint8_t color) override {
+    if (points.size() < 3) {
+      return;
+    }
+    auto const [min_it, max_it] = std::ranges::minmax_element(
+        points, {}, [](point_t const &point) { return point.y; });
+    auto const [y_begin, y_end] = to_range(min_it->y, max_it->y + 1., height_);
+
+    std::vector<double> crossings;
+    for (std::size_t row = y_begin; row < y_end; row++) {
+      double const y = double(row) + .5;
+      crossings.clear();
+      for (std::size_t i = 0; i < points.size(); i++) {
+        point_t const &a = points[i];
+        point_t const &b = points[(i + 1) % points.size()];
+        if ((a.y <= y) != (b.y <= y)) {
+          crossings.push_back(a.x + (y - a.y) / (b.y - a.y) * (b.x - a.x));
+        }
+      }
+      std::ranges::sort(crossings);
+      for (std::size_t i = 0; i + 1 < crossings.size(); i += 2) {
+        auto const [x_begin, x_end] =
+            to_range(crossings[i] + .5, crossings[i + 1] + .5, width_);
+        std::fill(pixels_.begin() + std::ptrdiff_t(row * width_ + x_begin),
+                  pixels_.begin() + std::ptrdiff_t(row * width_ + x_end),
+                  color);
+      }
+    }
+  }
+
+  void draw_marker(point_t position, std::uint8_t color) override {
+    draw_line({position.x - 3., position.y}, {position.x + 3., position.y},
+              color, false);
+    draw_line({position.x, position.y - 3.}, {position.x, position.y + 3.},
+              color, false);
+  }
+
+  void draw_text(point_t position, std::string_view text, text_anchor_t anchor,
+                 bool is_vertical) override {
+    std::string const characters = to_font_characters(text);
+    double const width = double(characters.size() * glyph_advance) - 1.;
+
+    // Offset of the text start along the reading direction
+    double start = 0.;
+    if (anchor == anchor_middle_v) {
+      start = -width / 2.;
+    } else if (anchor == anchor_end_v) {
+      start = -width;
+    }
+    auto const origin_x = std::ptrdiff_t(std::lround(position.x));
+    auto const origin_y = std::ptrdiff_t(std::lround(position.y));
+    auto const top = std::ptrdiff_t(glyph_height / 2);
+    auto const first = std::ptrdiff_t(std::lround(start));
+
+    for (std::size_t char_id = 0; char_id < characters.size(); char_id++) {
+      std::array<std::uint8_t, glyph_width> const &glyph =
+          font[std::size_t(characters[char_id] - ' ')];
+      for (std::size_t column = 0; column < glyph_width; column++) {
+        for (std::size_t row = 0; row < glyph_height; row++) {
+          if (((glyph[column] >> row) & 1) == 0) {
+            continue;
+          }
+          // Offsets along and across the reading direction
+          std::ptrdiff_t const along =
+              first + std::ptrdiff_t(char_id * glyph_advance + column);
+          std::ptrdiff_t const across = std::ptrdiff_t(row) - top;
+          if (is_vertical) {
+            set_pixel(origin_x + across, origin_y - along, foreground_color_v);
+          } else {
+            set_pixel(origin_x + along, origin_y + across, foreground_color_v);
+          }
+        }
+      }
+    }
+  }
+
+private:
+  /// Returns the pixel range covering [begin, end), clamped to [0, size).
+  static std::pair<std::size_t, std::size_t> to_range(double begin, double end,
+                                                      std::size_t size) {
+    auto clamp = [&](double value) {
+      return std::size_t(std::clamp(std::round(value), 0., double(size)));
+    };
+    std::size_t const first = clamp(begin);
+    return {first, std::max(first, clamp(end))};
+  }
+
+  void set_pixel(std::ptrdiff_t x, std::ptrdiff_t y, std::uint8_t color) {
+    if (x >= 0 && y >= 0 && std::size_t(x) < width_ &&
+        std::size_t(y) < height_) {
+      pixels_[std::size_t(y) * width_ + std::size_t(x)] = color;
+    }
+  }
+
+  /// Bresenham line. Thick lines are 2 pixels wide.
+  void draw_line(point_t from, point_t to, std::uint8_t color, bool is_thick) {
+    auto x = std::ptrdiff_t(std::lround(from.x));
+    auto y = std::ptrdiff_t(std::lround(from.y));
+    auto const x_end = std::ptrdiff_t(std::lround(to.x));
+    auto const y_end = std::ptrdiff_t(std::lround(to.y));
+
+    std::ptrdiff_t const dx = std::abs(x_end - x);
+    std::ptrdiff_t const dy = -std::abs(y_end - y);
+    std::ptrdiff_t const step_x = x < x_end ? 1 : -1;
+    std::ptrdiff_t const step_y = y < y_end ? 1 : -1;
+    std::ptrdiff_t error = dx + dy;
+
+    for (;;) {
+      set_pixel(x, y, color);
+      if (is_thick) {
+        set_pixel(x + 1, y, color);
+        set_pixel(x, y + 1, color);
+        set_pixel(x + 1, y + 1, color);
+      }
+      if (x == x_end && y == y_end) {
+        break;
+      }
+      std::ptrdiff_t const error_2 = error * 2;
+      if (error_2 >= dy) {
+        error += dy;
+        x += step_x;
+      }
+      if (error_2 <= dx) {
+        error += dx;
+        y += step_y;
+      }
+    }
+  }
+
+  std::size_t width_;
+  std::size_t height_;
+  std::vector<std::uint8_t> pixels_;
+};
+
+} // namespace
+
+plot_scene_t layout_plot(plot_t const &plot, std::size_t width,
+                         std::size_t height) {
+  ZoneScoped;
+  plot_scene_t res{.width = width, .height = height, .shapes = {}};
+  scene_builder_t builder(res);
+  draw_plot(plot, double(width), double(height), builder);
+  return res;
+}
+
+std::string to_svg(plot_scene_t const &scene) {
+  ZoneScoped;
+  std::string res = fmt::format(
+      "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"{0}\" "
+      "height=\"{1}\" viewBox=\"0 0 {0} {1}\" font-family=\"sans-serif\" "
+      "font-size=\"{2}\">\n",
+      scene.width, scene.height, text_height);
+  svg_painter_t painter(res);
+  draw_scene(scene, painter);
+  res += "</svg>\n";
+  return res;
+}
+
+std::string to_png(plot_scene_t const &scene) {
+  ZoneScoped;
+  raster_painter_t painter(scene.width, scene.height);
+  draw_scene(scene, painter);
+  return encode_png(scene.width, scene.height, palette, painter.get_pixels());
+}
+
+} // namespace grapher
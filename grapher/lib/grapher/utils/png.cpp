@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <grapher/utils/deflate.hpp>
+#include <grapher/utils/png.hpp>
+
+namespace grapher {
+
+namespace {
+
+void append_u32(std::string &out, std::uint32_t value) {
+  out += char(value >> 24);
+  out += char(value >> 16);
+  out += char(value >> 8);
+  out += char(value);
+}
+
+void append_chunk(std::string &out, std::string_view type,
+                  std::string_view data) {
+  append_u32(out, std::uint32_t(data.size()));
+  std::string typed_data;
+  typed_data.reserve(type.size() + data.size());
+  typed_data.append(type);
+  typed_data.append(data);
+  out += typed_data;
+  append_u32(out, get_crc32(typed_data));
+}
+
+} // namespace
+
+std::string encode_png(std::size_t width, std::size_t height,
+                       std::span<rgb_t const> palette,
+                       std::span<std::uint8_t const> pixels) {
+  // Each row is prefixed by its filter type, 0 being no filter
+  std::size_t const row_size = width + 1;
+  std::vector<std::uint8_t> filtered(row_size * height, 0);
+  for (std::size_t y = 0; y < height; y++) {
+    std::ranges::copy(pixels.subspan(y * width, width),
+                      filtered.begin() + std::ptrdiff_t(y * row_size + 1));
+  }
+
+  std::string res = "\x89PNG\r\n\x1A\n";
+
+  std::string header;
+  append_u32(header, std::uint32_t(width));
+  append_u32(header, std::uint32_t(height));
+  header += char(8); // Bit depth
+  header += char(3); // Indexed color
+  header += char(0); // Deflate compression
+  header += char(0); // Adaptive filtering
+  header += char(0); // No interlacing
+  append_chunk(res, "IHDR", header);
+
+  std::string palette_data;
+  for (rgb_t const &color : palette) {
+    palette_data += char(color.r);
+    palette_data += char(color.g);
+    palette_data += char(color.b);
+  }
+  append_chunk(res, "PLTE", palette_data);
+
+  // zlib stream: header with a 32K window, deflate data, and Adler-32
+  std::vector<std::uint8_t> const compressed = deflate(filtered);
+  std::string image_data = "\x78\x01";
+  image_data.append(compressed.begin(), compressed.end());
+  append_u32(image_data, get_adler32(filtered));
+  append_chunk(res, "IDAT", image_data);
+
+  append_chunk(res, "IEND", "");
+  return res;
+}
+
+} // namespace grapher
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <grapher/utils/error.hpp>
+#include <grapher/utils/gnuplot.hpp>
+#include <grapher/utils/parallel.hpp>
+#include <grapher/utils/render.hpp>
+#include <grapher/utils/tracy.hpp>
+
+namespace grapher {
+
+namespace {
+
+/// Render job count set from the command line, 0 meaning hardware
+/// concurrency
+std::atomic<unsigned> render_job_count_setting = 0;
+
+/// gnuplot sessions shared by the calls of a render_parallel loop. Sessions
+/// are started on demand, so there are at most as many as concurrent calls.
+class session_pool_t {
+public:
+  /// Takes an idle session, or starts a new one.
+  std::unique_ptr<gnuplot_session_t> acquire() {
+    {
+      std::scoped_lock const lock(mutex_);
+      if (!idle_sessions_.empty()) {
+        std::unique_ptr<gnuplot_session_t> session =
+            std::move(idle_sessions_.back());
+        idle_sessions_.pop_back();
+        return session;
+      }
+    }
+    return std::make_unique<gnuplot_session_t>();
+  }
+
+  /// Gives a session back to the pool. Sessions that stopped accepting
+  /// commands were reported already, and are dropped.
+  void release(std::unique_ptr<gnuplot_session_t> session) {
+    if (!session->is_open()) {
+      return;
+    }
+    std::scoped_lock const lock(mutex_);
+    idle_sessions_.push_back(std::move(session));
+  }
+
+  /// Closes the sessions and waits for them to finish rendering. Returns the
+  /// last destinations sent to the sessions that failed, sorted so the report
+  /// doesn't depend on how plots were spread across sessions.
+  std::vector<std::string> close() {
+    std::vector<std::string> res;
+    for (std::unique_ptr<gnuplot_session_t> &session : idle_sessions_) {
+      if (!session->close()) {
+        res.push_back(session->get_last_destination());
+      }
+    }
+    idle_sessions_.clear();
+    std::ranges::sort(res);
+    return res;
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<gnuplot_session_t>> idle_sessions_;
+};
+
+/// Render call running on a thread, and the session lent to it
+struct render_call_t {
+  session_pool_t &pool;
+  std::unique_ptr<gnuplot_session_t> session = nullptr;
+};
+
+thread_local render_call_t *current_render_call = nullptr;
+
+} // namespace
+
+void set_render_job_count(unsigned job_count) {
+  render_job_count_setting = job_count;
+}
+
+unsigned get_render_job_count() {
+  if (unsigned const job_count = render_job_count_setting; job_count != 0) {
+    return job_count;
+  }
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void render_parallel(std::size_t count,
+                     std::function<void(std::size_t)> const &render) {
+  ZoneScoped;
+
+  // Exceptions are kept by index and reported once every plot is rendered
+  std::vector<std::exception_ptr> exceptions(count);
+  session_pool_t pool;
+
+  parallel_for(count, get_render_job_count(), [&](std::size_t i) {
+    render_call_t call{.pool = pool, .session = nullptr};
+    render_call_t *const previous_call =
+        std::exchange(current_render_call, &call);
+
+    try {
+      render(i);
+    } catch (...) {
+      exceptions[i] = std::current_exception();
+    }
+
+    current_render_call = previous_call;
+    if (call.session != nullptr) {
+      pool.release(std::move(call.session));
+    }
+  });
+
+  // Waiting for gnuplot sessions to write their files
+  for (std::string const &destination : pool.close()) {
+    warn(fmt::format("A gnuplot session exited with an error. The last plot "
+                     "sent to it was {}.",
+                     destination));
+  }
+
+  for (std::exception_ptr const &exception : exceptions) {
+    if (exception != nullptr) {
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
+gnuplot_session_t *get_render_session() {
+  if (current_render_call == nullptr) {
+    return nullptr;
+  }
+
+  std::unique_ptr<gnuplot_session_t> &session = current_render_call->session;
+  if (session == nullptr || !session->is_open()) {
+    session = current_render_call->pool.acquire();
+  }
+  return session.get();
+}
+
+std::mutex &get_sciplot_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+} // namespace grapher
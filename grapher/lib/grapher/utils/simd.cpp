@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+
+#include <grapher/utils/simd.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GRAPHER_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace grapher::simd {
+
+namespace {
+
+using mask_equal_function_t = void (*)(std::span<std::uint32_t const>,
+                                       std::uint32_t, std::span<std::uint64_t>);
+
+using mask_in_bitmap_function_t = void (*)(std::span<std::uint32_t const>,
+                                           std::span<std::uint32_t const>,
+                                           std::span<std::uint64_t>);
+
+using mask_in_range_function_t = void (*)(std::span<std::uint64_t const>,
+                                          std::uint64_t, std::uint64_t,
+                                          std::span<std::uint64_t>);
+
+using mask_any_bits_function_t = void (*)(std::span<std::uint8_t const>,
+                                          std::uint8_t,
+                                          std::span<std::uint64_t>);
+
+/// Kernels selected for the current CPU.
+struct kernels_t {
+  std::string_view instruction_set;
+  mask_equal_function_t mask_equal;
+  mask_in_bitmap_function_t mask_in_bitmap;
+  mask_in_range_function_t mask_in_range;
+  mask_any_bits_function_t mask_any_bits;
+};
+
+/// Sets bit i of mask if is_set(values[i]) is true. Used by the portable
+/// kernels, and by the vectorized ones for the values past the last full mask
+/// word.
+template <typename ValueType, typename PredicateType>
+void mask_if(std::span<ValueType const> values, std::span<std::uint64_t> mask,
+             PredicateType is_set) {
+  std::size_t const word_count = get_mask_word_count(values.size());
+  for (std::size_t word_id = 0; word_id < word_count; word_id++) {
+    std::size_t const begin = word_id * mask_word_bits;
+    std::size_t const end = std::min(values.size(), begin + mask_word_bits);
+
+    std::uint64_t word = 0;
+    for (std::size_t i = begin; i < end; i++) {
+      word |= std::uint64_t(is_set(values[i])) << (i - begin);
+    }
+    mask[word_id] = word;
+  }
+}
+
+#ifdef GRAPHER_SIMD_X86
+
+__attribute__((target("sse2"))) void
+mask_equal_sse2(std::span<std::uint32_t const> values, std::uint32_t key,
+                std::span<std::uint64_t> mask) {
+  __m128i const key_vector = _mm_set1_epi32(static_cast<int>(key));
+
+  // Full mask words first, 4 values per comparison
+  std::size_t const full_words = values.size() / mask_word_bits;
+  for (std::size_t word_id = 0; word_id < full_words; word_id++) {
+    std::uint32_t const *word_values = values.data() + word_id * mask_word_bits;
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < mask_word_bits; i += 4) {
+      __m128i const value_vector = _mm_loadu_si128(
+          reinterpret_cast<__m128i const *>(word_values + i));
+      int const bits = _mm_movemask_ps(
+          _mm_castsi128_ps(_mm_cmpeq_epi32(value_vector, key_vector)));
+      word |= std::uint64_t(static_cast<unsigned>(bits)) << i;
+    }
+    mask[word_id] = word;
+  }
+
+  mask_equal_scalar(values.subspan(full_words * mask_word_bits), key,
+                    mask.subspan(full_words));
+}
+
+__attribute__((target("sse2"))) void
+mask_any_bits_sse2(std::span<std::uint8_t const> values, std::uint8_t bits,
+                   std::span<std::uint64_t> mask) {
+  __m128i const bits_vector = _mm_set1_epi8(static_cast<char>(bits));
+  __m128i const zero = _mm_setzero_si128();
+
+  // Full mask words first, 16 values per comparison
+  std::size_t const full_words = values.size() / mask_word_bits;
+  for (std::size_t word_id = 0; word_id < full_words; word_id++) {
+    std::uint8_t const *word_values = values.data() + word_id * mask_word_bits;
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < mask_word_bits; i += 16) {
+      __m128i const value_vector = _mm_loadu_si128(
+          reinterpret_cast<__m128i const *>(word_values + i));
+      int const clear_bits = _mm_movemask_epi8(
+          _mm_cmpeq_epi8(_mm_and_si128(value_vector, bits_vector), zero));
+      word |= std::uint64_t(~static_cast<unsigned>(clear_bits) & 0xFFFFu)
+              << i;
+    }
+    mask[word_id] = word;
+  }
+
+  mask_any_bits_scalar(values.subspan(full_words * mask_word_bits), bits,
+                       mask.subspan(full_words));
+}
+
+__attribute__((target("avx2"))) void
+mask_equal_avx2(std::span<std::uint32_t const> values, std::uint32_t key,
+                std::span<std::uint64_t> mask) {
+  __m256i const key_vector = _mm256_set1_epi32(static_cast<int>(key));
+
+  // Full mask words first, 8 values per comparison
+  std::size_t const full_words = values.size() / mask_word_bits;
+  for (std::size_t word_id = 0; word_id < full_words; word_id++) {
+    std::uint32_t const *word_values = values.data() + word_id * mask_word_bits;
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < mask_word_bits; i += 8) {
+      __m256i const value_vector = _mm256_loadu_si256(
+          reinterpret_cast<__m256i const *>(word_values + i));
+      int const bits = _mm256_movemask_ps(
+          _mm256_castsi256_ps(_mm256_cmpeq_epi32(value_vector, key_vector)));
+      word |= std::uint64_t(static_cast<unsigned>(bits)) << i;
+    }
+    mask[word_id] = word;
+  }
+
+  mask_equal_scalar(values.subspan(full_words * mask_word_bits), key,
+                    mask.subspan(full_words));
+}
+
+__attribute__((target("avx2"))) void
+mask_in_bitmap_avx2(std::span<std::uint32_t const> values,
+                    std::span<std::uint32_t const> bitmap,
+                    std::span<std::uint64_t> mask) {
+  if (bitmap.empty()) {
+    mask_in_bitmap_scalar(values, bitmap, mask);
+    return;
+  }
+
+  // Bitmap words are gathered for the values that are within the bitmap
+  std::uint64_t const bitmap_bits = std::uint64_t{bitmap.size()} * 32;
+  __m256i const last_value = _mm256_set1_epi32(static_cast<int>(
+      std::min<std::uint64_t>(bitmap_bits - 1,
+                              std::numeric_limits<std::uint32_t>::max())));
+  __m256i const bit_index_mask = _mm256_set1_epi32(31);
+  __m256i const one = _mm256_set1_epi32(1);
+  int const *const bitmap_data = reinterpret_cast<int const *>(bitmap.data());
+
+  // Full mask words first, 8 values per gather
+  std::size_t const full_words = values.size() / mask_word_bits;
+  for (std::size_t word_id = 0; word_id < full_words; word_id++) {
+    std::uint32_t const *word_values = values.data() + word_id * mask_word_bits;
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < mask_word_bits; i += 8) {
+      __m256i const value_vector = _mm256_loadu_si256(
+          reinterpret_cast<__m256i const *>(word_values + i));
+      __m256i const in_bounds = _mm256_cmpeq_epi32(
+          _mm256_min_epu32(value_vector, last_value), value_vector);
+      __m256i const bitmap_words = _mm256_mask_i32gather_epi32(
+          _mm256_setzero_si256(), bitmap_data,
+          _mm256_srli_epi32(value_vector, 5), in_bounds, 4);
+      __m256i const value_bits = _mm256_and_si256(
+          _mm256_srlv_epi32(bitmap_words,
+                            _mm256_and_si256(value_vector, bit_index_mask)),
+          one);
+      int const bits = _mm256_movemask_ps(
+          _mm256_castsi256_ps(_mm256_cmpeq_epi32(value_bits, one)));
+      word |= std::uint64_t(static_cast<unsigned>(bits)) << i;
+    }
+    mask[word_id] = word;
+  }
+
+  mask_in_bitmap_scalar(values.subspan(full_words * mask_word_bits), bitmap,
+                        mask.subspan(full_words));
+}
+
+__attribute__((target("avx2"))) void
+mask_in_range_avx2(std::span<std::uint64_t const> values, std::uint64_t min,
+                   std::uint64_t max, std::span<std::uint64_t> mask) {
+  // AVX2 only has signed 64-bit comparisons, unsigned values are compared
+  // with their sign bit flipped
+  __m256i const sign =
+      _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+  __m256i const min_vector = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<long long>(min)), sign);
+  __m256i const max_vector = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<long long>(max)), sign);
+
+  // Full mask words first, 4 values per comparison
+  std::size_t const full_words = values.size() / mask_word_bits;
+  for (std::size_t word_id = 0; word_id < full_words; word_id++) {
+    std::uint64_t const *word_values = values.data() + word_id * mask_word_bits;
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < mask_word_bits; i += 4) {
+      __m256i const value_vector = _mm256_xor_si256(
+          _mm256_loadu_si256(
+              reinterpret_cast<__m256i const *>(word_values + i)),
+          sign);
+      __m256i const out_of_range =
+          _mm256_or_si256(_mm256_cmpgt_epi64(min_vector, value_vector),
+                          _mm256_cmpgt_epi64(value_vector, max_vector));
+      int const out_bits =
+          _mm256_movemask_pd(_mm256_castsi256_pd(out_of_range));
+      word |= std::uint64_t(~static_cast<unsigned>(out_bits) & 0xFu) << i;
+    }
+    mask[word_id] = word;
+  }
+
+  mask_in_range_scalar(values.subspan(full_words * mask_word_bits), min, max,
+                       mask.subspan(full_words));
+}
+
+__attribute__((target("avx2"))) void
+mask_any_bits_avx2(std::span<std::uint8_t const> values, std::uint8_t bits,
+                   std::span<std::uint64_t> mask) {
+  __m256i const bits_vector = _mm256_set1_epi8(static_cast<char>(bits));
+  __m256i const zero = _mm256_setzero_si256();
+
+  // Full mask words first, 32 values per comparison
+  std::size_t const full_words = values.size() / mask_word_bits;
+  for (std::size_t word_id = 0; word_id < full_words; word_id++) {
+    std::uint8_t const *word_values = values.data() + word_id * mask_word_bits;
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < mask_word_bits; i += 32) {
+      __m256i const value_vector = _mm256_loadu_si256(
+          reinterpret_cast<__m256i const *>(word_values + i));
+      int const clear_bits = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+          _mm256_and_si256(value_vector, bits_vector), zero));
+      word |= std::uint64_t(~static_cast<unsigned>(clear_bits)) << i;
+    }
+    mask[word_id] = word;
+  }
+
+  mask_any_bits_scalar(values.subspan(full_words * mask_word_bits), bits,
+                       mask.subspan(full_words));
+}
+
+#endif
+
+kernels_t select_kernels() {
+#ifdef GRAPHER_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {.instruction_set = "avx2",
+            .mask_equal = &mask_equal_avx2,
+            .mask_in_bitmap = &mask_in_bitmap_avx2,
+            .mask_in_range = &mask_in_range_avx2,
+            .mask_any_bits = &mask_any_bits_avx2};
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    // SSE2 has neither gathers nor 64-bit comparisons
+    return {.instruction_set = "sse2",
+            .mask_equal = &mask_equal_sse2,
+            .mask_in_bitmap = &mask_in_bitmap_scalar,
+            .mask_in_range = &mask_in_range_scalar,
+            .mask_any_bits = &mask_any_bits_sse2};
+  }
+#endif
+  return {.instruction_set = "scalar",
+          .mask_equal = &mask_equal_scalar,
+          .mask_in_bitmap = &mask_in_bitmap_scalar,
+          .mask_in_range = &mask_in_range_scalar,
+          .mask_any_bits = &mask_any_bits_scalar};
+}
+
+kernels_t const &get_kernels() {
+  static kernels_t const kernels = select_kernels();
+  return kernels;
+}
+
+} // namespace
+
+void mask_equal_scalar(std::span<std::uint32_t const> values,
+                       std::uint32_t key, std::span<std::uint64_t> mask) {
+  mask_if(values, mask, [&](std::uint32_t value) { return value == key; });
+}
+
+void mask_in_bitmap_scalar(std::span<std::uint32_t const> values,
+                           std::span<std::uint32_t const> bitmap,
+                           std::span<std::uint64_t> mask) {
+  mask_if(values, mask, [&](std::uint32_t value) {
+    return value / 32 < bitmap.size() &&
+           (bitmap[value / 32] >> (value % 32) & 1) != 0;
+  });
+}
+
+void mask_in_range_scalar(std::span<std::uint64_t const> values,
+                          std::uint64_t min, std::uint64_t max,
+                          std::span<std::uint64_t> mask) {
+  mask_if(values, mask,
+          [&](std::uint64_t value) { return min <= value && value <= max; });
+}
+
+void mask_any_bits_scalar(std::span<std::uint8_t const> values,
+                          std::uint8_t bits, std::span<std::uint64_t> mask) {
+  mask_if(values, mask,
+          [&](std::uint8_t value) { return (value & bits) != 0; });
+}
+
+void mask_equal(std::span<std::uint32_t const> values, std::uint32_t key,
+                std::span<std::uint64_t> mask) {
+  get_kernels().mask_equal(values, key, mask);
+}
+
+void mask_in_bitmap(std::span<std::uint32_t const> values,
+                    std::span<std::uint32_t const> bitmap,
+                    std::span<std::uint64_t> mask) {
+  get_kernels().mask_in_bitmap(values, bitmap, mask);
+}
+
+void mask_in_range(std::span<std::uint64_t const> values, std::uint64_t min,
+                   std::uint64_t max, std::span<std::uint64_t> mask) {
+  get_kernels().mask_in_range(values, min, max, mask);
+}
+
+void mask_any_bits(std::span<std::uint8_t const> values, std::uint8_t bits,
+                   std::span<std::uint64_t> mask) {
+  get_kernels().mask_any_bits(values, bits, mask);
+}
+
+std::string_view get_instruction_set() {
+  return get_kernels().instruction_set;
+}
+
+} // namespace grapher::simd
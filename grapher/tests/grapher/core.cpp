@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <grapher/core.hpp>
+#include <grapher/utils/intern.hpp>
+
+TEST_CASE("event table roundtrip", "[core]") {
+  grapher::json_t const source_event = grapher::json_t::parse(R"({
+    "name": "Source", "ph": "X", "ts": 4, "dur": 10, "pid": 1, "tid": 2,
+    "args": {"detail": "foo.hpp", "list": [1, -2, 0.5], "flag": true,
+             "nothing": null, "a/b": "escaped"}
+  })");
+
+  grapher::event_table_t events;
+  events.push_event(source_event);
+  events.push_event(grapher::json_t::object());
+
+  REQUIRE(events.size() == 2);
+  REQUIRE(events.get_event(0) == source_event);
+  REQUIRE(events.get_event(1) == grapher::json_t::object());
+
+  events.pop_row();
+  REQUIRE(events.size() == 1);
+  REQUIRE(events.get_event(0) == source_event);
+}
+
+TEST_CASE("event table fields", "[core]") {
+  grapher::event_table_t events;
+  events.push_event(grapher::json_t::parse(
+      R"({"name": "Source", "dur": 10, "args": {"detail": "foo.hpp"}})"));
+  events.push_event(grapher::json_t::parse(R"({"name": 42, "dur": -1})"));
+
+  grapher::event_field_t const name_field =
+      grapher::event_field_t::resolve("/name");
+  grapher::event_field_t const detail_field =
+      grapher::event_field_t::resolve("/args/detail");
+  grapher::event_field_t const dur_field =
+      grapher::event_field_t::resolve("/dur");
+
+  REQUIRE(name_field.column == grapher::name_column_v);
+  REQUIRE(detail_field.column == grapher::detail_column_v);
+  REQUIRE(grapher::event_field_t::resolve("/args").column ==
+          grapher::args_column_v);
+
+  // Fields stored in columns
+  REQUIRE(events.names()[0] == grapher::intern("Source"));
+  REQUIRE(events.details()[0] == grapher::intern("foo.hpp"));
+  REQUIRE(events.column(grapher::dur_column_v)[0] == 10);
+  REQUIRE(events.get(0, dur_field).get_value() == 10);
+
+  // Fields that don't fit their column are stored in the args table
+  REQUIRE(events.names()[1] == grapher::no_symbol_v);
+  REQUIRE(events.get_args(1).size() == 2);
+  REQUIRE(events.get(1, name_field).to_json() == 42);
+  REQUIRE(events.get(1, dur_field).kind == grapher::integer_kind_v);
+
+  // Absent fields
+  REQUIRE_FALSE(events.get(1, detail_field).is_present());
+  REQUIRE_FALSE(
+      events.get(0, grapher::event_field_t::resolve("/args")).is_present());
+}
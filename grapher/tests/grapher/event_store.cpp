@@ -0,0 +1,31 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#include <grapher/event_store.hpp>
+
+#include "fixtures.hpp"
+
+TEST_CASE("event store parses repetitions once", "[event_store]") {
+  namespace fs = std::filesystem;
+
+  fs::path const repetition_path = get_temp_path("event-store.json");
+
+  std::ofstream(repetition_path)
+      << R"({"traceEvents": [{"name": "Source", "dur": 10}]})";
+
+  grapher::event_store_t const store({repetition_path});
+  REQUIRE(store.size() == 1);
+
+  grapher::event_table_t const &events = store.get(0);
+  REQUIRE(events.size() == 1);
+  REQUIRE(events.get_event(0)["name"] == "Source");
+
+  // Later reads must not touch the file again
+  std::ofstream(repetition_path) << R"({"traceEvents": []})";
+  REQUIRE(&store.get(0) == &events);
+  REQUIRE(store.get(0).size() == 1);
+
+  fs::remove(repetition_path);
+}
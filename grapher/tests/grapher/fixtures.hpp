@@ -0,0 +1,43 @@
+#pragma once
+
+/// \file
+/// Test fixtures shared by the test files: unique temporary paths and a small
+/// time-trace file.
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include <unistd.h>
+
+#include <fmt/core.h>
+
+/// Returns a path in the temporary directory ending with name, unique to the
+/// process and the call so concurrent test runs never share files.
+inline std::filesystem::path get_temp_path(std::string_view name) {
+  static std::atomic<unsigned> counter = 0;
+  return std::filesystem::temp_directory_path() /
+         fmt::format("grapher-test-{}-{}-{}", ::getpid(), counter++, name);
+}
+
+/// Writes a small time-trace file to a unique temporary path and returns it.
+/// Its first event has fields of every kind, and a decoy traceEvents array
+/// precedes the real one.
+inline std::filesystem::path write_test_trace() {
+  std::filesystem::path const path = get_temp_path("trace.json");
+
+  std::ofstream(path) << R"({
+    "beginningOfTime": 1,
+    "otherData": {"traceEvents": [{"name": "Decoy"}]},
+    "traceEvents": [
+      {"name": "Source", "dur": 10, "ts": 0, "ph": "X",
+       "args": {"detail": "foo.hpp", "list": [1, -2, 0.5], "flag": true}},
+      {"name": "InstantiateFunction", "dur": 20, "ts": 5,
+       "args": {"detail": "bar"}},
+      {"name": "Source", "dur": 30, "ts": 8}
+    ]
+  })";
+
+  return path;
+}
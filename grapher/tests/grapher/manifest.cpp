@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#include <grapher/manifest.hpp>
+
+#include "fixtures.hpp"
+
+TEST_CASE("results manifest roundtrip", "[manifest]") {
+  namespace fs = std::filesystem;
+
+  fs::path const output_path = get_temp_path("manifest");
+  fs::path const repetition_path = get_temp_path("manifest.json");
+  fs::path const manifest_path = grapher::get_manifest_path(output_path);
+  fs::create_directories(output_path);
+
+  std::ofstream(repetition_path) << R"({"traceEvents": []})";
+
+  grapher::json_t const config = {{"plotter", "compare_by"}};
+  grapher::json_t const aggregate = {{{"Source"}, {10, 20}}};
+
+  grapher::results_manifest_t manifest =
+      grapher::results_manifest_t::load(manifest_path, config);
+  REQUIRE(manifest.empty());
+
+  manifest.set(repetition_path,
+               {.stamp = *grapher::get_file_stamp(repetition_path),
+                .hash = *grapher::hash_file(repetition_path),
+                .aggregate = aggregate});
+  manifest.set_outputs({{"Source", "Source"}});
+  REQUIRE(manifest.save(manifest_path));
+
+  // Loading with the same config
+  grapher::results_manifest_t const loaded_manifest =
+      grapher::results_manifest_t::load(manifest_path, config);
+  REQUIRE(loaded_manifest.size() == 1);
+  REQUIRE(loaded_manifest.get_outputs() ==
+          grapher::json_t{{"Source", "Source"}});
+
+  grapher::manifest_entry_t const *entry =
+      loaded_manifest.find(repetition_path);
+  REQUIRE(entry != nullptr);
+  REQUIRE(entry->aggregate == aggregate);
+  REQUIRE(entry->matches(repetition_path,
+                         *grapher::get_file_stamp(repetition_path)));
+
+  // Changing the repetition file
+  std::ofstream(repetition_path) << R"({"traceEvents": [{}]})";
+  REQUIRE_FALSE(entry->matches(repetition_path,
+                               *grapher::get_file_stamp(repetition_path)));
+
+  // Loading with another config
+  REQUIRE(grapher::results_manifest_t::load(manifest_path,
+                                            {{"plotter", "stack"}})
+              .empty());
+
+  fs::remove_all(output_path);
+  fs::remove(repetition_path);
+}
+
+TEST_CASE("results manifest pruning", "[manifest]") {
+  grapher::results_manifest_t manifest;
+  manifest.set("a.json", {.stamp = {.size = 1, .mtime = 2},
+                          .hash = 3,
+                          .aggregate = grapher::json_t::array()});
+  manifest.set("b.json", {.stamp = {.size = 4, .mtime = 5},
+                          .hash = 6,
+                          .aggregate = grapher::json_t::array()});
+
+  std::vector<grapher::manifest_entry_t> const removed =
+      manifest.prune({"a.json"});
+
+  REQUIRE(removed.size() == 1);
+  REQUIRE(removed[0].hash == 6);
+  REQUIRE(manifest.size() == 1);
+  REQUIRE(manifest.find("a.json") != nullptr);
+  REQUIRE(manifest.find("b.json") == nullptr);
+}
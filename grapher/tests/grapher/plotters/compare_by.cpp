@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grapher/event_store.hpp>
+#include <grapher/manifest.hpp>
+#include <grapher/plotters/compare_by.hpp>
+#include <grapher/plotters/curve_aggregate.hpp>
+#include <grapher/utils/intern.hpp>
+
+#include "../fixtures.hpp"
+
+TEST_CASE("compare_by incremental plots", "[compare_by]") {
+  namespace fs = std::filesystem;
+
+  fs::path const root = get_temp_path("compare-by");
+  fs::path const input = root / "input";
+  fs::path const dest = root / "output";
+  fs::create_directories(input);
+
+  // Each key comes from a single repetition
+  fs::path const source_path = input / "1.json";
+  fs::path const frontend_path = input / "2.json";
+  std::ofstream(source_path)
+      << R"({"traceEvents": [{"name": "Source", "dur": 10}]})";
+  std::ofstream(frontend_path)
+      << R"({"traceEvents": [{"name": "Frontend", "dur": 20}]})";
+
+  // Events are parsed again on every run, like in separate processes
+  auto get_benchmark_set = [&]() -> grapher::benchmark_set_t {
+    std::vector<fs::path> const repetitions = {source_path, frontend_path};
+    auto const events =
+        std::make_shared<grapher::event_store_t const>(repetitions);
+    return {{.name = "bench",
+             .instances = {{.size = 1,
+                            .repetitions = repetitions,
+                            .events = events}}}};
+  };
+
+  grapher::plotters::plotter_compare_by_t const plotter;
+  grapher::json_t config = plotter.get_default_config();
+  config["key_ptrs"] = grapher::json_t::array({"/name"});
+  config["filters"] = grapher::json_t::array();
+  config["plot_backend"] = "native";
+  config["plot_file_extensions"] = grapher::json_t::array({".svg"});
+
+  grapher::results_manifest_t manifest;
+  plotter.plot_incremental(get_benchmark_set(), dest, config, manifest);
+  REQUIRE(fs::exists(dest / "Source.svg"));
+  REQUIRE(fs::exists(dest / "Frontend.svg"));
+  REQUIRE(manifest.get_outputs() ==
+          grapher::json_t{{"Source", "Source"}, {"Frontend", "Frontend"}});
+
+  // Plots are aged so redrawn ones can be told apart
+  fs::file_time_type const old_time =
+      fs::last_write_time(dest / "Source.svg") - std::chrono::hours(1);
+  fs::last_write_time(dest / "Source.svg", old_time);
+
+  // Only the keys of the changed repetition are affected
+  std::ofstream(frontend_path)
+      << R"({"traceEvents": [{"name": "Backend", "dur": 30}]})";
+  plotter.plot_incremental(get_benchmark_set(), dest, config, manifest);
+
+  REQUIRE(fs::last_write_time(dest / "Source.svg") == old_time);
+  REQUIRE(fs::exists(dest / "Backend.svg"));
+  REQUIRE_FALSE(fs::exists(dest / "Frontend.svg"));
+  REQUIRE(manifest.get_outputs() ==
+          grapher::json_t{{"Source", "Source"}, {"Backend", "Backend"}});
+
+  // Without changes, nothing is redrawn
+  fs::file_time_type const backend_time =
+      fs::last_write_time(dest / "Backend.svg") - std::chrono::hours(1);
+  fs::last_write_time(dest / "Backend.svg", backend_time);
+  plotter.plot_incremental(get_benchmark_set(), dest, config, manifest);
+  REQUIRE(fs::last_write_time(dest / "Source.svg") == old_time);
+  REQUIRE(fs::last_write_time(dest / "Backend.svg") == backend_time);
+
+  fs::remove_all(root);
+}
+
+namespace {
+
+/// Writes a repetition with one event per heavy name and duration, followed by
+/// light_count events of distinct keys named after their index, and returns a
+/// benchmark set holding it.
+grapher::benchmark_set_t
+write_repetition(std::filesystem::path const &path,
+                 std::initializer_list<std::pair<std::string, unsigned>> heavy,
+                 std::size_t light_count = 0, unsigned light_dur = 0) {
+  grapher::json_t trace_events = grapher::json_t::array();
+  for (auto const &[name, dur] : heavy) {
+    trace_events.push_back({{"name", name}, {"dur", dur}});
+  }
+  for (std::size_t i = 0; i < light_count; i++) {
+    trace_events.push_back(
+        {{"name", fmt::format("Light{:05}", i)}, {"dur", light_dur}});
+  }
+  std::ofstream(path) << grapher::json_t{{"traceEvents", trace_events}};
+
+  std::vector<std::filesystem::path> const repetitions = {path};
+  auto const events =
+      std::make_shared<grapher::event_store_t const>(repetitions);
+  return {{.name = "bench",
+           .instances = {{.size = 1,
+                          .repetitions = repetitions,
+                          .events = events}}}};
+}
+
+} // namespace
+
+TEST_CASE("compare_by key pruning", "[compare_by]") {
+  namespace fs = std::filesystem;
+
+  fs::path const path = get_temp_path("key-pruning.json");
+  std::vector<grapher::json_t::json_pointer> const key_pointers = {
+      grapher::json_t::json_pointer{"/name"}};
+  grapher::json_t::json_pointer const value_pointer{"/dur"};
+
+  auto get_kept_keys = [&](grapher::benchmark_set_t const &bset,
+                           grapher::plotters::key_pruning_parameters_t const
+                               &pruning) {
+    std::vector<std::string> res;
+    for (auto const &[key, curve_aggregate] :
+         grapher::plotters::get_bench_curves(bset, key_pointers, value_pointer,
+                                             {}, false, nullptr, nullptr,
+                                             pruning)) {
+      res.push_back(grapher::plotters::to_string(key));
+    }
+    std::ranges::sort(res);
+    return res;
+  };
+
+  SECTION("min_total_dur is exact") {
+    // A heavy key pushed before more light keys than a sketch would monitor,
+    // each of them evicting the lightest monitored key
+    grapher::benchmark_set_t const bset =
+        write_repetition(path, {{"Heavy", 1500}}, 8192, 900);
+    REQUIRE(get_kept_keys(bset, {.min_total = 1000}) ==
+            std::vector<std::string>{"Heavy"});
+  }
+
+  SECTION("top_k keeps the heaviest keys") {
+    grapher::benchmark_set_t const bset = write_repetition(
+        path, {{"A", 100}, {"B", 50}, {"C", 10}, {"D", 10}, {"A", 20}});
+    REQUIRE(get_kept_keys(bset, {.top_k = 2}) ==
+            std::vector<std::string>{"A", "B"});
+    REQUIRE(get_kept_keys(bset, {.top_k = 3, .min_total = 20}) ==
+            std::vector<std::string>{"A", "B"});
+
+    // Ties are broken by key strings
+    REQUIRE(get_kept_keys(bset, {.top_k = 3}) ==
+            std::vector<std::string>{"A", "B", "C"});
+  }
+
+  SECTION("top_k aggregates monitored keys in a single pass") {
+    // Light keys evict each other, the heavy one weighs more than the sketch
+    // error bound so it stays monitored and keeps all its values
+    grapher::benchmark_set_t const bset =
+        write_repetition(path, {{"Heavy", 15000}, {"Heavy", 5000}}, 200, 900);
+    grapher::plotters::curve_aggregate_map_t const curves =
+        grapher::plotters::get_bench_curves(bset, key_pointers, value_pointer,
+                                            {}, false, nullptr, nullptr,
+                                            {.top_k = 1});
+    REQUIRE(curves.size() == 1);
+    grapher::plotters::point_aggregate_t const &point =
+        curves.begin()->second.at("bench").at(1);
+    REQUIRE(grapher::plotters::to_string(curves.begin()->first) == "Heavy");
+    REQUIRE(point.sum() == 20000);
+  }
+
+  fs::remove(path);
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grapher/event_store.hpp>
+#include <grapher/plotters/export.hpp>
+#include <grapher/utils/columnar.hpp>
+
+#include "../fixtures.hpp"
+
+namespace {
+
+std::string read_file(std::filesystem::path const &path) {
+  std::ifstream file(path);
+  return {std::istreambuf_iterator<char>(file), {}};
+}
+
+} // namespace
+
+TEST_CASE("export plotter", "[export]") {
+  namespace fs = std::filesystem;
+
+  fs::path const root = get_temp_path("export");
+  fs::path const dest = root / "output";
+  fs::create_directories(root);
+
+  // Source events of a.hpp appear twice in the first repetition
+  std::vector<fs::path> const repetitions = {root / "1.json",
+                                             root / "2.json"};
+  std::ofstream(repetitions[0]) << R"({"traceEvents": [
+    {"name": "Source", "dur": 10, "args": {"detail": "a.hpp"}},
+    {"name": "Frontend", "dur": 4},
+    {"name": "Source", "dur": 7, "args": {"detail": "b.hpp"}},
+    {"name": "InstantiateClass", "dur": 3},
+    {"name": "Source", "dur": 5, "args": {"detail": "a.hpp"}}
+  ]})";
+  std::ofstream(repetitions[1]) << R"({"traceEvents": [
+    {"name": "Source", "dur": 1, "args": {"detail": "a.hpp"}}
+  ]})";
+
+  auto const events =
+      std::make_shared<grapher::event_store_t const>(repetitions);
+  grapher::benchmark_set_t const bset = {
+      {.name = "bench",
+       .instances = {
+           {.size = 1, .repetitions = repetitions, .events = events}}}};
+
+  grapher::plotters::plotter_export_t const plotter;
+
+  SECTION("key sums") {
+    // The default filter matches every event
+    plotter.plot(bset, dest, plotter.get_default_config());
+
+    REQUIRE(read_file(dest / "values.csv") ==
+            "benchmark,size,repetition,/name,/args/detail,value\n"
+            "bench,1,0,Frontend,,4\n"
+            "bench,1,0,InstantiateClass,,3\n"
+            "bench,1,0,Source,a.hpp,15\n"
+            "bench,1,0,Source,b.hpp,7\n"
+            "bench,1,1,Source,a.hpp,1\n");
+
+    grapher::columnar_reader_t const reader(dest / "values.ctcol");
+    REQUIRE(reader.is_open());
+    REQUIRE(reader.get_row_count() == 5);
+  }
+
+  SECTION("group descriptor sums") {
+    grapher::json_t config = plotter.get_default_config();
+    config["file_extensions"] = grapher::json_t::array({".csv"});
+    config["group_descriptors"] = grapher::json_t::array(
+        {{{"name", "Sources"},
+          {"predicates", grapher::json_t::array({{{"type", "streq"},
+                                                  {"pointer", "/name"},
+                                                  {"string", "Source"}}})}}});
+    plotter.plot(bset, dest, config);
+
+    REQUIRE(read_file(dest / "values.csv") ==
+            "benchmark,size,repetition,group,value\n"
+            "bench,1,0,Sources,22\n"
+            "bench,1,1,Sources,1\n");
+    REQUIRE_FALSE(fs::exists(dest / "values.ctcol"));
+  }
+
+  fs::remove_all(root);
+}
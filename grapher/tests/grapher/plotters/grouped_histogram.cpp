@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <grapher/event_store.hpp>
+#include <grapher/plotters/grouped_histogram.hpp>
+
+#include "../fixtures.hpp"
+
+namespace {
+
+bool is_near(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+} // namespace
+
+TEST_CASE("grouped histogram", "[plotters]") {
+  namespace fs = std::filesystem;
+
+  // Source events of headers are matched by both descriptors
+  std::vector<grapher::group_descriptor_t> const descriptors = {
+      {.name = "Sources",
+       .predicates = {{{"type", "streq"},
+                       {"pointer", "/name"},
+                       {"string", "Source"}}}},
+      {.name = "Headers",
+       .predicates = {{{"type", "regex"},
+                       {"pointer", "/args/detail"},
+                       {"regex", ".*\\.hpp"}}}},
+  };
+  grapher::descriptor_dispatcher_t const dispatcher(descriptors);
+
+  // Unevenly spaced sizes, with 2 repetitions each
+  std::vector<unsigned> const sizes = {1, 3, 4};
+  std::vector<fs::path> paths;
+  grapher::benchmark_case_t bench{.name = "bench", .instances = {}};
+  for (unsigned const size : sizes) {
+    std::vector<fs::path> repetitions;
+    for (unsigned repetition = 0; repetition < 2; repetition++) {
+      fs::path const path = get_temp_path(
+          fmt::format("grouped-histogram-{}-{}.json", size, repetition));
+      std::ofstream(path) << fmt::format(R"({{"traceEvents": [
+        {{"name": "Source", "dur": {}, "args": {{"detail": "a.hpp"}}}},
+        {{"name": "Source", "dur": 1, "args": {{"detail": "a.cpp"}}}},
+        {{"name": "InstantiateClass", "dur": 100,
+          "args": {{"detail": "b.hpp"}}}}
+      ]}})",
+                                         size * 10 + repetition * 2);
+      repetitions.push_back(path);
+      paths.push_back(path);
+    }
+    auto const events =
+        std::make_shared<grapher::event_store_t const>(repetitions);
+    bench.instances.push_back(
+        {.size = size, .repetitions = repetitions, .events = events});
+  }
+
+  grapher::plot_t const plot = grapher::plotters::get_grouped_histogram(
+      bench, descriptors, dispatcher, grapher::json_t::json_pointer{"/dur"});
+
+  // A filled series per descriptor, with 4 points per bar
+  REQUIRE(plot.series.size() == descriptors.size());
+  for (std::size_t descriptor_id = 0; descriptor_id < descriptors.size();
+       descriptor_id++) {
+    grapher::plot_series_t const &series = plot.series[descriptor_id];
+    REQUIRE(series.kind == grapher::filled_series_v);
+    REQUIRE(series.label == descriptors[descriptor_id].name);
+    REQUIRE(series.x.size() == sizes.size() * 4);
+    REQUIRE(series.y.size() == series.x.size());
+    REQUIRE(series.y_low == std::vector<double>(series.x.size(), 0.));
+
+    for (std::size_t i = 0; i < sizes.size(); i++) {
+      double const size = sizes[i];
+
+      // Bars of a size span 80% of the smallest spacing between sizes, which
+      // is 1, and are centered on the size
+      double const left = size - 0.4 + double(descriptor_id) * 0.4;
+      REQUIRE(is_near(series.x[i * 4], left));
+      REQUIRE(is_near(series.x[i * 4 + 1], left));
+      REQUIRE(is_near(series.x[i * 4 + 2], left + 0.4));
+      REQUIRE(is_near(series.x[i * 4 + 3], left + 0.4));
+
+      // Heights are averaged over repetitions, and the Source event of a.hpp
+      // counts in both groups
+      double const height = descriptor_id == 0 ? size * 10 + 1 + 1
+                                               : size * 10 + 1 + 100;
+      REQUIRE(series.y[i * 4] == 0.);
+      REQUIRE(is_near(series.y[i * 4 + 1], height));
+      REQUIRE(is_near(series.y[i * 4 + 2], height));
+      REQUIRE(series.y[i * 4 + 3] == 0.);
+    }
+  }
+
+  // A single size is spaced by 1
+  grapher::benchmark_case_t const single{.name = "single",
+                                         .instances = {bench.instances[1]}};
+  grapher::plot_t const single_plot = grapher::plotters::get_grouped_histogram(
+      single, descriptors, dispatcher, grapher::json_t::json_pointer{"/dur"});
+  REQUIRE(is_near(single_plot.series[1].x[0], 3.));
+  REQUIRE(is_near(single_plot.series[1].x[2], 3.4));
+
+  for (fs::path const &path : paths) {
+    fs::remove(path);
+  }
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <grapher/event_store.hpp>
+#include <grapher/plotters/curve_aggregate.hpp>
+#include <grapher/plotters/html.hpp>
+
+#include "../fixtures.hpp"
+
+namespace {
+
+/// Returns a curve whose average at each size is factor * size ^ exponent.
+grapher::plotters::benchmark_curve_t
+get_power_curve(std::vector<std::size_t> const &sizes, double factor,
+                double exponent) {
+  grapher::plotters::benchmark_curve_t res;
+  for (std::size_t const size : sizes) {
+    res[size].push(grapher::value_t(
+        std::llround(factor * std::pow(double(size), exponent))));
+  }
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("html report helpers", "[html]") {
+  using grapher::plotters::to_base64;
+
+  SECTION("base64") {
+    // RFC 4648 test vectors
+    REQUIRE(to_base64("").empty());
+    REQUIRE(to_base64("f") == "Zg==");
+    REQUIRE(to_base64("fo") == "Zm8=");
+    REQUIRE(to_base64("foo") == "Zm9v");
+    REQUIRE(to_base64("foob") == "Zm9vYg==");
+    REQUIRE(to_base64("fooba") == "Zm9vYmE=");
+    REQUIRE(to_base64("foobar") == "Zm9vYmFy");
+    REQUIRE(to_base64(std::string("\xFF\xFE\0", 3)) == "//4A");
+  }
+
+  SECTION("growth rate") {
+    using grapher::plotters::get_growth_rate;
+    std::vector<std::size_t> const sizes = {1, 2, 4, 8, 16};
+
+    // The largest exponent among benchmarks is returned
+    grapher::plotters::curve_aggregate_t curve_aggregate;
+    curve_aggregate["linear"] = get_power_curve(sizes, 1000., 1.);
+    curve_aggregate["quadratic"] = get_power_curve(sizes, 10., 2.);
+    std::optional<double> const growth_rate = get_growth_rate(curve_aggregate);
+    REQUIRE(growth_rate.has_value());
+    REQUIRE(std::abs(*growth_rate - 2.) < 1e-3);
+
+    // A single size has no growth rate
+    grapher::plotters::curve_aggregate_t single;
+    single["single"] = get_power_curve({4}, 10., 1.);
+    REQUIRE_FALSE(get_growth_rate(single).has_value());
+  }
+
+  SECTION("script data escaping") {
+    using grapher::plotters::escape_script_data;
+    REQUIRE(escape_script_data("[\"a</script>b\"]") ==
+            "[\"a<\\/script>b\"]");
+    REQUIRE(escape_script_data("</</") == "<\\/<\\/");
+    REQUIRE(escape_script_data("a<b/c") == "a<b/c");
+  }
+}
+
+TEST_CASE("html report", "[html]") {
+  namespace fs = std::filesystem;
+
+  fs::path const root = get_temp_path("html");
+  fs::path const dest = root / "output";
+  fs::create_directories(dest / "data");
+
+  // A larger previous report left more chunks
+  std::ofstream(dest / "data" / "chunk_7.js") << "ctbench_chunk(7, \"\");\n";
+  std::ofstream(dest / "data" / "notes.txt") << "Not a chunk\n";
+
+  std::vector<fs::path> const repetitions = {root / "1.json"};
+  std::ofstream(repetitions[0]) << R"({"traceEvents": [
+    {"name": "</script><b>", "dur": 10},
+    {"name": "Source", "dur": 20}
+  ]})";
+  auto const events =
+      std::make_shared<grapher::event_store_t const>(repetitions);
+  grapher::benchmark_set_t const bset = {
+      {.name = "bench",
+       .instances = {
+           {.size = 1, .repetitions = repetitions, .events = events}}}};
+
+  grapher::plotters::plotter_html_t const plotter;
+  grapher::json_t config = plotter.get_default_config();
+  config["key_ptrs"] = grapher::json_t::array({"/name"});
+  config["filters"] = grapher::json_t::array();
+  config["keys_per_chunk"] = 1;
+  plotter.plot(bset, dest, config);
+
+  REQUIRE(fs::exists(dest / "data" / "chunk_0.js"));
+  REQUIRE(fs::exists(dest / "data" / "chunk_1.js"));
+  REQUIRE_FALSE(fs::exists(dest / "data" / "chunk_7.js"));
+  REQUIRE(fs::exists(dest / "data" / "notes.txt"));
+
+  // Key names can't close the script element holding the report data
+  std::ifstream index_file(dest / "index.html");
+  std::string const index{std::istreambuf_iterator<char>(index_file), {}};
+  REQUIRE(index.find("<\\/script><b>") != std::string::npos);
+  REQUIRE(index.find("</script><b>") == std::string::npos);
+
+  fs::remove_all(root);
+}
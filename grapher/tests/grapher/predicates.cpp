@@ -1,6 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
 #include <grapher/predicates.hpp>
+#include <grapher/utils/simd.hpp>
 
 TEST_CASE("regex", "[predicates]") {
   grapher::json_t constraint;
@@ -177,3 +185,280 @@ TEST_CASE("val_false", "[predicates]") {
   grapher::predicate_t pred = grapher::get_predicate(constraint);
   REQUIRE(pred({}) == false);
 }
+
+TEST_CASE("in_set", "[predicates]") {
+  grapher::predicate_t const pred = grapher::get_predicate(
+      {{"type", "in_set"},
+       {"pointer", "/name"},
+       {"values", {"Source", "ParseClass", 42}}});
+
+  REQUIRE(pred({{"name", "Source"}}) == true);
+  REQUIRE(pred({{"name", "ParseClass"}}) == true);
+  REQUIRE(pred({{"name", 42}}) == true);
+  REQUIRE(pred({{"name", "Frontend"}}) == false);
+  REQUIRE(pred({{"name", 43}}) == false);
+  REQUIRE(pred({{"name", "42"}}) == false);
+  REQUIRE(pred({}) == false);
+
+  grapher::predicate_t const ids = grapher::get_predicate(
+      {{"type", "in_set"}, {"pointer", "/tid"}, {"values", {1, 3}}});
+  REQUIRE(ids({{"tid", 3}}) == true);
+  REQUIRE(ids({{"tid", 2}}) == false);
+}
+
+TEST_CASE("range", "[predicates]") {
+  grapher::predicate_t const pred = grapher::get_predicate(
+      {{"type", "range"}, {"pointer", "/dur"}, {"min", 10}, {"max", 20}});
+
+  REQUIRE(pred({{"dur", 10}}) == true);
+  REQUIRE(pred({{"dur", 20}}) == true);
+  REQUIRE(pred({{"dur", 15.5}}) == true);
+  REQUIRE(pred({{"dur", 9}}) == false);
+  REQUIRE(pred({{"dur", 21}}) == false);
+  REQUIRE(pred({{"dur", "15"}}) == false);
+  REQUIRE(pred({}) == false);
+
+  // Missing bounds are unbounded
+  grapher::predicate_t const min_only = grapher::get_predicate(
+      {{"type", "range"}, {"pointer", "/args/count"}, {"min", -5}});
+  REQUIRE(min_only({{"args", {{"count", -5}}}}) == true);
+  REQUIRE(min_only({{"args", {{"count", 1000000}}}}) == true);
+  REQUIRE(min_only({{"args", {{"count", -6}}}}) == false);
+}
+
+TEST_CASE("predicate compilation", "[predicates]") {
+  grapher::json_t const streq_name = {
+      {"type", "streq"}, {"pointer", "/name"}, {"string", "Source"}};
+  grapher::json_t const regex_detail = {
+      {"type", "regex"}, {"pointer", "/args/detail"}, {"regex", ".*\\.hpp"}};
+
+  SECTION("constant folding") {
+    grapher::predicate_t const pred = grapher::get_predicate(
+        {{"type", "op_or"},
+         {"first", streq_name},
+         {"second",
+          {{"type", "op_and"},
+           {"first", regex_detail},
+           {"second", {{"type", "val_false"}}}}}});
+
+    // The conjunction is folded into false, then dropped from the disjunction
+    auto const instructions = pred.get_instructions();
+    REQUIRE(instructions.size() == 1);
+    REQUIRE(instructions[0].opcode == grapher::streq_op_v);
+
+    REQUIRE(pred({{"name", "Source"}}) == true);
+    REQUIRE(pred({{"name", "Frontend"}}) == false);
+  }
+
+  SECTION("conjunction flattening and ordering") {
+    grapher::predicate_t const pred = grapher::get_predicate(
+        {{"type", "op_and"},
+         {"first", regex_detail},
+         {"second",
+          {{"type", "op_and"},
+           {"first", {{"type", "val_true"}}},
+           {"second", streq_name}}}});
+
+    // Cheaper string comparisons are evaluated first
+    auto const instructions = pred.get_instructions();
+    REQUIRE(instructions.size() == 3);
+    REQUIRE(instructions[0].opcode == grapher::all_op_v);
+    REQUIRE(instructions[0].size == 3);
+    REQUIRE(instructions[1].opcode == grapher::streq_op_v);
+    REQUIRE(instructions[2].opcode == grapher::regex_op_v);
+
+    REQUIRE(pred({{"name", "Source"}, {"args", {{"detail", "a.hpp"}}}}) ==
+            true);
+    REQUIRE(pred({{"name", "Source"}, {"args", {{"detail", "a.cpp"}}}}) ==
+            false);
+    REQUIRE(pred({{"name", "Frontend"}, {"args", {{"detail", "a.hpp"}}}}) ==
+            false);
+  }
+
+  SECTION("streq chains") {
+    // Long disjunctions of streq on the same field become a set lookup
+    std::vector<std::string> const names = {"A", "B", "C", "D", "E"};
+    grapher::json_t constraint = {{"type", "regex"},
+                                  {"pointer", "/args/detail"},
+                                  {"regex", ".*\\.hpp"}};
+    for (std::string const &name : names) {
+      grapher::json_t const streq = {
+          {"type", "streq"}, {"pointer", "/name"}, {"string", name}};
+      constraint = {
+          {"type", "op_or"}, {"first", streq}, {"second", constraint}};
+    }
+    grapher::predicate_t const pred = grapher::get_predicate(constraint);
+
+    auto const instructions = pred.get_instructions();
+    REQUIRE(instructions.size() == 3);
+    REQUIRE(instructions[0].opcode == grapher::any_op_v);
+    REQUIRE(instructions[1].opcode == grapher::in_set_op_v);
+    REQUIRE(instructions[2].opcode == grapher::regex_op_v);
+    REQUIRE(pred.get_sets()[0].symbols.size() == names.size());
+
+    for (std::string const &name : names) {
+      REQUIRE(pred({{"name", name}}) == true);
+    }
+    REQUIRE(pred({{"name", "F"}}) == false);
+    REQUIRE(pred({{"name", "F"}, {"args", {{"detail", "a.hpp"}}}}) == true);
+
+    // Short chains are kept as is
+    grapher::predicate_t const short_chain = grapher::get_predicate(
+        {{"type", "op_or"},
+         {"first", {{"type", "streq"}, {"pointer", "/name"}, {"string", "A"}}},
+         {"second",
+          {{"type", "streq"}, {"pointer", "/name"}, {"string", "B"}}}});
+    REQUIRE(short_chain.get_instructions().size() == 3);
+  }
+
+  SECTION("default predicate") {
+    REQUIRE(grapher::predicate_t{}({{"name", "Source"}}) == true);
+  }
+}
+
+TEST_CASE("memoization", "[predicates]") {
+  std::vector<grapher::json_t> const constraints = {
+      {{"type", "regex"}, {"pointer", "/name"}, {"regex", "Inst.*"}},
+      {{"type", "match"},
+       {"regex", true},
+       {"matcher", {{"name", "Source"}, {"args", {{"detail", ".*\\.hpp"}}}}}},
+      {{"type", "op_and"},
+       {"first", {{"type", "range"}, {"pointer", "/dur"}, {"max", 3}}},
+       {"second", {{"type", "regex"}, {"pointer", "/name"}, {"regex", "S.*"}}}},
+  };
+
+  std::vector<grapher::json_t> const events = {
+      {{"name", "Source"}, {"dur", 1}, {"args", {{"detail", "a.hpp"}}}},
+      {{"name", "Source"}, {"dur", 5}, {"args", {{"detail", "a.cpp"}}}},
+      {{"name", "InstantiateClass"}, {"dur", 2}},
+      {{"name", 12}, {"dur", 2}},
+      {{"dur", 2}},
+  };
+
+  for (grapher::json_t constraint : constraints) {
+    grapher::predicate_t const pred = grapher::get_predicate(constraint);
+    constraint["memoize"] = true;
+    grapher::predicate_t const memoized_pred =
+        grapher::get_predicate(constraint);
+
+    // Cached results must be the same, including on repeated events
+    for (std::size_t pass = 0; pass < 2; pass++) {
+      for (grapher::json_t const &event : events) {
+        REQUIRE(memoized_pred(event) == pred(event));
+      }
+    }
+  }
+}
+
+TEST_CASE("batch evaluation", "[predicates]") {
+  // Table with names, details and args, larger than a batch
+  grapher::event_table_t table;
+  std::array<std::string, 4> const names = {"Source", "Frontend",
+                                            "InstantiateClass", "Total Source"};
+  std::size_t const row_count = grapher::predicate_t::batch_size + 77;
+  for (std::size_t row = 0; row < row_count; row++) {
+    grapher::json_t event = {{"name", names[row % names.size()]}, {"dur", row}};
+    if (row % 7 == 0) {
+      // Durations that don't fit the dur column are stored in the args table
+      event["dur"] = double(row) + 0.5;
+    }
+    if (row % 11 == 0) {
+      // So are names that are not strings
+      event["name"] = row % 22;
+    }
+    if (row % 3 != 0) {
+      event["args"]["detail"] = row % 2 == 0 ? "a.hpp" : "a.cpp";
+    }
+    if (row % 5 == 0) {
+      event["args"]["kind"] = "outlier";
+    }
+    table.push_event(event);
+  }
+
+  grapher::json_t const streq_name = {
+      {"type", "streq"}, {"pointer", "/name"}, {"string", "Source"}};
+  grapher::json_t const streq_detail = {
+      {"type", "streq"}, {"pointer", "/args/detail"}, {"string", "a.hpp"}};
+  grapher::json_t const regex_name = {
+      {"type", "regex"}, {"pointer", "/name"}, {"regex", "Inst.*"}};
+  grapher::json_t const streq_arg = {
+      {"type", "streq"}, {"pointer", "/args/kind"}, {"string", "outlier"}};
+
+  // Disjunctions of streq, rewritten into set lookups
+  auto get_streq_chain = [](std::string const &pointer,
+                            std::vector<std::string> const &strings,
+                            grapher::json_t constraint) {
+    for (std::string const &string : strings) {
+      grapher::json_t const streq = {
+          {"type", "streq"}, {"pointer", pointer}, {"string", string}};
+      constraint = {
+          {"type", "op_or"}, {"first", streq}, {"second", constraint}};
+    }
+    return constraint;
+  };
+  grapher::json_t const name_chain = get_streq_chain(
+      "/name", {"Source", "Frontend", "Total Source", "Backend"}, streq_arg);
+  grapher::json_t const detail_chain = get_streq_chain(
+      "/args/detail", {"a.hpp", "b.hpp", "c.hpp", "d.hpp"}, regex_name);
+  REQUIRE(grapher::get_predicate(name_chain).get_instructions()[1].opcode ==
+          grapher::in_set_op_v);
+  REQUIRE(grapher::get_predicate(detail_chain).get_instructions()[1].opcode ==
+          grapher::in_set_op_v);
+
+  std::vector<grapher::json_t> const constraints = {
+      streq_name,
+      {{"type", "val_false"}},
+      {{"type", "op_and"}, {"first", streq_name}, {"second", streq_detail}},
+      {{"type", "op_or"}, {"first", streq_name}, {"second", regex_name}},
+      {{"type", "op_or"},
+       {"first",
+        {{"type", "op_and"}, {"first", streq_arg}, {"second", regex_name}}},
+       {"second", streq_detail}},
+      {{"type", "in_set"},
+       {"pointer", "/name"},
+       {"values", {"Source", "Frontend"}}},
+      {{"type", "in_set"}, {"pointer", "/name"}, {"values", {"Source", 11}}},
+      name_chain,
+      detail_chain,
+      {{"type", "op_and"}, {"first", name_chain}, {"second", detail_chain}},
+      {{"type", "op_and"},
+       {"first", {{"type", "range"}, {"pointer", "/dur"}, {"max", 2000}}},
+       {"second", streq_name}},
+      {{"type", "range"}, {"pointer", "/dur"}, {"min", 100.5}, {"max", 3000}},
+      {{"type", "range"}, {"pointer", "/dur"}, {"min", 0.2}, {"max", 0.8}},
+  };
+
+  for (grapher::json_t constraint : constraints) {
+    grapher::predicate_t const pred = grapher::get_predicate(constraint);
+    constraint["memoize"] = true;
+    grapher::predicate_t const memoized_pred =
+        grapher::get_predicate(constraint);
+
+    // Batches must agree with the row by row evaluation
+    for (std::size_t begin = 0; begin < row_count;
+         begin += grapher::predicate_t::batch_size) {
+      std::size_t const count =
+          std::min(grapher::predicate_t::batch_size, row_count - begin);
+      std::array<std::uint64_t, grapher::predicate_t::batch_words> mask = {};
+      std::span<std::uint64_t> const batch_mask = std::span(mask).first(
+          grapher::simd::get_mask_word_count(count));
+
+      // Odd rows are not evaluated, and must stay cleared
+      grapher::simd::fill_mask(batch_mask, count);
+      for (std::uint64_t &word : batch_mask) {
+        word &= 0x5555555555555555;
+      }
+      std::array<std::uint64_t, grapher::predicate_t::batch_words>
+          memoized_mask = mask;
+      pred.evaluate(table, begin, count, batch_mask);
+      memoized_pred.evaluate(table, begin, count,
+                             std::span(memoized_mask).first(batch_mask.size()));
+      REQUIRE(memoized_mask == mask);
+
+      for (std::size_t row = 0; row < count; row++) {
+        bool const is_set = (batch_mask[row / 64] >> (row % 64) & 1) != 0;
+        REQUIRE(is_set == (row % 2 == 0 && pred(table, begin + row)));
+      }
+    }
+  }
+}
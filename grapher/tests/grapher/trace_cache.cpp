@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+#include <grapher/trace_cache.hpp>
+#include <grapher/utils/fingerprint.hpp>
+
+#include "fixtures.hpp"
+
+TEST_CASE("trace cache roundtrip", "[trace_cache]") {
+  std::filesystem::path const path = write_test_trace();
+  std::filesystem::path const cache_path = grapher::get_trace_cache_path(path);
+  std::filesystem::remove(cache_path);
+
+  REQUIRE(grapher::is_trace_cache_path(cache_path));
+  REQUIRE_FALSE(grapher::read_trace_cache(path).has_value());
+
+  // First read writes the cache file
+  grapher::event_table_t const events =
+      grapher::read_cached_trace_events(path, {});
+  REQUIRE(std::filesystem::exists(cache_path));
+  REQUIRE(events == grapher::read_trace_events(path));
+
+  std::optional<grapher::event_table_t> const cached_events =
+      grapher::read_trace_cache(path);
+  REQUIRE(cached_events.has_value());
+  REQUIRE(*cached_events == events);
+
+  std::filesystem::remove(cache_path);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("trace cache projection", "[trace_cache]") {
+  std::filesystem::path const path = write_test_trace();
+  std::filesystem::path const cache_path = grapher::get_trace_cache_path(path);
+
+  REQUIRE(grapher::write_trace_cache(path, grapher::read_trace_events(path)));
+
+  grapher::json_t streq_constraint;
+  streq_constraint["type"] = "streq";
+  streq_constraint["pointer"] = "/name";
+  streq_constraint["string"] = "Source";
+
+  grapher::trace_projection_t const projection{
+      .keep_all_fields = false,
+      .pointers = {grapher::json_t::json_pointer{"/name"},
+                   grapher::json_t::json_pointer{"/dur"},
+                   grapher::json_t::json_pointer{"/args/list"}},
+      .filters = {{grapher::get_predicate(streq_constraint)}}};
+
+  std::optional<grapher::event_table_t> const events =
+      grapher::read_trace_cache(path, projection);
+
+  REQUIRE(events.has_value());
+  REQUIRE(events->size() == 2);
+  REQUIRE(events->get_event(0) ==
+          grapher::json_t::parse(R"({"name": "Source", "dur": 10,
+                                     "args": {"list": [1, -2, 0.5]}})"));
+  REQUIRE(events->get_event(1) ==
+          grapher::json_t::parse(R"({"name": "Source", "dur": 30})"));
+
+  std::filesystem::remove(cache_path);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("trace cache invalidation", "[trace_cache]") {
+  std::filesystem::path const path = write_test_trace();
+  std::filesystem::path const cache_path = grapher::get_trace_cache_path(path);
+
+  REQUIRE(grapher::write_trace_cache(path, grapher::read_trace_events(path)));
+  REQUIRE(grapher::read_trace_cache(path).has_value());
+
+  // Changing the source file invalidates the cache file
+  std::ofstream(path, std::ios::app) << '\n';
+  REQUIRE_FALSE(grapher::read_trace_cache(path).has_value());
+
+  std::filesystem::remove(cache_path);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("trace cache stamp refresh", "[trace_cache]") {
+  std::filesystem::path const path = write_test_trace();
+  std::filesystem::path const cache_path = grapher::get_trace_cache_path(path);
+
+  REQUIRE(grapher::write_trace_cache(path, grapher::read_trace_events(path)));
+
+  // Touching the source file keeps the cache file valid, and its header takes
+  // the new modification time so the source is not hashed on the next read
+  std::filesystem::last_write_time(path,
+                                   std::filesystem::last_write_time(path) +
+                                       std::chrono::seconds(10));
+  REQUIRE(grapher::read_trace_cache(path).has_value());
+
+  std::int64_t cached_mtime = 0;
+  std::ifstream cache_file(cache_path, std::ios::binary);
+  cache_file.seekg(16);
+  cache_file.read(reinterpret_cast<char *>(&cached_mtime),
+                  sizeof(cached_mtime));
+  REQUIRE(cached_mtime == grapher::get_file_stamp(path)->mtime);
+
+  std::filesystem::remove(cache_path);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("trace cache corruption", "[trace_cache]") {
+  std::filesystem::path const path = write_test_trace();
+  std::filesystem::path const cache_path = grapher::get_trace_cache_path(path);
+
+  // Overwrites 8 bytes of the cache file
+  auto corrupt = [&](std::streamoff offset) {
+    REQUIRE(grapher::write_trace_cache(path, grapher::read_trace_events(path)));
+    std::fstream cache_file(cache_path,
+                            std::ios::in | std::ios::out | std::ios::binary);
+    cache_file.seekp(offset);
+    cache_file.write("\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x7F", 8);
+  };
+
+  // Event count in the header
+  corrupt(32);
+  REQUIRE_FALSE(grapher::read_trace_cache(path).has_value());
+
+  // Second offset of the string table, right after the header
+  corrupt(72);
+  REQUIRE_FALSE(grapher::read_trace_cache(path).has_value());
+
+  // Last arg, whose value is a string id
+  corrupt(static_cast<std::streamoff>(std::filesystem::file_size(cache_path)) -
+          8);
+  REQUIRE_FALSE(grapher::read_trace_cache(path).has_value());
+
+  std::filesystem::remove(cache_path);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+
+#include <grapher/trace_reader.hpp>
+
+#include "fixtures.hpp"
+
+TEST_CASE("read all trace events", "[trace_reader]") {
+  std::filesystem::path const path = write_test_trace();
+
+  grapher::event_table_t const events = grapher::read_trace_events(path);
+
+  REQUIRE(events.size() == 3);
+  REQUIRE(events.get_event(0) ==
+          grapher::json_t::parse(R"({"name": "Source", "dur": 10, "ts": 0,
+            "ph": "X", "args": {"detail": "foo.hpp", "list": [1, -2, 0.5],
+            "flag": true}})"));
+
+  // Mapped and buffered inputs must yield the same events
+  REQUIRE(grapher::read_trace_events(path, {}, grapher::buffered_input_v) ==
+          events);
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("read projected trace events", "[trace_reader]") {
+  std::filesystem::path const path = write_test_trace();
+
+  grapher::json_t streq_constraint;
+  streq_constraint["type"] = "streq";
+  streq_constraint["pointer"] = "/name";
+  streq_constraint["string"] = "Source";
+
+  grapher::trace_projection_t const projection{
+      .keep_all_fields = false,
+      .pointers = {grapher::json_t::json_pointer{"/name"},
+                   grapher::json_t::json_pointer{"/dur"},
+                   grapher::json_t::json_pointer{"/args/detail"}},
+      .filters = {{grapher::get_predicate(streq_constraint)}}};
+
+  grapher::event_table_t const events =
+      grapher::read_trace_events(path, projection);
+
+  REQUIRE(events.size() == 2);
+  REQUIRE(events.get_event(0) == grapher::json_t::parse(
+                                     R"({"name": "Source", "dur": 10,
+                                         "args": {"detail": "foo.hpp"}})"));
+  REQUIRE(events.get_event(1) ==
+          grapher::json_t::parse(R"({"name": "Source", "dur": 30})"));
+
+  std::filesystem::remove(path);
+}
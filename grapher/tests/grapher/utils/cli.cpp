@@ -1 +1,87 @@
 #include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#include <grapher/event_store.hpp>
+#include <grapher/utils/cli.hpp>
+
+#include "../fixtures.hpp"
+
+TEST_CASE("build_category", "[cli]") {
+  namespace fs = std::filesystem;
+
+  fs::path const bench_path = get_temp_path("cli") / "bench";
+  fs::remove_all(bench_path);
+
+  for (char const *repetition_path : {"1/1.json", "1/2.json", "4/1.json"}) {
+    fs::create_directories((bench_path / repetition_path).parent_path());
+    std::ofstream(bench_path / repetition_path) << R"({"traceEvents": []})";
+  }
+
+  SECTION("directory scanning") {
+    grapher::benchmark_set_t const bset =
+        grapher::build_category({bench_path});
+
+    REQUIRE(bset.size() == 1);
+    REQUIRE(bset[0].name == "bench");
+    REQUIRE(bset[0].instances.size() == 2);
+    REQUIRE(bset[0].instances[0].size == 1);
+    REQUIRE(bset[0].instances[0].repetitions.size() == 2);
+    REQUIRE(bset[0].instances[1].size == 4);
+    REQUIRE(bset[0].instances[1].repetitions ==
+            std::vector{bench_path / "4/1.json"});
+    REQUIRE(bset[0].instances[1].events->size() == 1);
+  }
+
+  SECTION("benchmark index") {
+    // The index is used instead of the directory tree
+    std::ofstream(bench_path / grapher::benchmark_index_filename) << R"({
+      "repetitions": [
+        {"size": 4, "path": "4/1.json"},
+        {"size": 1, "path": "1/2.json"}
+      ]
+    })";
+
+    grapher::benchmark_set_t const bset =
+        grapher::build_category({bench_path});
+
+    REQUIRE(bset.size() == 1);
+    REQUIRE(bset[0].instances.size() == 2);
+    REQUIRE(bset[0].instances[0].size == 1);
+    REQUIRE(bset[0].instances[0].repetitions ==
+            std::vector{bench_path / "1/2.json"});
+    REQUIRE(bset[0].instances[1].size == 4);
+  }
+
+  SECTION("invalid benchmark index") {
+    // Invalid indexes are ignored
+    std::ofstream(bench_path / grapher::benchmark_index_filename)
+        << R"({"repetitions": [{"size": "4"}]})";
+
+    grapher::benchmark_set_t const bset =
+        grapher::build_category({bench_path});
+
+    REQUIRE(bset[0].instances.size() == 2);
+    REQUIRE(bset[0].instances[0].repetitions.size() == 2);
+  }
+
+  SECTION("out of date benchmark index") {
+    // Indexes listing missing files are ignored
+    std::ofstream(bench_path / grapher::benchmark_index_filename) << R"({
+      "repetitions": [
+        {"size": 1, "path": "1/1.json"},
+        {"size": 1, "path": "1/3.json"}
+      ]
+    })";
+
+    grapher::benchmark_set_t const bset =
+        grapher::build_category({bench_path});
+
+    REQUIRE(bset[0].instances.size() == 2);
+    REQUIRE(bset[0].instances[0].repetitions.size() == 2);
+    REQUIRE(bset[0].instances[1].events->size() == 1);
+  }
+
+  fs::remove_all(bench_path.parent_path());
+}
@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <grapher/utils/columnar.hpp>
+#include <grapher/utils/intern.hpp>
+
+#include "../fixtures.hpp"
+
+TEST_CASE("columnar file roundtrip", "[columnar]") {
+  std::filesystem::path const path = get_temp_path("columnar.ctcol");
+
+  constexpr std::size_t row_count = 1000;
+  {
+    // Small blocks, so the last one is partial
+    grapher::columnar_writer_t writer(
+        path,
+        {{.name = "key", .type = grapher::string_column_v},
+         {.name = "value", .type = grapher::unsigned_column_v}},
+        64);
+    REQUIRE(writer.is_open());
+
+    for (std::size_t i = 0; i < row_count; i++) {
+      grapher::symbol_t const key =
+          i % 10 == 0 ? grapher::no_symbol_v
+                      : grapher::intern("key" + std::to_string(i % 3));
+      std::array<std::uint64_t, 2> const row = {key, i * i};
+      writer.append_row(row);
+    }
+    REQUIRE(writer.close());
+  }
+
+  grapher::columnar_reader_t const reader(path);
+  REQUIRE(reader.is_open());
+  REQUIRE(reader.get_row_count() == row_count);
+  REQUIRE(reader.get_block_count() == 16);
+  REQUIRE(reader.get_column_count() == 2);
+  REQUIRE(reader.get_column_name(0) == "key");
+  REQUIRE(reader.get_column_type(0) == grapher::string_column_v);
+  REQUIRE(reader.find_column("value") == 1);
+  REQUIRE(reader.find_column("missing") == 2);
+
+  std::size_t i = 0;
+  for (std::size_t block_id = 0; block_id < reader.get_block_count();
+       block_id++) {
+    auto const keys = reader.get_string_column(block_id, 0);
+    auto const values = reader.get_unsigned_column(block_id, 1);
+    REQUIRE(keys.size() == reader.get_block_row_count(block_id));
+    REQUIRE(values.size() == keys.size());
+
+    for (std::size_t row = 0; row < keys.size(); row++, i++) {
+      REQUIRE(values[row] == i * i);
+      if (i % 10 == 0) {
+        REQUIRE(keys[row] == grapher::no_string_id_v);
+        REQUIRE(reader.get_string(keys[row]).empty());
+      } else {
+        REQUIRE(reader.get_string(keys[row]) == "key" + std::to_string(i % 3));
+      }
+    }
+  }
+  REQUIRE(i == row_count);
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("columnar file validation", "[columnar]") {
+  std::filesystem::path const path = get_temp_path("invalid.ctcol");
+
+  {
+    grapher::columnar_writer_t writer(
+        path, {{.name = "value", .type = grapher::unsigned_column_v}});
+    std::array<std::uint64_t, 1> const row = {42};
+    writer.append_row(row);
+  }
+  REQUIRE(grapher::columnar_reader_t(path).get_row_count() == 1);
+
+  // Truncated files are rejected
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+  REQUIRE_FALSE(grapher::columnar_reader_t(path).is_open());
+
+  std::ofstream(path) << "not a columnar file";
+  REQUIRE_FALSE(grapher::columnar_reader_t(path).is_open());
+
+  REQUIRE_FALSE(grapher::columnar_reader_t(path.string() + ".missing")
+                    .is_open());
+
+  std::filesystem::remove(path);
+}
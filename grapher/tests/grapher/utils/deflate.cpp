@@ -0,0 +1,85 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <grapher/utils/deflate.hpp>
+
+#include "inflate.hpp"
+
+namespace {
+
+std::vector<std::uint8_t> to_bytes(std::string_view data) {
+  return {data.begin(), data.end()};
+}
+
+std::vector<std::uint8_t>
+inflate_bytes(std::vector<std::uint8_t> const &compressed) {
+  return inflate_fixed(
+      {reinterpret_cast<char const *>(compressed.data()), compressed.size()});
+}
+
+std::uint32_t read_u32_le(std::string_view data, std::size_t offset) {
+  return std::uint32_t(std::uint8_t(data[offset])) |
+         std::uint32_t(std::uint8_t(data[offset + 1])) << 8 |
+         std::uint32_t(std::uint8_t(data[offset + 2])) << 16 |
+         std::uint32_t(std::uint8_t(data[offset + 3])) << 24;
+}
+
+} // namespace
+
+TEST_CASE("Deflate", "[deflate]") {
+  REQUIRE(grapher::get_crc32("123456789") == 0xCBF43926U);
+  REQUIRE(grapher::get_adler32(to_bytes("Wikipedia")) == 0x11E60398U);
+
+  SECTION("Empty data") {
+    REQUIRE(inflate_bytes(grapher::deflate({})).empty());
+  }
+
+  SECTION("Repetitive text") {
+    // JSON-like text with repeated keys and distant repetitions
+    std::string text;
+    for (std::size_t i = 0; i < 5000; i++) {
+      text += "{\"name\":\"benchmark_" + std::to_string(i % 37) +
+              "\",\"x\":[" + std::to_string(i) + "," +
+              std::to_string(i * 7) + "]},";
+    }
+
+    std::vector<std::uint8_t> const compressed =
+        grapher::deflate(to_bytes(text));
+    REQUIRE(inflate_bytes(compressed) == to_bytes(text));
+    REQUIRE(compressed.size() < text.size() / 3);
+  }
+
+  SECTION("Image rows") {
+    // Long background runs with a few marks, like PNG rows, so most matches
+    // are longer than the ones whose positions are all inserted
+    std::size_t const row_size = 1501;
+    std::vector<std::uint8_t> data(row_size * 200, 0);
+    for (std::size_t row = 0; row < 200; row++) {
+      data[row * row_size + 1 + (row * 7) % 1500] = 3;
+      data[row * row_size + 1 + (row * row) % 1500] = std::uint8_t(row % 5);
+      if (row % 20 == 0) {
+        std::fill_n(data.begin() + std::ptrdiff_t(row * row_size + 1), 1500,
+                    std::uint8_t(1));
+      }
+    }
+
+    std::vector<std::uint8_t> const compressed = grapher::deflate(data);
+    REQUIRE(inflate_bytes(compressed) == data);
+    REQUIRE(compressed.size() < data.size() / 20);
+  }
+
+  SECTION("gzip") {
+    std::string const text = "ctbench ctbench ctbench, gzip";
+    std::string const file = grapher::gzip(text);
+    REQUIRE(file.substr(0, 4) == std::string("\x1F\x8B\x08\0", 4));
+    REQUIRE(inflate_fixed(file.substr(10)) == to_bytes(text));
+    REQUIRE(read_u32_le(file, file.size() - 8) == grapher::get_crc32(text));
+    REQUIRE(read_u32_le(file, file.size() - 4) == text.size());
+  }
+}
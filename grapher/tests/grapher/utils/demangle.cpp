@@ -0,0 +1,30 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include <grapher/utils/demangle.hpp>
+#include <grapher/utils/intern.hpp>
+
+TEST_CASE("demangling", "[demangle]") {
+  REQUIRE(grapher::demangle("_Z3foov") == "foo()");
+
+  // Strings that aren't mangled names are kept as is
+  REQUIRE(grapher::demangle("Source") == "Source");
+  REQUIRE(grapher::demangle("") == "");
+}
+
+TEST_CASE("demangle cache", "[demangle]") {
+  grapher::symbol_t const mangled = grapher::intern("_Z3barv");
+  grapher::symbol_t const plain = grapher::intern("InstantiateFunction");
+
+  grapher::demangle_cache_t cache;
+  cache.insert(std::vector{mangled, plain, mangled});
+  REQUIRE(cache.size() == 2);
+
+  REQUIRE(cache.get(mangled) == "bar()");
+  REQUIRE(cache.get(plain) == "InstantiateFunction");
+
+  // Symbols already in the cache aren't demangled again
+  cache.insert(std::vector{plain});
+  REQUIRE(cache.size() == 2);
+}
@@ -0,0 +1,68 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <grapher/utils/gnuplot.hpp>
+#include <grapher/utils/render.hpp>
+
+#include "../fixtures.hpp"
+
+TEST_CASE("gnuplot commands", "[gnuplot]") {
+  REQUIRE(grapher::quote_gnuplot_string("plots/a.svg") == "'plots/a.svg'");
+  REQUIRE(grapher::quote_gnuplot_string("it's") == "'it''s'");
+
+  REQUIRE(grapher::get_gnuplot_terminal(".svg", 1500, 500) ==
+          "svg enhanced size 1500,500");
+  REQUIRE(grapher::get_gnuplot_terminal(".png", 1500, 500) ==
+          "pngcairo enhanced size 1500,500");
+  REQUIRE(grapher::get_gnuplot_terminal(".pdf", 720, 360) ==
+          "pdfcairo enhanced size 10in,5in");
+}
+
+TEST_CASE("gnuplot session", "[gnuplot]") {
+  namespace fs = std::filesystem;
+
+  SECTION("commands are streamed to a single process") {
+    fs::path const output_path = get_temp_path("gnuplot-session.txt");
+    {
+      grapher::gnuplot_session_t session("cat > " + output_path.string());
+      REQUIRE(session.is_open());
+      REQUIRE(session.send("set output 'a.svg'\n"));
+      REQUIRE(session.send("replot\n"));
+      REQUIRE(session.close());
+      REQUIRE(!session.is_open());
+    }
+
+    std::ifstream output_file(output_path);
+    std::string const output{std::istreambuf_iterator<char>(output_file), {}};
+    REQUIRE(output == "set output 'a.svg'\nreplot\n");
+    fs::remove(output_path);
+  }
+
+  SECTION("errors") {
+    grapher::gnuplot_session_t session("exit 3");
+    REQUIRE(session.close() == false);
+    REQUIRE(session.send("plot x\n") == false);
+  }
+
+  SECTION("writing to an exited process") {
+    // The pipe fills up past the process' lifetime, so writing raises
+    // SIGPIPE, which must not end the test process
+    grapher::gnuplot_session_t session("exit 0");
+    std::string const commands(1 << 20, '#');
+    bool is_sent = true;
+    for (int i = 0; i < 16 && is_sent; i++) {
+      is_sent = session.send(commands, "a.svg");
+    }
+    REQUIRE(is_sent == false);
+    REQUIRE(session.get_last_destination() == "a.svg");
+    REQUIRE(session.close() == false);
+  }
+
+  SECTION("render sessions") {
+    REQUIRE(grapher::get_render_session() == nullptr);
+  }
+}
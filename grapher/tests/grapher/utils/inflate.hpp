@@ -0,0 +1,83 @@
+#pragma once
+
+/// \file
+/// Test decompressor for the output of grapher::deflate.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/// Decompresses a raw deflate stream made of fixed Huffman blocks.
+inline std::vector<std::uint8_t> inflate_fixed(std::string_view stream) {
+  std::size_t bit = 0;
+  auto read_bits = [&](unsigned count) {
+    std::uint32_t res = 0;
+    for (unsigned i = 0; i < count; i++, bit++) {
+      res |= std::uint32_t((std::uint8_t(stream[bit / 8]) >> (bit % 8)) & 1)
+             << i;
+    }
+    return res;
+  };
+  auto read_code = [&](unsigned count, std::uint32_t code) {
+    for (unsigned i = 0; i < count; i++) {
+      code = (code << 1) | read_bits(1);
+    }
+    return code;
+  };
+
+  constexpr std::array<unsigned, 29> length_bases = {
+      3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+  constexpr std::array<unsigned, 30> distance_bases = {
+      1,    2,    3,    4,    5,    7,    9,    13,    17,    25,
+      33,   49,   65,   97,   129,  193,  257,  385,   513,   769,
+      1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+  std::vector<std::uint8_t> res;
+  bool is_final = false;
+  while (!is_final) {
+    is_final = read_bits(1) == 1;
+    REQUIRE(read_bits(2) == 1);
+    for (;;) {
+      std::uint32_t symbol = read_code(7, 0);
+      if (symbol <= 0x17) {
+        symbol += 256;
+      } else if (symbol = read_code(1, symbol); symbol <= 0xBF) {
+        symbol -= 0x30;
+      } else if (symbol <= 0xC7) {
+        symbol += 280 - 0xC0;
+      } else {
+        symbol = read_code(1, symbol) - 0x190 + 144;
+      }
+
+      if (symbol < 256) {
+        res.push_back(std::uint8_t(symbol));
+        continue;
+      }
+      if (symbol == 256) {
+        break;
+      }
+
+      unsigned const length_code = symbol - 257;
+      unsigned const length_extra =
+          length_code < 8 || length_code == 28 ? 0 : (length_code - 4) / 4;
+      std::size_t const length =
+          length_bases[length_code] + read_bits(length_extra);
+      unsigned const distance_code = read_code(5, 0);
+      unsigned const distance_extra =
+          distance_code < 4 ? 0 : (distance_code - 2) / 2;
+      std::size_t const distance =
+          distance_bases[distance_code] + read_bits(distance_extra);
+
+      REQUIRE(distance <= res.size());
+      for (std::size_t i = 0; i < length; i++) {
+        res.push_back(res[res.size() - distance]);
+      }
+    }
+  }
+  return res;
+}
@@ -0,0 +1,43 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include <grapher/utils/intern.hpp>
+#include <grapher/utils/parallel.hpp>
+
+TEST_CASE("interning", "[intern]") {
+  grapher::symbol_t const foo = grapher::intern("intern-test-foo");
+  grapher::symbol_t const bar = grapher::intern("intern-test-bar");
+
+  REQUIRE(foo != grapher::no_symbol_v);
+  REQUIRE(bar != grapher::no_symbol_v);
+  REQUIRE(foo != bar);
+  REQUIRE(grapher::intern(std::string("intern-test-foo")) == foo);
+
+  REQUIRE(grapher::get_symbol_string(foo) == "intern-test-foo");
+  REQUIRE(grapher::find_symbol("intern-test-bar") == bar);
+  REQUIRE(grapher::find_symbol("intern-test-baz") == grapher::no_symbol_v);
+
+  REQUIRE(grapher::symbol_string_less_t{}(bar, foo));
+  REQUIRE_FALSE(grapher::symbol_string_less_t{}(foo, bar));
+}
+
+TEST_CASE("concurrent interning", "[intern]") {
+  constexpr std::size_t string_count = 1000;
+
+  std::vector<grapher::symbol_t> first_symbols(string_count);
+  std::vector<grapher::symbol_t> second_symbols(string_count);
+
+  grapher::parallel_for(2 * string_count, [&](std::size_t i) {
+    std::string const str = "intern-test-" + std::to_string(i % string_count);
+    (i < string_count ? first_symbols : second_symbols)[i % string_count] =
+        grapher::intern(str);
+  });
+
+  REQUIRE(first_symbols == second_symbols);
+  for (std::size_t i = 0; i < string_count; i++) {
+    REQUIRE(grapher::get_symbol_string(first_symbols[i]) ==
+            "intern-test-" + std::to_string(i));
+  }
+}
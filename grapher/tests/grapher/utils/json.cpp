@@ -1 +1,83 @@
 #include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include <grapher/event_store.hpp>
+#include <grapher/utils/json.hpp>
+
+#include "../fixtures.hpp"
+
+TEST_CASE("descriptor dispatcher", "[json]") {
+  namespace fs = std::filesystem;
+
+  std::vector<grapher::group_descriptor_t> const descriptors = {
+      {.name = "Source",
+       .predicates = {{{"type", "streq"},
+                       {"pointer", "/name"},
+                       {"string", "Source"}}}},
+      {.name = "Instantiations",
+       .predicates = {{{"type", "op_or"},
+                       {"first",
+                        {{"type", "streq"},
+                         {"pointer", "/name"},
+                         {"string", "InstantiateClass"}}},
+                       {"second",
+                        {{"type", "regex"},
+                         {"pointer", "/name"},
+                         {"regex", "InstantiateFunction"}}}}}},
+      {.name = "Headers",
+       .predicates = {{{"type", "regex"},
+                       {"pointer", "/args/detail"},
+                       {"regex", ".*\\.hpp"}}}},
+      {.name = "Header sources",
+       .predicates = {{{"type", "match"},
+                       {"regex", true},
+                       {"matcher",
+                        {{"name", "Source"},
+                         {"args", {{"detail", ".*\\.hpp"}}}}}}}},
+      {.name = "Short events",
+       .predicates = {{{"type", "in_set"},
+                       {"pointer", "/name"},
+                       {"values", {"Source", "Frontend"}}},
+                      {{"type", "range"}, {"pointer", "/dur"}, {"max", 2}}}},
+  };
+
+  grapher::descriptor_dispatcher_t const dispatcher(descriptors);
+  REQUIRE(dispatcher.size() == 5);
+  REQUIRE(dispatcher.unindexed_size() == 1);
+
+  fs::path const repetition_path = get_temp_path("dispatcher.json");
+  std::ofstream(repetition_path) << R"({"traceEvents": [
+    {"name": "Source", "dur": 1, "args": {"detail": "a.hpp"}},
+    {"name": "Source", "dur": 2, "args": {"detail": "a.cpp"}},
+    {"name": "InstantiateClass", "dur": 4, "args": {"detail": "b.hpp"}},
+    {"name": "InstantiateFunction", "dur": 8},
+    {"name": "Frontend", "dur": 16}
+  ]})";
+
+  grapher::benchmark_instance_t const instance{
+      .size = 1,
+      .repetitions = {repetition_path},
+      .events = std::make_shared<grapher::event_store_t const>(
+          std::vector<fs::path>{repetition_path})};
+
+  auto const sums = grapher::filtered_values_sums(
+      instance, dispatcher, grapher::json_t::json_pointer{"/dur"});
+
+  // Sums must be the same as with separate scans
+  REQUIRE(sums.size() == descriptors.size());
+  for (std::size_t i = 0; i < descriptors.size(); i++) {
+    REQUIRE(sums[i] == grapher::filtered_values_sums(
+                           instance, grapher::get_predicates(descriptors[i]),
+                           grapher::json_t::json_pointer{"/dur"}));
+  }
+  REQUIRE(sums[0] == std::vector<grapher::value_t>{3});
+  REQUIRE(sums[1] == std::vector<grapher::value_t>{12});
+  REQUIRE(sums[2] == std::vector<grapher::value_t>{5});
+  REQUIRE(sums[3] == std::vector<grapher::value_t>{1});
+  REQUIRE(sums[4] == std::vector<grapher::value_t>{3});
+
+  fs::remove(repetition_path);
+}
@@ -1,5 +1,10 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <string>
 #include <vector>
 
 #include <grapher/core.hpp>
@@ -29,3 +34,101 @@ TEST_CASE("median on unsorted vectors", "[math]") {
   REQUIRE(grapher::math::median({10, 0, 40, 20, 30, 20}) == 20);
   REQUIRE(grapher::math::median({40, 30, 10, 30, 20, 0}) == 25);
 }
+
+TEST_CASE("accumulator", "[math]") {
+  std::vector<grapher::value_t> const values = {40, 30, 10, 30, 20, 0};
+
+  grapher::math::accumulator_t accumulator;
+  grapher::math::accumulator_t exact_accumulator(true);
+  for (grapher::value_t const value : values) {
+    accumulator.push(value);
+    exact_accumulator.push(value);
+  }
+
+  REQUIRE(accumulator.count() == values.size());
+  REQUIRE(accumulator.sum() ==
+          double(std::reduce(values.begin(), values.end())));
+  REQUIRE(accumulator.average() == grapher::math::average(values));
+  REQUIRE(std::abs(accumulator.stddev() - grapher::math::stddev(values)) <
+          1e-9);
+  REQUIRE(accumulator.samples().empty());
+
+  REQUIRE(exact_accumulator.median() == grapher::math::median(values));
+  REQUIRE(std::ranges::equal(exact_accumulator.samples(), values));
+}
+
+TEST_CASE("streaming median", "[math]") {
+  // Exact for small series
+  grapher::math::p2_quantile_t small_median;
+  for (double const value : {40, 10, 20, 30}) {
+    small_median.push(value);
+  }
+  REQUIRE(small_median.get() == 25);
+
+  // Estimated median of a shuffled uniform series
+  grapher::math::p2_quantile_t median;
+  for (unsigned i = 0; i < 10001; i++) {
+    median.push(double(i * 7919 % 10001));
+  }
+  REQUIRE(median.count() == 10001);
+  REQUIRE(std::abs(median.get() - 5000) < 100);
+}
+
+TEST_CASE("heavy hitters", "[math]") {
+  grapher::math::heavy_hitters_t<std::string> sketch(3);
+
+  // Two heavy keys among many light ones
+  for (unsigned i = 0; i < 100; i++) {
+    sketch.push("heavy", 10);
+    sketch.push("light" + std::to_string(i), 1);
+    if (i % 2 == 0) {
+      sketch.push("medium", 10);
+    }
+  }
+
+  REQUIRE(sketch.size() == 3);
+  REQUIRE(sketch.total_weight() == 1600);
+
+  auto const heavy_hitters = sketch.get_heavy_hitters();
+  REQUIRE(heavy_hitters[0].first == "heavy");
+  REQUIRE(heavy_hitters[1].first == "medium");
+
+  // Estimates are upper bounds within the error bound
+  for (auto const &[key, counter] : heavy_hitters) {
+    REQUIRE(counter.error <= sketch.total_weight() / 3);
+  }
+  REQUIRE(heavy_hitters[0].second.weight >= 1000);
+  REQUIRE(heavy_hitters[0].second.weight - heavy_hitters[0].second.error <=
+          1000);
+  REQUIRE(heavy_hitters[1].second.weight >= 500);
+}
+
+TEST_CASE("heavy hitters ties", "[math]") {
+  // Returns the keys that are still monitored after pushing keys of equal
+  // weight into a full sketch
+  auto get_kept_keys = [](auto sketch) {
+    for (char const *key : {"b", "a", "c"}) {
+      sketch.push(key, 1);
+    }
+    std::vector<std::string> res;
+    for (auto const &[key, counter] : sketch.get_heavy_hitters()) {
+      res.push_back(key);
+    }
+    std::ranges::sort(res);
+    return res;
+  };
+
+  // The smallest of the lightest keys is evicted
+  REQUIRE(get_kept_keys(grapher::math::heavy_hitters_t<std::string>(2)) ==
+          std::vector<std::string>{"b", "c"});
+  REQUIRE(get_kept_keys(
+              grapher::math::heavy_hitters_t<std::string,
+                                             std::greater<std::string>>(2)) ==
+          std::vector<std::string>{"a", "c"});
+
+  // Keys replaced in a full sketch are returned
+  grapher::math::heavy_hitters_t<std::string> sketch(1);
+  REQUIRE_FALSE(sketch.push("a", 1).has_value());
+  REQUIRE_FALSE(sketch.push("a", 1).has_value());
+  REQUIRE(sketch.push("b", 1) == "a");
+}
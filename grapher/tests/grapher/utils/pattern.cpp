@@ -0,0 +1,47 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <regex>
+#include <string>
+
+#include <grapher/utils/pattern.hpp>
+
+TEST_CASE("pattern shapes", "[pattern]") {
+  REQUIRE(grapher::pattern_matcher_t("Total Source").get_shape() ==
+          grapher::literal_shape_v);
+  REQUIRE(grapher::pattern_matcher_t("/usr/include/boost/.*").get_shape() ==
+          grapher::prefix_shape_v);
+  REQUIRE(grapher::pattern_matcher_t(".*\\.hpp").get_shape() ==
+          grapher::suffix_shape_v);
+  REQUIRE(grapher::pattern_matcher_t("Total*").get_shape() ==
+          grapher::repeat_shape_v);
+  REQUIRE(grapher::pattern_matcher_t(".*boost.*\\.hpp").get_shape() ==
+          grapher::glob_shape_v);
+  REQUIRE(grapher::pattern_matcher_t("a.c").get_shape() ==
+          grapher::regex_shape_v);
+  REQUIRE(grapher::pattern_matcher_t("\\d+").get_shape() ==
+          grapher::regex_shape_v);
+  REQUIRE(grapher::pattern_matcher_t("a.*+").get_shape() ==
+          grapher::regex_shape_v);
+}
+
+TEST_CASE("pattern matching", "[pattern]") {
+  // Fast paths must behave like std::regex_match
+  for (std::string const pattern :
+       {"Total Source", "Total*", "Total.*", ".*Source", ".*a.*b.*",
+        "/usr/include/boost/.*", "/usr/include/boost/*", ".*\\.hpp",
+        "a\\.b.*\\*", "", ".*", "ab.*ab", "(Total|Source).*"}) {
+    grapher::pattern_matcher_t const matcher(pattern);
+    std::regex const regex(pattern);
+
+    for (std::string const value :
+         {"", "Total", "Tota", "Totalll", "Total Source", "Total Frontend",
+          "Source", "ab", "aab", "abab", "aXbYab", "ba",
+          "/usr/include/boost/", "/usr/include/boost",
+          "/usr/include/boost/bool.hpp", "/usr/include/boost//",
+          "/usr/include/boost/\nx.hpp", "a.b*", "a.bc*", "axb*", "x.hpp",
+          "Total\n"}) {
+      INFO("pattern: " << pattern << ", value: " << value);
+      REQUIRE(matcher(value) == std::regex_match(value, regex));
+    }
+  }
+}
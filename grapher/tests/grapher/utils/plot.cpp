@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <grapher/utils/plot.hpp>
+#include <grapher/utils/png.hpp>
+
+#include "inflate.hpp"
+
+namespace {
+
+std::uint32_t read_u32(std::string_view data, std::size_t offset) {
+  return std::uint32_t(std::uint8_t(data[offset])) << 24 |
+         std::uint32_t(std::uint8_t(data[offset + 1])) << 16 |
+         std::uint32_t(std::uint8_t(data[offset + 2])) << 8 |
+         std::uint32_t(std::uint8_t(data[offset + 3]));
+}
+
+std::uint32_t get_crc(std::string_view data) {
+  std::uint32_t c = 0xFFFFFFFFU;
+  for (char byte : data) {
+    c ^= std::uint8_t(byte);
+    for (int k = 0; k < 8; k++) {
+      c = (c & 1) != 0 ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+    }
+  }
+  return c ^ 0xFFFFFFFFU;
+}
+
+/// Chunks of a PNG file, with their CRC checked.
+struct png_chunk_t {
+  std::string type;
+  std::string data;
+};
+
+std::vector<png_chunk_t> read_chunks(std::string_view png) {
+  std::vector<png_chunk_t> res;
+  std::size_t offset = 8;
+  while (offset + 12 <= png.size()) {
+    std::uint32_t const size = read_u32(png, offset);
+    std::string_view const typed_data = png.substr(offset + 4, size + 4);
+    REQUIRE(read_u32(png, offset + 8 + size) == get_crc(typed_data));
+    res.push_back({std::string(typed_data.substr(0, 4)),
+                   std::string(typed_data.substr(4))});
+    offset += 12 + size;
+  }
+  REQUIRE(offset == png.size());
+  return res;
+}
+
+/// Decompresses a zlib stream made of fixed Huffman deflate blocks.
+std::vector<std::uint8_t> inflate_zlib(std::string_view stream) {
+  REQUIRE(stream.substr(0, 2) == "\x78\x01");
+  return inflate_fixed(stream.substr(2));
+}
+
+} // namespace
+
+TEST_CASE("PNG encoding", "[plot]") {
+  constexpr std::size_t width = 300;
+  constexpr std::size_t height = 7;
+  std::array<grapher::rgb_t, 3> const palette = {
+      {{255, 255, 255}, {0, 0, 0}, {27, 158, 119}}};
+
+  // Runs, repeated rows, and noise
+  std::vector<std::uint8_t> pixels(width * height, 0);
+  for (std::size_t i = 0; i < pixels.size(); i++) {
+    std::size_t const x = i % width;
+    std::size_t const y = i / width;
+    if (y == 3) {
+      pixels[i] = std::uint8_t((x * 7 + x / 3) % 3);
+    } else if (x > 100 && x < 200) {
+      pixels[i] = 2;
+    }
+  }
+
+  std::string const png =
+      grapher::encode_png(width, height, palette, pixels);
+  REQUIRE(png.substr(0, 8) == "\x89PNG\r\n\x1A\n");
+
+  std::vector<png_chunk_t> const chunks = read_chunks(png);
+  REQUIRE(chunks.size() == 4);
+  REQUIRE(chunks[0].type == "IHDR");
+  REQUIRE(read_u32(chunks[0].data, 0) == width);
+  REQUIRE(read_u32(chunks[0].data, 4) == height);
+  REQUIRE(chunks[0].data.substr(8) == std::string("\x08\x03\0\0\0", 5));
+  REQUIRE(chunks[1].type == "PLTE");
+  REQUIRE(chunks[1].data == std::string("\xFF\xFF\xFF\0\0\0\x1B\x9E\x77", 9));
+  REQUIRE(chunks[2].type == "IDAT");
+  REQUIRE(chunks[3].type == "IEND");
+
+  // Rows are prefixed by their filter type
+  std::vector<std::uint8_t> const image_data = inflate_zlib(chunks[2].data);
+  REQUIRE(image_data.size() == (width + 1) * height);
+  for (std::size_t y = 0; y < height; y++) {
+    REQUIRE(image_data[y * (width + 1)] == 0);
+    for (std::size_t x = 0; x < width; x++) {
+      REQUIRE(image_data[y * (width + 1) + 1 + x] == pixels[y * width + x]);
+    }
+  }
+
+  // Compressed, even with the fixed codes
+  REQUIRE(chunks[2].data.size() < image_data.size() / 2);
+}
+
+TEST_CASE("Native plot rendering", "[plot]") {
+  grapher::plot_t plot;
+  plot.x_label = "Benchmark size factor";
+  plot.y_label = "Time (µs)";
+  plot.legend_title = "Timings";
+  plot.draw_curve({1., 2., 3.}, {10., 20., 15.}, "a <average>");
+  plot.draw_points({1., 1., 2.}, {8., 12., 25.}, "a points");
+  plot.draw_curve_with_error_bars_y({1., 2., 3.}, {5., 6., 7.}, {1., 2., 1.},
+                                    "b avg + stddev");
+  plot.draw_curves_filled({1., 2., 3.}, {0., 0., 0.}, {3., 4., 5.}, "c");
+
+  SECTION("Layout") {
+    grapher::plot_scene_t const scene = grapher::layout_plot(plot, 640, 480);
+    REQUIRE(scene.width == 640);
+    REQUIRE(scene.height == 480);
+
+    // Background first, then labels and series in the same scene
+    REQUIRE(scene.shapes.front().kind == grapher::rectangle_shape_v);
+    REQUIRE(std::ranges::any_of(scene.shapes, [](auto const &shape) {
+      return shape.kind == grapher::text_shape_v && shape.is_vertical &&
+             shape.text == "Time (µs)";
+    }));
+    REQUIRE(std::ranges::count(scene.shapes, grapher::marker_shape_v,
+                               &grapher::scene_shape_t::kind) == 4);
+    REQUIRE(std::ranges::count(scene.shapes, grapher::polygon_shape_v,
+                               &grapher::scene_shape_t::kind) == 1);
+  }
+
+  SECTION("SVG") {
+    std::string const svg =
+        grapher::to_svg(grapher::layout_plot(plot, 640, 480));
+    REQUIRE(svg.starts_with("<svg xmlns=\"http://www.w3.org/2000/svg\" "
+                            "width=\"640\" height=\"480\""));
+    REQUIRE(svg.ends_with("</svg>\n"));
+    REQUIRE(svg.find(">Time (µs)</text>") != std::string::npos);
+    REQUIRE(svg.find(">a &lt;average&gt;</text>") != std::string::npos);
+    REQUIRE(svg.find(">Timings</text>") != std::string::npos);
+    REQUIRE(svg.find("<polygon") != std::string::npos);
+    REQUIRE(svg.find("stroke=\"#1B9E77\"") != std::string::npos);
+
+    // Ticks are round values covering the data
+    REQUIRE(svg.find(">0</text>") != std::string::npos);
+    REQUIRE(svg.find(">25</text>") != std::string::npos);
+  }
+
+  SECTION("PNG") {
+    std::string const png =
+        grapher::to_png(grapher::layout_plot(plot, 320, 200));
+    std::vector<png_chunk_t> const chunks = read_chunks(png);
+    REQUIRE(chunks[0].type == "IHDR");
+    REQUIRE(read_u32(chunks[0].data, 0) == 320);
+    REQUIRE(read_u32(chunks[0].data, 4) == 200);
+
+    std::vector<std::uint8_t> const image_data = inflate_zlib(chunks[2].data);
+    REQUIRE(image_data.size() == 321 * 200);
+
+    // Background first, then series colors are used
+    REQUIRE(image_data[1] == 0);
+    std::array<bool, 11> used_colors = {};
+    for (std::uint8_t color : image_data) {
+      used_colors[color] = true;
+    }
+    REQUIRE(used_colors[3]);
+    REQUIRE(used_colors[6]);
+  }
+
+  SECTION("Empty plots") {
+    grapher::plot_t const empty_plot;
+    REQUIRE(grapher::to_svg(grapher::layout_plot(empty_plot, 100, 100))
+                .ends_with("</svg>\n"));
+    REQUIRE(read_chunks(grapher::to_png(grapher::layout_plot(empty_plot, 1, 1)))
+                .size() == 4);
+  }
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grapher/utils/render.hpp>
+
+TEST_CASE("render_parallel", "[render]") {
+  grapher::set_render_job_count(3);
+  REQUIRE(grapher::get_render_job_count() == 3);
+
+  SECTION("bounded concurrency") {
+    std::atomic<unsigned> running = 0;
+    std::atomic<unsigned> max_running = 0;
+    std::vector<std::size_t> rendered(64, 0);
+
+    grapher::render_parallel(rendered.size(), [&](std::size_t i) {
+      unsigned const now_running = ++running;
+      for (unsigned max = max_running; now_running > max &&
+                                       !max_running.compare_exchange_weak(
+                                           max, now_running);) {
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      rendered[i]++;
+      running--;
+    });
+
+    REQUIRE(max_running <= 3);
+    REQUIRE(rendered == std::vector<std::size_t>(64, 1));
+  }
+
+  SECTION("deterministic errors") {
+    std::atomic<std::size_t> rendered = 0;
+
+    // The error of the lowest failing index is reported, after every plot
+    for (std::size_t attempt = 0; attempt < 8; attempt++) {
+      rendered = 0;
+      std::string message;
+      try {
+        grapher::render_parallel(32, [&](std::size_t i) {
+          rendered++;
+          if (i % 10 == 7) {
+            throw std::runtime_error(std::to_string(i));
+          }
+        });
+      } catch (std::runtime_error const &error) {
+        message = error.what();
+      }
+      REQUIRE(message == "7");
+      REQUIRE(rendered == 32);
+    }
+  }
+
+  grapher::set_render_job_count(0);
+}
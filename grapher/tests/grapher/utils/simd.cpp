@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <grapher/utils/simd.hpp>
+
+TEST_CASE("mask helpers", "[simd]") {
+  std::vector<std::uint64_t> mask(3, 0xdead);
+  grapher::simd::fill_mask(mask, 130);
+  REQUIRE(mask[0] == ~std::uint64_t{0});
+  REQUIRE(mask[1] == ~std::uint64_t{0});
+  REQUIRE(mask[2] == 0b11);
+  REQUIRE(!grapher::simd::is_empty(mask));
+
+  std::vector<std::size_t> bits;
+  mask = {0b1001, 0, std::uint64_t{1} << 63};
+  grapher::simd::for_each_set_bit(
+      mask, [&](std::size_t bit) { bits.push_back(bit); });
+  REQUIRE(bits == std::vector<std::size_t>{0, 3, 191});
+
+  grapher::simd::fill_mask(mask, 0);
+  REQUIRE(grapher::simd::is_empty(mask));
+}
+
+TEST_CASE("mask_equal", "[simd]") {
+  std::string_view const instruction_set = grapher::simd::get_instruction_set();
+  REQUIRE((instruction_set == "avx2" || instruction_set == "sse2" ||
+           instruction_set == "scalar"));
+
+  // Sizes around vector and mask word boundaries
+  for (std::size_t const size :
+       {0ul, 1ul, 3ul, 4ul, 7ul, 8ul, 63ul, 64ul, 65ul, 200ul, 4096ul}) {
+    std::vector<std::uint32_t> values(size);
+    for (std::size_t i = 0; i < size; i++) {
+      values[i] = std::uint32_t(i * 7 % 5);
+    }
+
+    std::size_t const word_count = grapher::simd::get_mask_word_count(size);
+    std::vector<std::uint64_t> mask(word_count, 0xdead);
+    std::vector<std::uint64_t> expected(word_count, 0xbeef);
+    grapher::simd::mask_equal(values, 3, mask);
+    grapher::simd::mask_equal_scalar(values, 3, expected);
+    REQUIRE(mask == expected);
+
+    for (std::size_t i = 0; i < size; i++) {
+      REQUIRE(((mask[i / 64] >> (i % 64) & 1) != 0) == (values[i] == 3));
+    }
+  }
+}
+
+TEST_CASE("mask kernels", "[simd]") {
+  // Sizes around vector and mask word boundaries
+  for (std::size_t const size :
+       {0ul, 1ul, 3ul, 4ul, 7ul, 8ul, 31ul, 33ul, 63ul, 64ul, 65ul, 200ul,
+        4096ul}) {
+    std::size_t const word_count = grapher::simd::get_mask_word_count(size);
+    std::vector<std::uint64_t> mask(word_count, 0xdead);
+    std::vector<std::uint64_t> expected(word_count, 0xbeef);
+
+    auto is_set = [&](std::size_t i) { return (mask[i / 64] >> (i % 64) & 1); };
+
+    // Bitmap holding 3, 40 and 70, probed with values past its end
+    std::vector<std::uint32_t> symbols(size);
+    for (std::size_t i = 0; i < size; i++) {
+      symbols[i] = std::uint32_t(i * 37 % 101);
+    }
+    std::vector<std::uint32_t> const bitmap = {1u << 3, 1u << 8, 1u << 6};
+    grapher::simd::mask_in_bitmap(symbols, bitmap, mask);
+    grapher::simd::mask_in_bitmap_scalar(symbols, bitmap, expected);
+    REQUIRE(mask == expected);
+    for (std::size_t i = 0; i < size; i++) {
+      REQUIRE((is_set(i) != 0) ==
+              (symbols[i] == 3 || symbols[i] == 40 || symbols[i] == 70));
+    }
+
+    grapher::simd::mask_in_bitmap(symbols, {}, mask);
+    REQUIRE(grapher::simd::is_empty(mask));
+
+    // Values on both sides of the sign bit
+    std::vector<std::uint64_t> values(size);
+    for (std::size_t i = 0; i < size; i++) {
+      values[i] = i % 3 == 0 ? ~std::uint64_t{0} - i : i * 5;
+    }
+    grapher::simd::mask_in_range(values, 10, 500, mask);
+    grapher::simd::mask_in_range_scalar(values, 10, 500, expected);
+    REQUIRE(mask == expected);
+    for (std::size_t i = 0; i < size; i++) {
+      REQUIRE((is_set(i) != 0) == (values[i] >= 10 && values[i] <= 500));
+    }
+
+    std::vector<std::uint8_t> flags(size);
+    for (std::size_t i = 0; i < size; i++) {
+      flags[i] = std::uint8_t(i * 11 % 256);
+    }
+    grapher::simd::mask_any_bits(flags, 0b1010, mask);
+    grapher::simd::mask_any_bits_scalar(flags, 0b1010, expected);
+    REQUIRE(mask == expected);
+    for (std::size_t i = 0; i < size; i++) {
+      REQUIRE((is_set(i) != 0) == ((flags[i] & 0b1010) != 0));
+    }
+  }
+}